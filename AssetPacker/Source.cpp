@@ -0,0 +1,301 @@
+//////////////////////////////////////////////////////////////
+// Project: Asset Packer
+// Author: Ben Odom
+// Usage: AssetPacker.exe <output.pack> <folder or image>...
+//		  Decodes every image in the given folders and writes
+//		  them to one asset pack for 'OpenAssetPack'. Run it
+//		  from the folder the game runs in, so the paths
+//		  stored match the ones passed to 'LoadSurface'
+//////////////////////////////////////////////////////////////
+
+#define _CRT_SECURE_NO_WARNINGS // Allows 'fopen' with Visual Studio's SDL checks turned on
+#define SDL_MAIN_HANDLED		// The packer needs 'argc' and 'argv' rather than 'wmain'
+
+#include "AssetPack.h"
+#include "PixelConvert.h"
+
+#include <SDL_image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+	// One image on its way into the pack
+	struct Image
+	{
+		std::string sPath;
+		std::string sKey;
+
+		std::vector<Uint8> vPixels; // Tightly packed RGBA, empty if the image couldn't be decoded
+		Uint32 uiWidth;
+		Uint32 uiHeight;
+
+		Uint64 ullOffset;
+		Uint32 uiNameOffset;
+	};
+
+	bool IsImage(const std::string& ac_sPath)
+	{
+		const char* aszExtensions[] = { ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".tif", ".tiff", ".webp" };
+
+		const std::string sKey = Graphics::AssetPack::PackName(Graphics::TextureCache::NormalizePath(ac_sPath.c_str()));
+		for (unsigned int i = 0; i < sizeof(aszExtensions) / sizeof(aszExtensions[0]); ++i)
+		{
+			const size_t uiLength = strlen(aszExtensions[i]);
+			if (sKey.size() > uiLength && sKey.compare(sKey.size() - uiLength, uiLength, aszExtensions[i]) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	// - Adds every image in 'ac_sFolder' and the folders inside it to 'a_vImages'
+	void FindImages(const std::string& ac_sFolder, std::vector<Image>& a_vImages)
+	{
+		std::vector<std::string> vEntries;
+		std::vector<bool> vIsFolder;
+
+#ifdef _WIN32
+		WIN32_FIND_DATAA findData;
+		HANDLE hFind = FindFirstFileA((ac_sFolder + "/*").c_str(), &findData);
+		if (hFind == INVALID_HANDLE_VALUE)
+			return;
+
+		do
+		{
+			vEntries.push_back(findData.cFileName);
+			vIsFolder.push_back((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0);
+		} while (FindNextFileA(hFind, &findData));
+		FindClose(hFind);
+#else
+		DIR* pFolder = opendir(ac_sFolder.c_str());
+		if (pFolder == nullptr)
+			return;
+
+		for (dirent* pEntry = readdir(pFolder); pEntry != nullptr; pEntry = readdir(pFolder))
+		{
+			struct stat fileStat;
+			stat((ac_sFolder + "/" + pEntry->d_name).c_str(), &fileStat);
+
+			vEntries.push_back(pEntry->d_name);
+			vIsFolder.push_back(S_ISDIR(fileStat.st_mode));
+		}
+		closedir(pFolder);
+#endif
+
+		// Sorted so the same folder always makes the same pack
+		std::vector<unsigned int> vOrder(vEntries.size());
+		for (unsigned int i = 0; i < vOrder.size(); ++i)
+			vOrder[i] = i;
+		std::sort(vOrder.begin(), vOrder.end(), [&](unsigned int a, unsigned int b) { return vEntries[a] < vEntries[b]; });
+
+		for (unsigned int i = 0; i < vOrder.size(); ++i)
+		{
+			const std::string& sName = vEntries[vOrder[i]];
+			if (sName == "." || sName == "..")
+				continue;
+
+			const std::string sPath = ac_sFolder + "/" + sName;
+			if (vIsFolder[vOrder[i]])
+			{
+				FindImages(sPath, a_vImages);
+			}
+			else if (IsImage(sPath))
+			{
+				Image image;
+				image.sPath = sPath;
+				a_vImages.push_back(image);
+			}
+		}
+	}
+
+	void Decode(Image& a_Image)
+	{
+		SDL_Surface* sdlLoaded = IMG_Load(a_Image.sPath.c_str());
+		if (sdlLoaded == NULL)
+		{
+			printf("Skipping '%s': %s\n", a_Image.sPath.c_str(), SDL_GetError());
+			return;
+		}
+
+		// Packs hold straight alpha, so the game can choose whether to premultiply when it loads them
+		SDL_Surface* sdlConverted = Graphics::ConvertSurface(*sdlLoaded, false);
+		SDL_FreeSurface(sdlLoaded);
+		if (sdlConverted == NULL)
+		{
+			printf("Skipping '%s': %s\n", a_Image.sPath.c_str(), SDL_GetError());
+			return;
+		}
+
+		a_Image.uiWidth = sdlConverted->w;
+		a_Image.uiHeight = sdlConverted->h;
+
+		// Rows are copied without the padding SDL may add, which is how 'glTexImage2D' expects them by default
+		const unsigned int uiRowBytes = sdlConverted->w * 4;
+		a_Image.vPixels.resize(uiRowBytes * sdlConverted->h);
+		for (int iRow = 0; iRow < sdlConverted->h; ++iRow)
+			memcpy(&a_Image.vPixels[iRow * uiRowBytes], (const Uint8*)sdlConverted->pixels + iRow * sdlConverted->pitch, uiRowBytes);
+
+		SDL_FreeSurface(sdlConverted);
+	}
+
+	Uint64 Align(const Uint64 ac_ullOffset)
+	{
+		return (ac_ullOffset + Graphics::AssetPack::kuiPackAlignment - 1) & ~(Uint64)(Graphics::AssetPack::kuiPackAlignment - 1);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace Graphics::AssetPack;
+
+	if (argc < 3)
+	{
+		printf("Usage: AssetPacker <output.pack> <folder or image>...\n");
+		return 1;
+	}
+
+	SDL_SetMainReady();
+	IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF | IMG_INIT_WEBP);
+
+	std::vector<Image> vImages;
+	for (int i = 2; i < argc; ++i)
+	{
+		if (IsImage(argv[i]))
+		{
+			Image image;
+			image.sPath = argv[i];
+			vImages.push_back(image);
+		}
+		else
+		{
+			FindImages(argv[i], vImages);
+		}
+	}
+
+	// The same file given twice only goes in once
+	std::vector<Image> vUnique;
+	for (unsigned int i = 0; i < vImages.size(); ++i)
+	{
+		vImages[i].sKey = Graphics::AssetPack::PackName(Graphics::TextureCache::NormalizePath(vImages[i].sPath.c_str()));
+
+		bool bDuplicate = false;
+		for (unsigned int j = 0; j < vUnique.size() && !bDuplicate; ++j)
+			bDuplicate = vUnique[j].sKey == vImages[i].sKey;
+		if (!bDuplicate)
+			vUnique.push_back(vImages[i]);
+	}
+	vImages.swap(vUnique);
+
+	// Every core decodes, taking the next image as it finishes the last
+	std::atomic<unsigned int> uiNext(0);
+	std::vector<std::thread> vThreads;
+	for (unsigned int i = 0; i < std::max(std::thread::hardware_concurrency(), 1u); ++i)
+	{
+		vThreads.push_back(std::thread([&]()
+		{
+			for (unsigned int uiImage = uiNext++; uiImage < vImages.size(); uiImage = uiNext++)
+				Decode(vImages[uiImage]);
+		}));
+	}
+	for (unsigned int i = 0; i < vThreads.size(); ++i)
+		vThreads[i].join();
+
+	vImages.erase(std::remove_if(vImages.begin(), vImages.end(), [](const Image& ac_Image) { return ac_Image.vPixels.empty(); }), vImages.end());
+
+	// At most half the slots are used, so probes stay short
+	Uint32 uiSlots = 16;
+	while (uiSlots < vImages.size() * 2)
+		uiSlots *= 2;
+
+	// Lay the file out: header, slots, names and then the pixels of each image on an aligned boundary
+	Uint64 ullOffset = sizeof(PackHeader) + (Uint64)uiSlots * sizeof(PackEntry);
+	for (unsigned int i = 0; i < vImages.size(); ++i)
+	{
+		vImages[i].uiNameOffset = (Uint32)ullOffset;
+		ullOffset += vImages[i].sKey.size();
+	}
+	for (unsigned int i = 0; i < vImages.size(); ++i)
+	{
+		ullOffset = Align(ullOffset);
+		vImages[i].ullOffset = ullOffset;
+		ullOffset += vImages[i].vPixels.size();
+	}
+
+	PackHeader header;
+	memcpy(header.aMagic, kaMagic, sizeof(kaMagic));
+	header.uiVersion = kuiVersion;
+	header.uiSlots = uiSlots;
+	header.uiEntries = (Uint32)vImages.size();
+	header.ullFileSize = ullOffset;
+
+	std::vector<PackEntry> vSlots(uiSlots);
+	memset(vSlots.data(), 0, vSlots.size() * sizeof(PackEntry));
+	for (unsigned int i = 0; i < vImages.size(); ++i)
+	{
+		const Uint64 ullHash = Hash(vImages[i].sKey);
+
+		Uint32 uiSlot = (Uint32)(ullHash & (uiSlots - 1));
+		while (vSlots[uiSlot].ullOffset != 0)
+			uiSlot = (uiSlot + 1) & (uiSlots - 1);
+
+		PackEntry& entry = vSlots[uiSlot];
+		entry.ullHash = ullHash;
+		entry.ullOffset = vImages[i].ullOffset;
+		entry.uiWidth = vImages[i].uiWidth;
+		entry.uiHeight = vImages[i].uiHeight;
+		entry.uiFormat = FORMAT_RGBA8;
+		entry.uiNameOffset = vImages[i].uiNameOffset;
+		entry.uiNameLength = (Uint32)vImages[i].sKey.size();
+	}
+
+	FILE* pFile = fopen(argv[1], "wb");
+	if (pFile == NULL)
+	{
+		printf("Could not open '%s' for writing\n", argv[1]);
+		return 1;
+	}
+
+	// The offset written to is counted here rather than asked of 'ftell', whose 'long' is 32 bits on Windows
+	fwrite(&header, sizeof(header), 1, pFile);
+	fwrite(vSlots.data(), sizeof(PackEntry), vSlots.size(), pFile);
+	Uint64 ullWritten = sizeof(PackHeader) + (Uint64)uiSlots * sizeof(PackEntry);
+	for (unsigned int i = 0; i < vImages.size(); ++i)
+	{
+		fwrite(vImages[i].sKey.data(), 1, vImages[i].sKey.size(), pFile);
+		ullWritten += vImages[i].sKey.size();
+	}
+
+	const Uint8 aZeros[kuiPackAlignment] = {};
+	for (unsigned int i = 0; i < vImages.size(); ++i)
+	{
+		fwrite(aZeros, 1, (size_t)(vImages[i].ullOffset - ullWritten), pFile);
+		fwrite(vImages[i].vPixels.data(), 1, vImages[i].vPixels.size(), pFile);
+		ullWritten = vImages[i].ullOffset + vImages[i].vPixels.size();
+	}
+
+	const bool bFailed = ferror(pFile) != 0;
+	fclose(pFile);
+	if (bFailed)
+	{
+		printf("Could not write all of '%s'\n", argv[1]);
+		return 1;
+	}
+
+	printf("Packed %u images into '%s' (%.1f MB)\n", (unsigned int)vImages.size(), argv[1], ullOffset / (1024.0 * 1024.0));
+
+	IMG_Quit();
+
+	return 0;
+}
@@ -0,0 +1,112 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'fopen' with Visual Studio's SDL checks turned on
+
+#include "Benchmark.h"
+
+#include <SDL.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+	unsigned int uiSamples = 50;
+	std::string sLabel = "default";
+
+	std::vector<Benchmark::Result> vResults;
+
+	volatile double dSink = 0.0; // Written by 'Consume' so the compiler can't prove a benchmarked value is unused
+
+	double Percentile(const std::vector<double>& ac_vSorted, const double ac_dPercent)
+	{
+		const unsigned int uiIndex = (unsigned int)(ac_dPercent / 100.0 * (ac_vSorted.size() - 1) + 0.5);
+
+		return ac_vSorted[std::min(uiIndex, (unsigned int)ac_vSorted.size() - 1)];
+	}
+}
+
+void Benchmark::SetSamples(const unsigned int ac_uiSamples)
+{
+	uiSamples = std::max(ac_uiSamples, 1u);
+}
+void Benchmark::SetLabel(const char* ac_szLabel)
+{
+	sLabel = ac_szLabel;
+}
+
+const Benchmark::Result& Benchmark::Run(
+	const char*					 ac_szName,
+	const unsigned int			 ac_uiOperations,
+	const std::function<void()>& ac_Sample,
+	const std::function<void()>& ac_Reset)
+{
+	const double dNanosecondsPerTick = 1000000000.0 / SDL_GetPerformanceFrequency();
+
+	ac_Sample(); // Warm up caches, the driver and any lazily created state
+	if (ac_Reset)
+		ac_Reset();
+
+	std::vector<double> vTimes(uiSamples);
+	for (unsigned int i = 0; i < uiSamples; ++i)
+	{
+		const Uint64 uiBegin = SDL_GetPerformanceCounter();
+		ac_Sample();
+		const Uint64 uiEnd = SDL_GetPerformanceCounter();
+
+		vTimes[i] = (uiEnd - uiBegin) * dNanosecondsPerTick / std::max(ac_uiOperations, 1u);
+
+		if (ac_Reset)
+			ac_Reset();
+	}
+	std::sort(vTimes.begin(), vTimes.end());
+
+	Result result;
+	result.sName = ac_szName;
+	result.uiOperations = ac_uiOperations;
+	result.uiSamples = uiSamples;
+	result.dMin = vTimes.front();
+	result.dMedian = Percentile(vTimes, 50.0);
+	result.dP90 = Percentile(vTimes, 90.0);
+	result.dP99 = Percentile(vTimes, 99.0);
+	result.dMax = vTimes.back();
+
+	printf("%-40s median %12.1f ns   p90 %12.1f ns   p99 %12.1f ns\n", ac_szName, result.dMedian, result.dP90, result.dP99);
+
+	vResults.push_back(result);
+	return vResults.back();
+}
+
+const std::vector<Benchmark::Result>& Benchmark::GetResults()
+{
+	return vResults;
+}
+
+bool Benchmark::WriteJSON(const char* ac_szFilename)
+{
+	FILE* pFile = ac_szFilename != nullptr ? fopen(ac_szFilename, "w") : stdout;
+	if (pFile == NULL)
+	{
+		printf("Benchmark: Could not open '%s' for writing\n", ac_szFilename);
+		return false;
+	}
+
+	fprintf(pFile, "{\n  \"label\": \"%s\",\n  \"unit\": \"ns/op\",\n  \"results\": [\n", sLabel.c_str());
+	for (unsigned int i = 0; i < vResults.size(); ++i)
+	{
+		const Result& result = vResults[i];
+		fprintf(pFile, "    { \"name\": \"%s\", \"operations\": %u, \"samples\": %u, \"min\": %.2f, \"median\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"max\": %.2f }%s\n",
+			result.sName.c_str(), result.uiOperations, result.uiSamples,
+			result.dMin, result.dMedian, result.dP90, result.dP99, result.dMax,
+			i + 1 < vResults.size() ? "," : "");
+	}
+	fprintf(pFile, "  ]\n}\n");
+
+	if (pFile != stdout)
+		fclose(pFile);
+
+	return true;
+}
+
+void Benchmark::Consume(const double ac_dValue)
+{
+	dSink = dSink + ac_dValue;
+}
@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////
+// File: Benchmark.h
+// Author: Ben Odom
+// Brief: A small timing harness for measuring the Graphics
+//		  library. Each benchmark is run for a number of
+//		  samples, and the median and percentile time per
+//		  operation is written out as JSON so two runs (or
+//		  two versions of the library) can be compared
+//////////////////////////////////////////////////////////////
+
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+	// The timings of one benchmark. All times are nanoseconds per operation
+	struct Result
+	{
+		std::string sName;
+
+		unsigned int uiOperations; // Operations timed in each sample
+		unsigned int uiSamples;
+
+		double dMin;
+		double dMedian;
+		double dP90;
+		double dP99;
+		double dMax;
+	};
+
+	// - Sets how many samples every following benchmark takes
+	void SetSamples(const unsigned int ac_uiSamples);
+	// - Tags the results with a name, such as the library version being measured
+	void SetLabel(const char* ac_szLabel);
+
+	// - Calls 'ac_Sample' once to warm up and then once per sample, timing each call
+	//   'ac_Sample' should perform 'ac_uiOperations' operations, so the result is the time of one of them
+	//   'ac_Reset', if given, is called after every sample without being timed, to undo what the sample did
+	const Result& Run(
+		const char*					 ac_szName,
+		const unsigned int			 ac_uiOperations,
+		const std::function<void()>& ac_Sample,
+		const std::function<void()>& ac_Reset = nullptr);
+
+	// - Returns every result recorded so far
+	const std::vector<Result>& GetResults();
+
+	// - Writes every result to a JSON file, or to the console if 'ac_szFilename' is nullptr
+	bool WriteJSON(const char* ac_szFilename);
+
+	// - Stops the compiler from optimizing away a value that is otherwise never used
+	void Consume(const double ac_dValue);
+
+	// - Runs every benchmark of the 'Graphics' namespace and 'System' math operators, the portable ones included
+	void RunGraphicsBenchmarks();
+	// - Runs the benchmarks that need neither a window nor the library: 'System' math, pixel conversion,
+	//   building mip chains, hashing for the 'TextureCache' and looking images up in an asset pack
+	void RunPortableBenchmarks();
+}
+
+#endif // _BENCHMARK_H_
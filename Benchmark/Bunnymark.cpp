@@ -0,0 +1,255 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'fopen' with Visual Studio's SDL checks turned on
+
+#include "Bunnymark.h"
+
+#include "Overdraw.h"
+#include "RenderPass.h"
+#include "PerfHud.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+	const System::Size2D<int> kSpriteSize = { 26, 37 };
+
+	const float kfStep = 1.0f / 60.0f; // Sprites move a fixed step per frame, so a seed plays out the same on any machine
+	const float kfGravity = 2700.0f;
+
+	const unsigned int kuiWarmUpFrames = 30;	// Frames ignored at the start while the driver settles
+	const unsigned int kuiFramesToFail = 30;	// How long the average has to stay over budget before the run ends
+	const unsigned int kuiSettleFrames = 30;	// How long a count is held under budget before it counts as sustained. The average keeps under 5% of what came before it by then
+	const double kdAverageWeight = 0.1;			// How much each new frame moves the running average
+
+	// Names for each 'LayerType' as they show up in the overdraw report
+	const char* const aszLayerNames[Graphics::kuiStatsLayers] =
+	{
+		"background", "inlinefore", "midground", "foreground", "foundation", "structure", "overlay", "always_top"
+	};
+}
+
+Bunnymark::Settings Bunnymark::DefaultSettings()
+{
+	Settings settings;
+	settings.uiSeed = 1;
+	settings.uiMaxFrames = 0;
+	settings.uiSpawnPerFrame = 100;
+	settings.dBudgetMilliseconds = 1000.0 / 60.0;
+	settings.bHeadless = false;
+	settings.bOverdraw = false;
+	settings.szOut = nullptr;
+
+	return settings;
+}
+
+unsigned int Bunnymark::GetSustainedSprites() const
+{
+	return m_uiSustainedSprites;
+}
+
+void Bunnymark::Update()
+{
+	const Uint64 uiNow = SDL_GetPerformanceCounter();
+	const double dMilliseconds = (uiNow - m_uiLastFrame) * 1000.0 / SDL_GetPerformanceFrequency();
+	m_uiLastFrame = uiNow;
+
+	++m_uiFrames;
+	if (m_uiFrames > kuiWarmUpFrames)
+	{
+		m_dAverageMilliseconds = m_dAverageMilliseconds == 0.0 ? dMilliseconds : m_dAverageMilliseconds + (dMilliseconds - m_dAverageMilliseconds) * kdAverageWeight;
+
+		// The average lags the frames it is made of, so the count is held still until it has caught up with the last spawn
+		if (m_dAverageMilliseconds <= m_Settings.dBudgetMilliseconds)
+		{
+			m_uiFramesOverBudget = 0;
+
+			if (++m_uiSettledFrames >= kuiSettleFrames)
+			{
+				m_uiSustainedSprites = std::max(m_uiSustainedSprites, (unsigned int)m_vSprites.size());
+				m_uiSettledFrames = 0;
+
+				Spawn(m_Settings.uiSpawnPerFrame);
+			}
+		}
+		else
+		{
+			m_uiSettledFrames = 0;
+			if (++m_uiFramesOverBudget >= kuiFramesToFail)
+				m_bRunning = false;
+		}
+	}
+	if (m_Settings.uiMaxFrames != 0 && m_uiFrames >= m_Settings.uiMaxFrames)
+		m_bRunning = false;
+
+	// Sprites fall, bounce off the bottom and sides, and spin
+	const System::Size2D<unsigned int>& Bounds = Graphics::voWindows[0]->GetResolution();
+	const float fRight = (float)(Bounds.W - kSpriteSize.W);
+	const float fBottom = (float)(Bounds.H - kSpriteSize.H);
+	for (unsigned int i = 0; i < m_vSprites.size(); ++i)
+	{
+		Sprite& sprite = m_vSprites[i];
+		System::Point2D<float>& Pos = sprite.pSurface->Pos;
+
+		sprite.Velocity.Y += kfGravity * kfStep;
+		Pos.X += sprite.Velocity.X * kfStep;
+		Pos.Y += sprite.Velocity.Y * kfStep;
+		sprite.pSurface->Rotation += sprite.fSpin * kfStep;
+
+		if (Pos.X < 0 || Pos.X > fRight)
+		{
+			sprite.Velocity.X = -sprite.Velocity.X;
+			Pos.X = std::min(std::max(Pos.X, 0.0f), fRight);
+		}
+		if (Pos.Y > fBottom)
+		{
+			// Bounce back up with most of the speed, like the original bunnymark
+			sprite.Velocity.Y *= -0.85f;
+			Pos.Y = fBottom;
+		}
+		else if (Pos.Y < 0)
+		{
+			sprite.Velocity.Y = 0;
+			Pos.Y = 0;
+		}
+	}
+}
+
+void Bunnymark::Draw()
+{
+	Graphics::DrawCameras();
+
+	PerfHud::Draw();
+}
+
+void Bunnymark::Spawn(const unsigned int ac_uiCount)
+{
+	std::uniform_real_distribution<float> RandomSpeed(60.0f, 600.0f);
+	std::uniform_real_distribution<float> RandomSpin(-180.0f, 180.0f);
+	std::uniform_real_distribution<float> RandomAngle(0.0f, 360.0f);
+	std::uniform_int_distribution<int> RandomLayer(Graphics::BACKGROUND, Graphics::ALWAYS_TOP);
+	std::uniform_int_distribution<int> RandomTint(64, 255);
+
+	for (unsigned int i = 0; i < ac_uiCount; ++i)
+	{
+		Sprite sprite;
+		sprite.pSurface = new Graphics::GLSurface<float>(*m_pTemplate);
+		Graphics::TextureCache::AddReference(sprite.pSurface->Surface);
+		sprite.pSurface->Pos = { 0, 0 };
+		sprite.pSurface->Rotation = RandomAngle(m_Random);
+		sprite.pSurface->Layer = (Graphics::LayerType)RandomLayer(m_Random);
+		sprite.pSurface->Color = { (float)RandomTint(m_Random), (float)RandomTint(m_Random), (float)RandomTint(m_Random), 255 };
+		sprite.pSurface->bIsActive = true;
+
+		sprite.Velocity = { RandomSpeed(m_Random), RandomSpeed(m_Random) - 300.0f };
+		sprite.fSpin = RandomSpin(m_Random);
+
+		Graphics::PushSurface(sprite.pSurface);
+		m_vSprites.push_back(sprite);
+	}
+
+	// Sorting once per batch instead of once per sprite, the way 'LoadSurface' would
+	std::stable_sort(Graphics::vglSurfaces.begin(), Graphics::vglSurfaces.end(), Graphics::SortLayer);
+}
+
+void Bunnymark::Report() const
+{
+	printf("Bunnymark: %u sprites sustained under %.2fms (seed %u, %u frames, %u sprites at the end)\n",
+		m_uiSustainedSprites, m_Settings.dBudgetMilliseconds, m_Settings.uiSeed, m_uiFrames, (unsigned int)m_vSprites.size());
+
+	// The last frame to finish has the most sprites the run drew
+	const Graphics::FrameStats& frameStats = Graphics::GetFrameStats();
+	const unsigned int uiCameras = std::min((unsigned int)Graphics::voCameras.size(), Graphics::kuiStatsCameras);
+	Graphics::OverdrawStats overdraw = { 0, 0, 0 };
+	for (unsigned int i = 0; i < uiCameras; ++i)
+		overdraw.Add(frameStats.CameraOverdraw[i]);
+
+	if (m_Settings.bOverdraw)
+	{
+		printf("Bunnymark: overdraw average %.2f, max %u\n", overdraw.Average(), overdraw.uiMax);
+		for (unsigned int i = 0; uiCameras > 1 && i < uiCameras; ++i)
+			printf("  camera %-5u average %.2f, max %u\n", i, frameStats.CameraOverdraw[i].Average(), frameStats.CameraOverdraw[i].uiMax);
+		for (unsigned int i = 0; i < Graphics::kuiStatsLayers; ++i)
+			printf("  %-12s average %.2f, max %u\n", aszLayerNames[i], frameStats.LayerOverdraw[i].Average(), frameStats.LayerOverdraw[i].uiMax);
+	}
+
+	if (m_Settings.szOut == nullptr)
+		return;
+
+	FILE* pFile = fopen(m_Settings.szOut, "w");
+	if (pFile == NULL)
+	{
+		printf("Bunnymark: Could not open '%s' for writing\n", m_Settings.szOut);
+		return;
+	}
+
+	fprintf(pFile, "{\n  \"scenario\": \"bunnymark\",\n  \"seed\": %u,\n  \"budget_ms\": %.3f,\n  \"frames\": %u,\n  \"sustained_sprites\": %u,\n  \"final_sprites\": %u,\n  \"final_average_ms\": %.3f",
+		m_Settings.uiSeed, m_Settings.dBudgetMilliseconds, m_uiFrames, m_uiSustainedSprites, (unsigned int)m_vSprites.size(), m_dAverageMilliseconds);
+
+	if (m_Settings.bOverdraw)
+	{
+		// The totals are every camera's pixels together, the same way the layers are counted
+		fprintf(pFile, ",\n  \"overdraw\": { \"average\": %.3f, \"max\": %u, \"cameras\": [", overdraw.Average(), overdraw.uiMax);
+		for (unsigned int i = 0; i < uiCameras; ++i)
+		{
+			fprintf(pFile, "%s { \"average\": %.3f, \"max\": %u }", i > 0 ? "," : "",
+				frameStats.CameraOverdraw[i].Average(), frameStats.CameraOverdraw[i].uiMax);
+		}
+		fprintf(pFile, " ], \"layers\": {");
+		for (unsigned int i = 0; i < Graphics::kuiStatsLayers; ++i)
+		{
+			fprintf(pFile, "%s \"%s\": { \"average\": %.3f, \"max\": %u }", i > 0 ? "," : "",
+				aszLayerNames[i], frameStats.LayerOverdraw[i].Average(), frameStats.LayerOverdraw[i].uiMax);
+		}
+		fprintf(pFile, " } }");
+	}
+	fprintf(pFile, "\n}\n");
+
+	fclose(pFile);
+}
+
+Bunnymark::Bunnymark(const Settings& ac_Settings) : m_Settings(ac_Settings), m_Random(ac_Settings.uiSeed)
+{
+	m_dAverageMilliseconds = 0.0;
+	m_uiFrames = 0;
+	m_uiFramesOverBudget = 0;
+	m_uiSettledFrames = 0;
+	m_uiSustainedSprites = 0;
+
+	// Waiting for vsync would hold every frame at the refresh rate and hide how long it really took
+	SDL_GL_SetSwapInterval(0);
+	if (m_Settings.bHeadless)
+		SDL_HideWindow(Graphics::voWindows[0]->GetWindow());
+	Graphics::SetOverdrawMode(m_Settings.bOverdraw);
+
+	SDL_Surface* sdlSurface = SDL_CreateRGBSurface(0, kSpriteSize.W, kSpriteSize.H, 32, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+	SDL_FillRect(sdlSurface, NULL, 0xFFFFFFFF);
+
+	m_pTemplate = Graphics::LoadSurface<float>(*sdlSurface);
+	m_pTemplate->bIsActive = false;
+
+	m_CameraAnchor = { 0, 0 };
+	Graphics::NewCamera<float>({ 0, 0 }, { 0, 0 }, m_CameraAnchor);
+
+	m_uiLastFrame = SDL_GetPerformanceCounter();
+}
+Bunnymark::~Bunnymark()
+{
+	// The template and every sprite copied from it each hold a reference to the texture
+	// Anything else left in the vector is read through the member 'Tag' says is set
+	for (unsigned int i = 0; i < Graphics::vglSurfaces.size(); ++i)
+	{
+		switch (Graphics::vglSurfaces[i]->Tag)
+		{
+		case Graphics::SurfaceUnion::FLOAT:
+			Graphics::TextureCache::Release(Graphics::vglSurfaces[i]->fGLSurface->Surface);
+			delete Graphics::vglSurfaces[i]->fGLSurface;
+			break;
+		case Graphics::SurfaceUnion::INT:
+			Graphics::TextureCache::Release(Graphics::vglSurfaces[i]->iGLSurface->Surface);
+			delete Graphics::vglSurfaces[i]->iGLSurface;
+			break;
+		}
+		delete Graphics::vglSurfaces[i];
+	}
+	Graphics::vglSurfaces.clear();
+}
@@ -0,0 +1,77 @@
+//////////////////////////////////////////////////////////////
+// File: Bunnymark.h
+// Author: Ben Odom
+// Brief: A sprite stress test run through 'GameLoop'. Once
+//		  frames have settled inside the frame budget, more
+//		  bouncing sprites are added, until frames stop fitting.
+//		  The most sprites that were drawn while still
+//		  keeping to the budget is the score
+//////////////////////////////////////////////////////////////
+
+#ifndef _BUNNYMARK_H_
+#define _BUNNYMARK_H_
+
+#include "GameLoop.h"
+
+#include <random>
+#include <vector>
+
+class Bunnymark : public GameLoop
+{
+public:
+	struct Settings
+	{
+		unsigned int uiSeed;		  // The same seed always spawns the same sprites in the same places
+		unsigned int uiMaxFrames;	  // Stops after this many frames even if the budget is never crossed. 0 means no limit
+		unsigned int uiSpawnPerFrame; // Sprites added each time the frame time has settled under the budget
+		double dBudgetMilliseconds;	  // The frame time to stay under. 16.67ms is 60Hz
+		bool bHeadless;				  // Hides the window while running
+		bool bOverdraw;				  // Runs in the overdraw mode and reports how often the last frame drew each pixel
+		const char* szOut;			  // Where to write the JSON result, or nullptr for the console only
+	};
+
+	// - The settings used when none are given: seed 1, no frame limit, 100 sprites a spawn and a 60Hz budget
+	static Settings DefaultSettings();
+
+	// - Returns the most sprites that were drawn while frame time settled and stayed under the budget
+	unsigned int GetSustainedSprites() const;
+	// - Prints the result and writes it to 'Settings::szOut'. Call after 'Loop' returns
+	void Report() const;
+
+	void Update() override;
+	void Draw() override;
+
+	Bunnymark(const Settings& ac_Settings);
+	~Bunnymark();
+
+private:
+	struct Sprite
+	{
+		Graphics::GLSurface<float>* pSurface;
+
+		System::Point2D<float> Velocity;
+		float fSpin;
+	};
+
+	// - Adds 'ac_uiCount' sprites at the top left corner with random speeds, layers, rotations and tints
+	void Spawn(const unsigned int ac_uiCount);
+
+	Settings m_Settings;
+
+	std::mt19937 m_Random;
+
+	std::vector<Sprite> m_vSprites;
+	Graphics::GLSurface<float>* m_pTemplate; // Loads the texture every sprite shares. Never drawn itself
+
+	System::Point2D<float> m_CameraAnchor; // 'Camera' keeps a pointer to this, so it has to live as long as the camera
+
+	Uint64 m_uiLastFrame;
+	double m_dAverageMilliseconds; // A running average, so a single slow frame doesn't end the run
+	unsigned int m_uiFrames;
+	unsigned int m_uiFramesOverBudget;
+	unsigned int m_uiSettledFrames; // Frames in a row under budget since the last spawn
+
+	unsigned int m_uiSustainedSprites;
+};
+
+#endif // _BUNNYMARK_H_
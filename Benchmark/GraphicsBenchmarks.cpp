@@ -0,0 +1,302 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'snprintf' and 'remove' with Visual Studio's SDL checks turned on
+
+#include "Benchmark.h"
+
+#include "RenderPass.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace
+{
+	const char* kszTempImage = "benchmark_surface_%u.bmp";
+
+	const unsigned int kuiTextureSize = 32;
+
+	// Camera objects keep a pointer to the point they are anchored to, so it has to outlive them
+	const System::Point2D<float> RelativePos = { 0, 0 };
+
+	std::mt19937 Random(1234); // Fixed seed, so every run draws the same scene
+
+	// - Creates a solid 'SDL_Surface'. Surfaces with different colors won't share a texture in the 'TextureCache'
+	SDL_Surface* NewSdlSurface(const Uint32 ac_uiColor = 0xFF8040C0)
+	{
+		SDL_Surface* sdlSurface = SDL_CreateRGBSurface(0, kuiTextureSize, kuiTextureSize, 32, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+		SDL_FillRect(sdlSurface, NULL, ac_uiColor);
+
+		return sdlSurface;
+	}
+
+	void ReleaseSurfaces()
+	{
+		for (unsigned int i = 0; i < Graphics::vglSurfaces.size(); ++i)
+		{
+			Graphics::SurfaceUnion* pUnion = Graphics::vglSurfaces[i];
+			if (pUnion->Tag == Graphics::SurfaceUnion::FLOAT)
+			{
+				Graphics::TextureCache::Release(pUnion->fGLSurface->Surface);
+				delete pUnion->fGLSurface;
+			}
+			else
+			{
+				Graphics::TextureCache::Release(pUnion->iGLSurface->Surface);
+				delete pUnion->iGLSurface;
+			}
+			delete pUnion;
+		}
+		Graphics::vglSurfaces.clear();
+
+		Graphics::GLState::InvalidateAll();
+	}
+	void ReleaseCameras()
+	{
+		for (unsigned int i = 0; i < Graphics::voCameras.size(); ++i)
+		{
+			if (Graphics::voCameras[i]->Tag == Graphics::CameraUnion::FLOAT)
+				delete Graphics::voCameras[i]->fCamera;
+			else
+				delete Graphics::voCameras[i]->iCamera;
+			delete Graphics::voCameras[i];
+		}
+		Graphics::voCameras.clear();
+	}
+
+	// - Fills the scene with 'ac_uiSurfaces' surfaces spread over the window, all sharing one texture the way sprites usually do
+	void BuildScene(const unsigned int ac_uiSurfaces, const unsigned int ac_uiCameras)
+	{
+		const Graphics::GLSurface<float>* pTemplate = Graphics::LoadSurface<float>(*NewSdlSurface());
+
+		const System::Size2D<unsigned int>& Resolution = Graphics::voWindows[0]->GetResolution();
+		std::uniform_real_distribution<float> RandomX(0.0f, (float)Resolution.W);
+		std::uniform_real_distribution<float> RandomY(0.0f, (float)Resolution.H);
+		std::uniform_int_distribution<int> RandomLayer(Graphics::BACKGROUND, Graphics::ALWAYS_TOP);
+
+		// Copies are pushed directly instead of loaded, since every 'LoadSurface' sorts the whole vector
+		for (unsigned int i = 1; i < ac_uiSurfaces; ++i)
+		{
+			Graphics::GLSurface<float>* glSurface = new Graphics::GLSurface<float>(*pTemplate);
+			Graphics::TextureCache::AddReference(glSurface->Surface);
+			glSurface->Pos = { RandomX(Random), RandomY(Random) };
+			glSurface->Layer = (Graphics::LayerType)RandomLayer(Random);
+			Graphics::PushSurface(glSurface);
+		}
+		std::sort(Graphics::vglSurfaces.begin(), Graphics::vglSurfaces.end(), Graphics::SortCamera);
+		std::sort(Graphics::vglSurfaces.begin(), Graphics::vglSurfaces.end(), Graphics::SortLayer);
+
+		// Cameras split the window into equal columns
+		for (unsigned int i = 0; i < ac_uiCameras; ++i)
+		{
+			const float fWidth = 100.0f / ac_uiCameras;
+			const float fScreenX = ac_uiCameras > 1 ? 100.0f * i / (ac_uiCameras - 1) : 0.0f;
+			Graphics::NewCamera<float>({ fScreenX, 0 }, { 0, 0 }, RelativePos, { fWidth, 100 });
+		}
+	}
+	void ReleaseScene()
+	{
+		ReleaseSurfaces();
+		ReleaseCameras();
+	}
+
+	void BenchmarkPrimitives()
+	{
+		const unsigned int kuiCalls = 1000;
+		const System::Color<float> White = { 255, 255, 255, 255 };
+
+		Benchmark::Run("DrawRect", kuiCalls, [&]()
+		{
+			for (unsigned int i = 0; i < kuiCalls; ++i)
+				Graphics::DrawRect<float>({ (float)(i % 1600), 100 }, { 16, 16 }, White);
+			glFinish();
+		});
+		Benchmark::Run("DrawLine", kuiCalls, [&]()
+		{
+			for (unsigned int i = 0; i < kuiCalls; ++i)
+				Graphics::DrawLine<float>({ (float)(i % 1600), 0 }, { 0, 900 }, White);
+			glFinish();
+		});
+		Benchmark::Run("DrawPoint", kuiCalls, [&]()
+		{
+			for (unsigned int i = 0; i < kuiCalls; ++i)
+				Graphics::DrawPoint<float>({ (float)(i % 1600), (float)(i % 900) }, White);
+			glFinish();
+		});
+		Benchmark::Run("DrawRing/32", kuiCalls, [&]()
+		{
+			for (unsigned int i = 0; i < kuiCalls; ++i)
+				Graphics::DrawRing<float>({ (float)(i % 1600), 450 }, 32, 32, White);
+			glFinish();
+		});
+		Benchmark::Run("DrawCircle/32", kuiCalls, [&]()
+		{
+			for (unsigned int i = 0; i < kuiCalls; ++i)
+				Graphics::DrawCircle<float>({ (float)(i % 1600), 450 }, 32, 32, White);
+			glFinish();
+		});
+	}
+
+	void BenchmarkLoadSurface()
+	{
+		const unsigned int kuiLoads = 16;
+
+		std::vector<SDL_Surface*> vSdlSurfaces;
+		const auto MakeSdlSurfaces = [&](const bool ac_bIdentical)
+		{
+			vSdlSurfaces.clear();
+			for (unsigned int i = 0; i < kuiLoads; ++i)
+				vSdlSurfaces.push_back(ac_bIdentical ? NewSdlSurface() : NewSdlSurface(0xFF000000 | i));
+		};
+
+		// 'LoadSurface' frees the 'SDL_Surface' it is given, so new ones are made between samples
+		// Different pixels upload a texture each, identical ones upload the first and share it with the rest
+		MakeSdlSurfaces(false);
+		Benchmark::Run("LoadSurface/SDL_Surface", kuiLoads, [&]()
+		{
+			for (unsigned int i = 0; i < kuiLoads; ++i)
+				Graphics::LoadSurface<float>(*vSdlSurfaces[i]);
+			glFinish();
+		}, [&]()
+		{
+			ReleaseSurfaces();
+			MakeSdlSurfaces(false);
+		});
+		ReleaseSurfaces();
+
+		MakeSdlSurfaces(true);
+		Benchmark::Run("LoadSurface/SDL_Surface/Cached", kuiLoads, [&]()
+		{
+			for (unsigned int i = 0; i < kuiLoads; ++i)
+				Graphics::LoadSurface<float>(*vSdlSurfaces[i]);
+			glFinish();
+		}, [&]()
+		{
+			ReleaseSurfaces();
+			MakeSdlSurfaces(true);
+		});
+		ReleaseSurfaces();
+
+		std::vector<std::string> vFilenames;
+		for (unsigned int i = 0; i < kuiLoads; ++i)
+		{
+			char szFilename[64];
+			snprintf(szFilename, sizeof(szFilename), kszTempImage, i);
+			vFilenames.push_back(szFilename);
+
+			SDL_Surface* sdlSurface = NewSdlSurface(0xFF000000 | i);
+			SDL_SaveBMP(sdlSurface, szFilename);
+			SDL_FreeSurface(sdlSurface);
+		}
+
+		Benchmark::Run("LoadSurface/File", kuiLoads, [&]()
+		{
+			for (unsigned int i = 0; i < kuiLoads; ++i)
+				Graphics::LoadSurface<float>(vFilenames[i].c_str());
+			glFinish();
+		}, ReleaseSurfaces);
+		Benchmark::Run("LoadSurface/File/Cached", kuiLoads, [&]()
+		{
+			for (unsigned int i = 0; i < kuiLoads; ++i)
+				Graphics::LoadSurface<float>(vFilenames[0].c_str());
+			glFinish();
+		}, ReleaseSurfaces);
+
+		for (unsigned int i = 0; i < kuiLoads; ++i)
+			remove(vFilenames[i].c_str());
+	}
+
+	void BenchmarkMipmaps()
+	{
+		const System::Size2D<int> Size = { 1024, 1024 };
+
+		std::vector<Uint8> vPixels(Size.W * Size.H * 4);
+		for (unsigned int i = 0; i < vPixels.size(); ++i)
+			vPixels[i] = (Uint8)Random();
+
+		Graphics::SetMipmaps(true);
+		Benchmark::Run("Mipmap/Upload/1024", 1, [&]()
+		{
+			Graphics::TextureCache::Release(Graphics::UploadTexture(vPixels.data(), Size));
+			glFinish();
+		});
+		Graphics::SetMipmaps(false);
+		Benchmark::Run("Mipmap/Upload/1024/None", 1, [&]()
+		{
+			Graphics::TextureCache::Release(Graphics::UploadTexture(vPixels.data(), Size));
+			glFinish();
+		});
+	}
+
+	void BenchmarkSorting(const unsigned int ac_uiSurfaces)
+	{
+		BuildScene(ac_uiSurfaces, 1);
+
+		const auto Shuffle = [&]() { std::shuffle(Graphics::vglSurfaces.begin(), Graphics::vglSurfaces.end(), Random); };
+		Shuffle();
+
+		const std::string sCount = "/" + std::to_string(ac_uiSurfaces);
+		Benchmark::Run(("Sort/Camera" + sCount).c_str(), ac_uiSurfaces, [&]()
+		{
+			std::sort(Graphics::vglSurfaces.begin(), Graphics::vglSurfaces.end(), Graphics::SortCamera);
+		}, Shuffle);
+		Benchmark::Run(("Sort/Layer" + sCount).c_str(), ac_uiSurfaces, [&]()
+		{
+			std::sort(Graphics::vglSurfaces.begin(), Graphics::vglSurfaces.end(), Graphics::SortLayer);
+		}, Shuffle);
+
+		ReleaseScene();
+	}
+
+	// - Times whole frames of surfaces, through the library's 'Draw' and through 'DrawCameras'
+	void BenchmarkDraw(const unsigned int ac_uiSurfaces, const unsigned int ac_uiCameras)
+	{
+		BuildScene(ac_uiSurfaces, ac_uiCameras);
+
+		const std::string sScene = "/" + std::to_string(ac_uiSurfaces) + "x" + std::to_string(ac_uiCameras);
+		Benchmark::Run(("Draw" + sScene).c_str(), 1, []()
+		{
+			{
+				Graphics::GLState::Untracked untracked;
+				Graphics::Draw();
+			}
+			glFinish();
+		});
+		Benchmark::Run(("DrawCameras" + sScene).c_str(), 1, []()
+		{
+			Graphics::DrawCameras();
+			glFinish();
+		});
+
+		ReleaseScene();
+	}
+
+	void BenchmarkFlip()
+	{
+		Benchmark::Run("Flip", 1, []()
+		{
+			Graphics::GLState::Untracked untracked;
+			Graphics::Flip();
+		});
+	}
+
+}
+
+void Benchmark::RunGraphicsBenchmarks()
+{
+	RunPortableBenchmarks();
+
+	BenchmarkPrimitives();
+	BenchmarkLoadSurface();
+	BenchmarkMipmaps();
+
+	BenchmarkSorting(1000);
+	BenchmarkSorting(10000);
+
+	BenchmarkDraw(1000, 1);
+	BenchmarkDraw(1000, 4);
+	BenchmarkDraw(10000, 1);
+	BenchmarkDraw(10000, 4);
+
+	BenchmarkFlip();
+}
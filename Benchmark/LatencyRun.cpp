@@ -0,0 +1,206 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'fopen' with Visual Studio's SDL checks turned on
+
+#include "LatencyRun.h"
+
+#include "Input.h"
+#include "Latency.h"
+#include "PerfHud.h"
+#include "Present.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+	const unsigned int kuiWarmUpFrames = 30; // Frames ignored at the start while the driver settles
+	const int kiMinSize = 10;
+	const int kiMaxSize = 200;
+
+	// - Prints one kind of event's times to one stage, or nothing if none were kept
+	void PrintStats(const char* ac_szKind, const char* ac_szStage, const Latency::Stats& ac_Stats)
+	{
+		if (ac_Stats.uiSamples == 0)
+			return;
+
+		printf("  %-12s %-4s %6llu events  p50 %.2fms  p95 %.2fms  p99 %.2fms  max %.2fms\n",
+			ac_szKind, ac_szStage, ac_Stats.ullTotal, ac_Stats.dP50, ac_Stats.dP95, ac_Stats.dP99, ac_Stats.dMax);
+	}
+
+	void WriteStats(FILE* a_pFile, const char* ac_szStage, const Latency::Stats& ac_Stats)
+	{
+		fprintf(a_pFile, "\"%s\": { \"events\": %llu, \"samples\": %u, \"p50_ms\": %.3f, \"p95_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f }",
+			ac_szStage, ac_Stats.ullTotal, ac_Stats.uiSamples, ac_Stats.dP50, ac_Stats.dP95, ac_Stats.dP99, ac_Stats.dMax);
+	}
+}
+
+LatencyRun::Settings LatencyRun::DefaultSettings()
+{
+	Settings settings;
+	settings.uiFrames = 600;
+	settings.uiSeed = 1;
+	settings.bHeadless = false;
+	settings.bUnthrottled = false;
+	settings.bGpuWait = false;
+	settings.szOut = nullptr;
+
+	return settings;
+}
+
+void LatencyRun::Update()
+{
+	// Times from before the warm up ended are thrown away, along with any events still waiting to be shown
+	if (++m_uiFrames == kuiWarmUpFrames)
+		Latency::Reset();
+	if (m_uiFrames >= kuiWarmUpFrames + m_Settings.uiFrames)
+		m_bRunning = false;
+
+	const Input::State& state = Input::Get();
+	m_Cursor = state.MousePosition;
+	m_iSize = std::min(std::max(m_iSize + state.Wheel.Y * 10, kiMinSize), kiMaxSize);
+	if (Input::IsMousePressed(SDL_BUTTON_LEFT))
+		m_bHighlight = !m_bHighlight;
+}
+
+void LatencyRun::Draw()
+{
+	const float fSize = (float)m_iSize;
+	const float fTint = m_bHighlight ? 255.0f : 120.0f;
+	const float fKey = Input::IsKeyHeld(SDL_SCANCODE_SPACE) ? 255.0f : 0.0f;
+
+	Graphics::DrawRect<float>({ m_Cursor.X - fSize / 2, m_Cursor.Y - fSize / 2 }, { fSize, fSize }, { fTint, fKey, 255.0f - fKey, 255.0f });
+
+	PerfHud::Draw();
+}
+
+void LatencyRun::OnKeyDown(const SDL_Keycode ac_sdlSym, const Uint16 ac_uiMod, const SDL_Scancode ac_sdlScancode)
+{
+	// The pushed space bar is handled in 'Draw' through 'Input', so 'GameLoop' doesn't print it every time
+	if (ac_sdlSym != SDLK_SPACE)
+		GameLoop::OnKeyDown(ac_sdlSym, ac_uiMod, ac_sdlScancode);
+}
+
+void LatencyRun::Feed()
+{
+	std::mt19937 Random(m_Settings.uiSeed);
+	std::uniform_int_distribution<int> RandomKind(0, 3);
+	std::uniform_int_distribution<int> RandomInterval(1, 8); // Milliseconds, so several events land in most frames and some frames get none
+	std::uniform_int_distribution<int> RandomX(0, (int)Graphics::voWindows[0]->GetResolution().W - 1);
+	std::uniform_int_distribution<int> RandomY(0, (int)Graphics::voWindows[0]->GetResolution().H - 1);
+
+	const Uint32 uiWindow = SDL_GetWindowID(Graphics::voWindows[0]->GetWindow());
+	bool bKeyDown = false;
+	bool bButtonDown = false;
+
+	while (m_bFeeding.load(std::memory_order_relaxed))
+	{
+		SDL_Event sdlEvent;
+		SDL_zero(sdlEvent);
+
+		switch (RandomKind(Random))
+		{
+		case 0:
+			bKeyDown = !bKeyDown;
+			sdlEvent.type = bKeyDown ? SDL_KEYDOWN : SDL_KEYUP;
+			sdlEvent.key.windowID = uiWindow;
+			sdlEvent.key.state = bKeyDown ? SDL_PRESSED : SDL_RELEASED;
+			sdlEvent.key.keysym.scancode = SDL_SCANCODE_SPACE;
+			sdlEvent.key.keysym.sym = SDLK_SPACE;
+			break;
+		case 1:
+			bButtonDown = !bButtonDown;
+			sdlEvent.type = bButtonDown ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+			sdlEvent.button.windowID = uiWindow;
+			sdlEvent.button.button = SDL_BUTTON_LEFT;
+			sdlEvent.button.state = bButtonDown ? SDL_PRESSED : SDL_RELEASED;
+			sdlEvent.button.x = RandomX(Random);
+			sdlEvent.button.y = RandomY(Random);
+			break;
+		case 2:
+			sdlEvent.type = SDL_MOUSEMOTION;
+			sdlEvent.motion.windowID = uiWindow;
+			sdlEvent.motion.x = RandomX(Random);
+			sdlEvent.motion.y = RandomY(Random);
+			break;
+		default:
+			sdlEvent.type = SDL_MOUSEWHEEL;
+			sdlEvent.wheel.windowID = uiWindow;
+			sdlEvent.wheel.y = RandomKind(Random) < 2 ? 1 : -1;
+			break;
+		}
+
+		SDL_PushEvent(&sdlEvent);
+		std::this_thread::sleep_for(std::chrono::milliseconds(RandomInterval(Random)));
+	}
+}
+
+void LatencyRun::Report() const
+{
+	// 'gpu' times are only kept while 'Latency' waits for the GPU or the present threads do
+	printf("Latency: %u frames after warming up, input to flip and to GPU finish\n", m_uiFrames > kuiWarmUpFrames ? m_uiFrames - kuiWarmUpFrames : 0);
+	for (unsigned int i = 0; i < Latency::KIND_COUNT; ++i)
+	{
+		const Latency::EventKind eKind = (Latency::EventKind)i;
+		PrintStats(Latency::GetKindName(eKind), "flip", Latency::GetStats(eKind, Latency::STAGE_FLIP));
+		PrintStats(Latency::GetKindName(eKind), "gpu", Latency::GetStats(eKind, Latency::STAGE_GPU));
+	}
+	PrintStats("all", "flip", Latency::GetStats(Latency::STAGE_FLIP));
+	PrintStats("all", "gpu", Latency::GetStats(Latency::STAGE_GPU));
+
+	if (m_Settings.szOut == nullptr)
+		return;
+
+	FILE* pFile = fopen(m_Settings.szOut, "w");
+	if (pFile == NULL)
+	{
+		printf("Latency: Could not open '%s' for writing\n", m_Settings.szOut);
+		return;
+	}
+
+	fprintf(pFile, "{\n  \"scenario\": \"latency\",\n  \"seed\": %u,\n  \"frames\": %u,\n  \"unthrottled\": %s,\n  \"gpu_wait\": %s,\n  \"input_thread\": %s,\n  \"events\": {\n",
+		m_Settings.uiSeed, m_uiFrames > kuiWarmUpFrames ? m_uiFrames - kuiWarmUpFrames : 0, m_Settings.bUnthrottled ? "true" : "false",
+		m_Settings.bGpuWait ? "true" : "false", Input::IsThreaded() ? "true" : "false");
+
+	for (unsigned int i = 0; i <= Latency::KIND_COUNT; ++i)
+	{
+		// The last entry is every kind together
+		const bool bAll = i == Latency::KIND_COUNT;
+		const Latency::EventKind eKind = (Latency::EventKind)i;
+
+		fprintf(pFile, "    \"%s\": { ", bAll ? "all" : Latency::GetKindName(eKind));
+		WriteStats(pFile, "flip", bAll ? Latency::GetStats(Latency::STAGE_FLIP) : Latency::GetStats(eKind, Latency::STAGE_FLIP));
+		fprintf(pFile, ", ");
+		WriteStats(pFile, "gpu", bAll ? Latency::GetStats(Latency::STAGE_GPU) : Latency::GetStats(eKind, Latency::STAGE_GPU));
+		fprintf(pFile, " }%s\n", bAll ? "" : ",");
+	}
+	fprintf(pFile, "  }\n}\n");
+
+	fclose(pFile);
+}
+
+LatencyRun::LatencyRun(const Settings& ac_Settings) : m_Settings(ac_Settings), m_bFeeding(true)
+{
+	m_uiFrames = 0;
+	m_Cursor = { 0, 0 };
+	m_iSize = 50;
+	m_bHighlight = false;
+
+	if (m_Settings.bUnthrottled)
+		SDL_GL_SetSwapInterval(0);
+	if (m_Settings.bHeadless)
+		SDL_HideWindow(Graphics::voWindows[0]->GetWindow());
+
+	Latency::SetEnabled(true);
+	Latency::SetGpuWait(m_Settings.bGpuWait);
+	Latency::Reset();
+
+	m_Feeder = std::thread(&LatencyRun::Feed, this);
+}
+LatencyRun::~LatencyRun()
+{
+	m_bFeeding.store(false, std::memory_order_relaxed);
+	m_Feeder.join();
+
+	Latency::SetGpuWait(false);
+}
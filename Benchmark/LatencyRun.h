@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////
+// File: LatencyRun.h
+// Author: Ben Odom
+// Brief: Measures input to present latency without anyone
+//		  at the keyboard. A thread pushes key, mouse button,
+//		  mouse motion and wheel events into SDL's queue at
+//		  random intervals while a small scene follows them
+//		  through 'GameLoop', and the percentiles 'Latency'
+//		  kept for each kind of event are reported at the end
+//////////////////////////////////////////////////////////////
+
+#ifndef _LATENCYRUN_H_
+#define _LATENCYRUN_H_
+
+#include "GameLoop.h"
+
+#include <atomic>
+#include <thread>
+
+class LatencyRun : public GameLoop
+{
+public:
+	struct Settings
+	{
+		unsigned int uiFrames; // Frames to run for, not counting the warm up
+		unsigned int uiSeed;   // The same seed always pushes the same events at the same intervals
+		bool bHeadless;		   // Hides the window while running
+		bool bUnthrottled;	   // Doesn't wait for vsync, so frames run as fast as they can be drawn
+		bool bGpuWait;		   // Also times each event until the GPU has finished its frame. See 'Latency::SetGpuWait'
+		const char* szOut;	   // Where to write the JSON result, or nullptr for the console only
+	};
+
+	// - The settings used when none are given: seed 1, 600 frames, throttled and not waiting for the GPU
+	static Settings DefaultSettings();
+
+	// - Prints the percentiles of every kind of event and writes them to 'Settings::szOut'. Call after 'Loop' returns
+	void Report() const;
+
+	void Update() override;
+	void Draw() override;
+
+	void OnKeyDown(const SDL_Keycode ac_sdlSym, const Uint16 ac_uiMod, const SDL_Scancode ac_sdlScancode) override;
+
+	LatencyRun(const Settings& ac_Settings);
+	~LatencyRun();
+
+private:
+	// - Pushes events until 'm_bFeeding' is cleared. Runs on 'm_Feeder'
+	void Feed();
+
+	Settings m_Settings;
+
+	std::thread m_Feeder;
+	std::atomic<bool> m_bFeeding;
+
+	unsigned int m_uiFrames;
+
+	// What the scene shows, driven only by the events pushed
+	System::Point2D<int> m_Cursor;
+	int m_iSize;
+	bool m_bHighlight;
+};
+
+#endif // _LATENCYRUN_H_
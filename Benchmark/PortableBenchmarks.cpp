@@ -0,0 +1,345 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'snprintf' with Visual Studio's SDL checks turned on
+
+#include "Benchmark.h"
+
+#include "AssetPack.h"
+#include "PixelConvert.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+// Nothing here draws, uploads or needs a window, so these also build on their own for platforms the library doesn't
+namespace
+{
+	std::mt19937 Random(1234); // Fixed seed, so every run converts and hashes the same pixels
+
+	// - Creates a 'ac_iWidth' by 'ac_iHeight' surface of 'ac_uiFormat' filled with noise, palette included, so no conversion can take a shortcut
+	SDL_Surface* NewNoiseSurface(const Uint32 ac_uiFormat, const int ac_iWidth, const int ac_iHeight)
+	{
+		int iBits;
+		Uint32 uiRed, uiGreen, uiBlue, uiAlpha;
+		SDL_PixelFormatEnumToMasks(ac_uiFormat, &iBits, &uiRed, &uiGreen, &uiBlue, &uiAlpha);
+
+		SDL_Surface* sdlSurface = SDL_CreateRGBSurface(0, ac_iWidth, ac_iHeight, iBits, uiRed, uiGreen, uiBlue, uiAlpha);
+		for (int iRow = 0; iRow < ac_iHeight; ++iRow)
+		{
+			Uint8* pRow = (Uint8*)sdlSurface->pixels + iRow * sdlSurface->pitch;
+			for (int i = 0; i < ac_iWidth * sdlSurface->format->BytesPerPixel; ++i)
+				pRow[i] = (Uint8)Random();
+		}
+		if (sdlSurface->format->palette != nullptr)
+		{
+			SDL_Color aColors[256];
+			for (unsigned int i = 0; i < 256; ++i)
+				aColors[i] = { (Uint8)Random(), (Uint8)Random(), (Uint8)Random(), (Uint8)Random() };
+			SDL_SetPaletteColors(sdlSurface->format->palette, aColors, 0, 256);
+		}
+
+		return sdlSurface;
+	}
+
+	/* - Converts surfaces of 'ac_uiFormat' a few odd widths wide through 'ConvertToRGBA', with and without premultiplying, and
+	   checks every pixel against what 'SDL_ConvertSurfaceFormat' gives. Odd widths leave each SIMD loop a tail to finish a pixel
+	   at a time, and put the 16 byte reads of the last pixels of a row right against its end. Prints the first pixel that differs
+	*/
+	bool CheckConvert(const char* ac_szName, const Uint32 ac_uiFormat)
+	{
+		const int kaiWidths[] = { 1, 3, 5, 7, 13, 17, 31, 33 };
+		const int kiHeight = 3;
+
+		for (unsigned int uiWidth = 0; uiWidth < sizeof(kaiWidths) / sizeof(kaiWidths[0]); ++uiWidth)
+		{
+			const int iWidth = kaiWidths[uiWidth];
+			SDL_Surface* sdlSource = NewNoiseSurface(ac_uiFormat, iWidth, kiHeight);
+			SDL_Surface* sdlExpected = SDL_ConvertSurfaceFormat(sdlSource, SDL_PIXELFORMAT_ABGR8888, 0);
+
+			std::vector<Uint8> vActual((size_t)iWidth * kiHeight * 4);
+			bool bMatched = true;
+			for (int iPremultiply = 0; bMatched && iPremultiply < 2; ++iPremultiply)
+			{
+				Graphics::ConvertToRGBA(*sdlSource, vActual.data(), iWidth * 4, iPremultiply == 1);
+
+				for (int iRow = 0; bMatched && iRow < kiHeight; ++iRow)
+				{
+					for (int i = 0; bMatched && i < iWidth; ++i)
+					{
+						Uint8 aExpected[4];
+						memcpy(aExpected, (const Uint8*)sdlExpected->pixels + iRow * sdlExpected->pitch + i * 4, 4);
+						if (iPremultiply == 1)
+						{
+							for (int iChannel = 0; iChannel < 3; ++iChannel)
+								aExpected[iChannel] = (Uint8)Graphics::PixelConvert::MultiplyAlpha(aExpected[iChannel], aExpected[3]);
+						}
+
+						const Uint8* pActual = &vActual[((size_t)iRow * iWidth + i) * 4];
+						if (memcmp(pActual, aExpected, 4) != 0)
+						{
+							printf("Convert/%s%s: %d wide, pixel %d of row %d is %02x%02x%02x%02x but SDL gives %02x%02x%02x%02x\n",
+								ac_szName, iPremultiply == 1 ? "/Premultiplied" : "", iWidth, i, iRow,
+								pActual[0], pActual[1], pActual[2], pActual[3], aExpected[0], aExpected[1], aExpected[2], aExpected[3]);
+							bMatched = false;
+						}
+					}
+				}
+			}
+
+			SDL_FreeSurface(sdlExpected);
+			SDL_FreeSurface(sdlSource);
+			if (!bMatched)
+				return false;
+		}
+		return true;
+	}
+
+	void BenchmarkConvert()
+	{
+		const int kiSize = 1024;
+		const unsigned int kuiPixels = kiSize * kiSize;
+
+		// The formats images most often decode to
+		struct Source
+		{
+			const char* szName;
+			Uint32 uiFormat;
+		};
+		const Source aSources[] = {
+			{ "RGB24", SDL_PIXELFORMAT_RGB24 },
+			{ "BGR24", SDL_PIXELFORMAT_BGR24 },
+			{ "BGRA", SDL_PIXELFORMAT_ARGB8888 },
+			{ "RGBA", SDL_PIXELFORMAT_ABGR8888 },
+			{ "Indexed", SDL_PIXELFORMAT_INDEX8 },
+		};
+
+		std::vector<Uint8> vDestination(kuiPixels * 4);
+		for (unsigned int uiSource = 0; uiSource < sizeof(aSources) / sizeof(aSources[0]); ++uiSource)
+		{
+			// How fast a conversion that gets pixels wrong is says nothing, so it isn't timed
+			if (!CheckConvert(aSources[uiSource].szName, aSources[uiSource].uiFormat))
+			{
+				printf("Convert/%s: Skipped, it doesn't match SDL\n", aSources[uiSource].szName);
+				continue;
+			}
+
+			SDL_Surface* sdlSource = NewNoiseSurface(aSources[uiSource].uiFormat, kiSize, kiSize);
+
+			const std::string sName = std::string("Convert/") + aSources[uiSource].szName;
+			Benchmark::Run((sName + "/SDL").c_str(), kuiPixels, [&]()
+			{
+				SDL_Surface* sdlConverted = SDL_ConvertSurfaceFormat(sdlSource, SDL_PIXELFORMAT_ABGR8888, 0);
+				Benchmark::Consume(((const Uint8*)sdlConverted->pixels)[0]);
+				SDL_FreeSurface(sdlConverted);
+			});
+			Benchmark::Run(sName.c_str(), kuiPixels, [&]()
+			{
+				Graphics::ConvertToRGBA(*sdlSource, vDestination.data(), kiSize * 4, false);
+				Benchmark::Consume(vDestination[0]);
+			});
+			Benchmark::Run((sName + "/Premultiplied").c_str(), kuiPixels, [&]()
+			{
+				Graphics::ConvertToRGBA(*sdlSource, vDestination.data(), kiSize * 4, true);
+				Benchmark::Consume(vDestination[0]);
+			});
+
+			SDL_FreeSurface(sdlSource);
+		}
+	}
+
+	void BenchmarkMipmaps()
+	{
+		const System::Size2D<int> Size = { 1024, 1024 };
+
+		std::vector<Uint8> vPixels(Size.W * Size.H * 4);
+		for (unsigned int i = 0; i < vPixels.size(); ++i)
+			vPixels[i] = (Uint8)Random();
+
+		// Per pixel of level 0, so it compares directly with the 'Convert' benchmarks
+		Graphics::Mipmap::Chain chain;
+		Benchmark::Run("Mipmap/Build/1024", Size.W * Size.H, [&]()
+		{
+			Graphics::Mipmap::Build(vPixels.data(), Size, Size.W * 4, chain);
+			Benchmark::Consume(chain.vPixels.back());
+		});
+	}
+
+	void BenchmarkHashing()
+	{
+		const int kiSize = 256;
+
+		// Per pixel, since every surface loaded from memory is hashed in full to find out if its texture is already uploaded
+		SDL_Surface* sdlSurface = NewNoiseSurface(SDL_PIXELFORMAT_ABGR8888, kiSize, kiSize);
+		Benchmark::Run("TextureCache/HashSurface/256", kiSize * kiSize, [&]()
+		{
+			Benchmark::Consume((double)Graphics::TextureCache::HashSurface(*sdlSurface, false).size());
+		});
+		SDL_FreeSurface(sdlSurface);
+
+		const unsigned int kuiPaths = 10000;
+		Benchmark::Run("TextureCache/NormalizePath", kuiPaths, []()
+		{
+			for (unsigned int i = 0; i < kuiPaths; ++i)
+				Benchmark::Consume((double)Graphics::TextureCache::NormalizePath("Assets\\Sprites/../Sprites/./Bunny.png").size());
+		});
+	}
+
+	// - Lays out a pack in memory the way 'AssetPacker' writes one, holding 'ac_uiImages' small images named after their index
+	void BuildPack(const unsigned int ac_uiImages, std::vector<std::string>& a_vNames, std::vector<Uint64>& a_vPack)
+	{
+		using namespace Graphics::AssetPack;
+
+		const Uint32 kuiSize = 8;
+
+		a_vNames.resize(ac_uiImages);
+		for (unsigned int i = 0; i < ac_uiImages; ++i)
+			a_vNames[i] = PackName("sprites/image_" + std::to_string(i) + ".png");
+
+		// At most half the slots are used, as the packer does
+		Uint32 uiSlots = 16;
+		while (uiSlots < ac_uiImages * 2)
+			uiSlots *= 2;
+
+		std::vector<Uint64> vNameOffsets(ac_uiImages);
+		Uint64 ullOffset = sizeof(PackHeader) + (Uint64)uiSlots * sizeof(PackEntry);
+		for (unsigned int i = 0; i < ac_uiImages; ++i)
+		{
+			vNameOffsets[i] = ullOffset;
+			ullOffset += a_vNames[i].size();
+		}
+		const Uint64 ullPixels = (ullOffset + kuiPackAlignment - 1) & ~(Uint64)(kuiPackAlignment - 1);
+		const Uint64 ullFileSize = ullPixels + (Uint64)ac_uiImages * kuiSize * kuiSize * 4;
+
+		// Held in 'Uint64's so the header and slots are aligned for the reads 'Find' makes of them
+		a_vPack.assign((size_t)((ullFileSize + 7) / 8), 0);
+		Uint8* pData = (Uint8*)a_vPack.data();
+
+		PackHeader& header = *(PackHeader*)pData;
+		memcpy(header.aMagic, kaMagic, sizeof(kaMagic));
+		header.uiVersion = kuiVersion;
+		header.uiSlots = uiSlots;
+		header.uiEntries = ac_uiImages;
+		header.ullFileSize = ullFileSize;
+
+		PackEntry* pSlots = (PackEntry*)(pData + sizeof(PackHeader));
+		for (unsigned int i = 0; i < ac_uiImages; ++i)
+		{
+			memcpy(pData + vNameOffsets[i], a_vNames[i].data(), a_vNames[i].size());
+
+			const Uint64 ullHash = Hash(a_vNames[i]);
+			Uint32 uiSlot = (Uint32)(ullHash & (uiSlots - 1));
+			while (pSlots[uiSlot].ullOffset != 0)
+				uiSlot = (uiSlot + 1) & (uiSlots - 1);
+
+			PackEntry& entry = pSlots[uiSlot];
+			entry.ullHash = ullHash;
+			entry.ullOffset = ullPixels + (Uint64)i * kuiSize * kuiSize * 4;
+			entry.uiWidth = kuiSize;
+			entry.uiHeight = kuiSize;
+			entry.uiFormat = FORMAT_RGBA8;
+			entry.uiNameOffset = (Uint32)vNameOffsets[i];
+			entry.uiNameLength = (Uint32)a_vNames[i].size();
+		}
+	}
+
+	void BenchmarkAssetPack()
+	{
+		const unsigned int kuiImages = 1024;
+
+		std::vector<std::string> vNames;
+		std::vector<Uint64> vPack;
+		BuildPack(kuiImages, vNames, vPack);
+		const Uint64 ullSize = ((const Graphics::AssetPack::PackHeader*)vPack.data())->ullFileSize;
+		if (!Graphics::AssetPack::Register(vPack.data(), ullSize))
+			return;
+
+		// Names every image in the pack, then names nothing it holds, which has to probe until an empty slot
+		const std::string sCount = "/" + std::to_string(kuiImages);
+		Benchmark::Run(("AssetPack/Find" + sCount).c_str(), kuiImages, [&]()
+		{
+			Graphics::AssetPack::PackedImage image;
+			for (unsigned int i = 0; i < kuiImages; ++i)
+				Benchmark::Consume(Graphics::AssetPack::Find(vNames[i], image) ? image.Size.W : 0);
+		});
+		std::vector<std::string> vMissing(kuiImages);
+		for (unsigned int i = 0; i < kuiImages; ++i)
+			vMissing[i] = vNames[i] + ".missing";
+		Benchmark::Run(("AssetPack/Find/Missing" + sCount).c_str(), kuiImages, [&]()
+		{
+			Graphics::AssetPack::PackedImage image;
+			for (unsigned int i = 0; i < kuiImages; ++i)
+				Benchmark::Consume(Graphics::AssetPack::Find(vMissing[i], image) ? image.Size.W : 0);
+		});
+
+		Graphics::AssetPack::Unregister(vPack.data());
+	}
+
+	void BenchmarkSystem()
+	{
+		const unsigned int kuiOperations = 1000000;
+
+		Benchmark::Run("Point2D+Point2D", kuiOperations, []()
+		{
+			System::Point2D<float> Sum = { 0, 0 };
+			const System::Point2D<float> Step = { 0.5f, 0.25f };
+			for (unsigned int i = 0; i < kuiOperations; ++i)
+				Sum = Sum + Step;
+			Benchmark::Consume(Sum.X + Sum.Y);
+		});
+		Benchmark::Run("Point2D-Point2D", kuiOperations, []()
+		{
+			System::Point2D<float> Sum = { 0, 0 };
+			const System::Point2D<float> Step = { 0.5f, 0.25f };
+			for (unsigned int i = 0; i < kuiOperations; ++i)
+				Sum = Sum - Step;
+			Benchmark::Consume(Sum.X + Sum.Y);
+		});
+		Benchmark::Run("-Point2D", kuiOperations, []()
+		{
+			System::Point2D<float> Point = { 1, 2 };
+			for (unsigned int i = 0; i < kuiOperations; ++i)
+				Point = -Point;
+			Benchmark::Consume(Point.X + Point.Y);
+		});
+		Benchmark::Run("Point2D/Point2D", kuiOperations, []()
+		{
+			System::Point2D<float> Point = { 1e30f, 1e30f };
+			const System::Point2D<float> Divisor = { 1.0001f, 1.0002f };
+			for (unsigned int i = 0; i < kuiOperations; ++i)
+				Point = Point / Divisor;
+			Benchmark::Consume(Point.X + Point.Y);
+		});
+		Benchmark::Run("Point2D/int", kuiOperations, []()
+		{
+			System::Point2D<int> Point = { 0, 0 };
+			for (unsigned int i = 0; i < kuiOperations; ++i)
+				Point = System::Point2D<int>{ (int)i, (int)i * 3 } / 2;
+			Benchmark::Consume(Point.X + Point.Y);
+		});
+		Benchmark::Run("Point2D+Size2D", kuiOperations, []()
+		{
+			System::Point2D<float> Sum = { 0, 0 };
+			const System::Size2D<float> Step = { 0.5f, 0.25f };
+			for (unsigned int i = 0; i < kuiOperations; ++i)
+				Sum = Sum + Step;
+			Benchmark::Consume(Sum.X + Sum.Y);
+		});
+		Benchmark::Run("Point2D+=AngularVel", kuiOperations, []()
+		{
+			System::Point2D<float> Point = { 0, 0 };
+			const System::AngularVel<float> Velocity = { 1.0f, 45.0f };
+			for (unsigned int i = 0; i < kuiOperations; ++i)
+				Point += Velocity;
+			Benchmark::Consume(Point.X + Point.Y);
+		});
+	}
+}
+
+void Benchmark::RunPortableBenchmarks()
+{
+	BenchmarkSystem();
+
+	BenchmarkConvert();
+	BenchmarkMipmaps();
+	BenchmarkHashing();
+	BenchmarkAssetPack();
+}
@@ -0,0 +1,46 @@
+//////////////////////////////////////////////////////////////
+// Project: Portable Graphics Benchmarks
+// Author: Ben Odom
+// Usage: PortableBenchmark [--out results.json] [--samples 50]
+//						   [--label name]
+//		  Runs the benchmarks that need neither a window nor
+//		  the prebuilt library, so they can be built with
+//		  CMake and compared on platforms other than Windows.
+//		  Results are the same JSON 'Benchmark.exe' writes
+//////////////////////////////////////////////////////////////
+
+#define SDL_MAIN_HANDLED // The benchmarks need 'argc' and 'argv' rather than 'wmain'
+
+#include "Benchmark.h"
+
+#include <SDL.h>
+
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char* argv[])
+{
+	const char* szOut = nullptr;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+			szOut = argv[++i];
+		else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+			Benchmark::SetSamples((unsigned int)atoi(argv[++i]));
+		else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc)
+			Benchmark::SetLabel(argv[++i]);
+	}
+
+	// No subsystems are needed, only the timer and surfaces every build of SDL has
+	SDL_SetMainReady();
+	SDL_Init(0);
+
+	Benchmark::RunPortableBenchmarks();
+
+	const bool bWritten = Benchmark::WriteJSON(szOut);
+
+	SDL_Quit();
+
+	return bWritten ? 0 : 1;
+}
@@ -0,0 +1,375 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'snprintf' with Visual Studio's SDL checks turned on
+
+#include "RenderCheck.h"
+
+#include "RenderPass.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	const unsigned int kuiSurfaces = 300; // Drawn through each camera
+	const float kfDepthTolerance = 0.01f; // Far closer than the depths two surfaces are given, far looser than a 16 bit buffer rounds
+
+	// Camera objects keep a pointer to the point they are anchored to, so it has to outlive them
+	const System::Point2D<float> RelativePos = { 0, 0 };
+	const System::Point2D<int> RelativePosInt = { 0, 0 };
+
+	// One way of setting up the camera the surfaces are drawn through
+	struct CameraCase
+	{
+		const char* szName;
+		bool bInt;
+		System::Point2D<float> WorldPos;
+		System::Size2D<float> Zoom;
+		float fRotation;
+	};
+	const CameraCase aCameraCases[] =
+	{
+		{ "plain",		   false, { 0, 0 },		 { 1, 1 },		 0 },
+		{ "moved",		   false, { 300, -200 }, { 1, 1 },		 0 },
+		{ "zoomed in",	   false, { 100, 50 },	 { 2, 2 },		 0 },
+		{ "zoomed out",	   false, { 0, 0 },		 { 0.5f, 0.5f }, 0 },
+		{ "stretched",	   false, { -80, 40 },	 { 2, 0.5f },	 0 },
+		{ "rotated",	   false, { 50, 50 },	 { 1, 1 },		 30 },
+		{ "rotated zoomed", false, { 0, 0 },	 { 1.5f, 1.5f }, -70 },
+		{ "int",		   true,  { 120, -40 },	 { 2, 2 },		 0 }
+	};
+
+	std::mt19937 Random(1234); // Fixed seed, so a failure can be run again
+	std::vector<GLubyte> vPixels;
+
+	Graphics::SurfaceUnion* FindUnion(const void* ac_pSurface)
+	{
+		for (unsigned int i = 0; i < Graphics::vglSurfaces.size(); ++i)
+		{
+			const Graphics::SurfaceUnion* pUnion = Graphics::vglSurfaces[i];
+			if ((pUnion->Tag == Graphics::SurfaceUnion::FLOAT ? (const void*)pUnion->fGLSurface : (const void*)pUnion->iGLSurface) == ac_pSurface)
+				return Graphics::vglSurfaces[i];
+		}
+		return nullptr;
+	}
+
+	void ReleaseCameras()
+	{
+		for (unsigned int i = 0; i < Graphics::voCameras.size(); ++i)
+		{
+			if (Graphics::voCameras[i]->Tag == Graphics::CameraUnion::FLOAT)
+				delete Graphics::voCameras[i]->fCamera;
+			else
+				delete Graphics::voCameras[i]->iCamera;
+			delete Graphics::voCameras[i];
+		}
+		Graphics::voCameras.clear();
+	}
+
+	void ReleaseSurfaces()
+	{
+		for (unsigned int i = 0; i < Graphics::vglSurfaces.size(); ++i)
+		{
+			Graphics::SurfaceUnion* pUnion = Graphics::vglSurfaces[i];
+			if (pUnion->Tag == Graphics::SurfaceUnion::FLOAT)
+			{
+				Graphics::TextureCache::Release(pUnion->fGLSurface->Surface);
+				delete pUnion->fGLSurface;
+			}
+			else
+			{
+				Graphics::TextureCache::Release(pUnion->iGLSurface->Surface);
+				delete pUnion->iGLSurface;
+			}
+			delete pUnion;
+		}
+		Graphics::vglSurfaces.clear();
+
+		Graphics::GLState::InvalidateAll();
+	}
+
+	// - Loads a solid surface of one color
+	Graphics::GLSurface<float>* LoadSolid(const Uint8 ac_uiRed, const Uint8 ac_uiGreen, const Uint8 ac_uiBlue)
+	{
+		SDL_Surface* sdlSurface = SDL_CreateRGBSurface(0, 32, 32, 32, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+		SDL_FillRect(sdlSurface, NULL, SDL_MapRGBA(sdlSurface->format, ac_uiRed, ac_uiGreen, ac_uiBlue, 255));
+
+		return Graphics::LoadSurface<float>(*sdlSurface);
+	}
+
+	// - Replaces every camera with one set up the way 'ac_Case' says, over the top left quarter of the window
+	void SetCamera(const CameraCase& ac_Case)
+	{
+		ReleaseCameras();
+
+		if (ac_Case.bInt)
+		{
+			Graphics::NewCamera<int>({ 0, 0 }, { (int)ac_Case.WorldPos.X, (int)ac_Case.WorldPos.Y }, RelativePosInt, { 50, 50 },
+				{ (int)ac_Case.Zoom.W, (int)ac_Case.Zoom.H }, (int)ac_Case.fRotation);
+		}
+		else
+		{
+			Graphics::NewCamera<float>({ 0, 0 }, ac_Case.WorldPos, RelativePos, { 50, 50 }, ac_Case.Zoom, ac_Case.fRotation);
+		}
+	}
+
+	// - Counts the pixels of the camera's part of the window that aren't the black it was cleared to
+	unsigned int CountDrawn()
+	{
+		GLint iX, iY, iW, iH;
+		if (Graphics::voCameras[0]->Tag == Graphics::CameraUnion::INT)
+		{
+			Graphics::Camera<int>& camera = *Graphics::voCameras[0]->iCamera;
+			iX = camera.GetScreenPos().X, iY = camera.GetScreenPos().Y, iW = camera.GetDimensions().W, iH = camera.GetDimensions().H;
+		}
+		else
+		{
+			Graphics::Camera<float>& camera = *Graphics::voCameras[0]->fCamera;
+			iX = (GLint)camera.GetScreenPos().X, iY = (GLint)camera.GetScreenPos().Y, iW = (GLint)camera.GetDimensions().W, iH = (GLint)camera.GetDimensions().H;
+		}
+
+		vPixels.resize((size_t)iW * iH * 4);
+		glReadPixels(iX, iY, iW, iH, GL_RGBA, GL_UNSIGNED_BYTE, &vPixels[0]);
+
+		unsigned int uiDrawn = 0;
+		for (size_t i = 0; i < vPixels.size(); i += 4)
+		{
+			if (vPixels[i] != 0 || vPixels[i + 1] != 0 || vPixels[i + 2] != 0)
+				++uiDrawn;
+		}
+		return uiDrawn;
+	}
+
+	// - Draws the frame's surfaces through every camera into a window cleared to black, counting what is drawn from scratch
+	void DrawFrame()
+	{
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		Graphics::EndFrameStats(); // Whatever was counted before belongs to another frame
+		Graphics::DrawCameras();
+		Graphics::EndFrameStats();
+	}
+
+	// - Puts a surface somewhere in or around the camera, at a random size, scale, pivot and rotation
+	template <typename T>
+	void Randomize(Graphics::GLSurface<T>& a_Surface)
+	{
+		std::uniform_real_distribution<float> RandomX(-1500.0f, 2500.0f);
+		std::uniform_real_distribution<float> RandomY(-1200.0f, 2000.0f);
+		std::uniform_real_distribution<float> RandomSize(4.0f, 256.0f);
+		std::uniform_real_distribution<float> RandomScale(0.25f, 3.0f);
+		std::uniform_real_distribution<float> RandomAngle(-180.0f, 180.0f);
+		std::uniform_real_distribution<float> RandomPivot(-0.5f, 0.5f);
+		std::uniform_int_distribution<int> RandomChance(0, 99);
+
+		a_Surface.Pos = { (T)RandomX(Random), (T)RandomY(Random) };
+		a_Surface.Dimensions = { (T)RandomSize(Random), (T)RandomSize(Random) };
+
+		// Usually the texture is drawn whole, but 'OffsetD' and 'OffsetP' can differ from it, so those are tried as well
+		a_Surface.OffsetD = RandomChance(Random) < 50 ? a_Surface.Dimensions : System::Size2D<T>{ (T)RandomSize(Random), (T)RandomSize(Random) };
+		a_Surface.OffsetP = RandomChance(Random) < 80 ? System::Point2D<T>{ 0, 0 } : System::Point2D<T>{ (T)(RandomSize(Random) / 16), (T)(RandomSize(Random) / 16) };
+
+		a_Surface.Center = { (T)(a_Surface.Dimensions.W * (0.5f + RandomPivot(Random))), (T)(a_Surface.Dimensions.H * (0.5f + RandomPivot(Random))) };
+		a_Surface.Scale = RandomChance(Random) < 30 ? System::Size2D<T>{ 1, 1 } : System::Size2D<T>{ (T)RandomScale(Random), (T)RandomScale(Random) };
+		a_Surface.Rotation = RandomChance(Random) < 50 ? (T)0 : (T)RandomAngle(Random);
+
+		a_Surface.Color = { 255, 255, 255, 255 };
+		a_Surface.uiWorldSpace = RandomChance(Random) < 10 ? 1 : 0;
+		a_Surface.bIsActive = RandomChance(Random) >= 5;
+
+		// An int surface can't be scaled by less than one without disappearing
+		if (a_Surface.Scale.W == 0 || a_Surface.Scale.H == 0)
+			a_Surface.Scale = { 1, 1 };
+	}
+
+	template <typename T>
+	void Describe(const Graphics::GLSurface<T>& ac_Surface, char* a_szOut, const size_t ac_uiSize)
+	{
+		snprintf(a_szOut, ac_uiSize, "pos %.1f,%.1f size %.1fx%.1f offset %.1fx%.1f at %.1f,%.1f center %.1f,%.1f scale %.2f,%.2f rotation %.1f world %u active %d",
+			(double)ac_Surface.Pos.X, (double)ac_Surface.Pos.Y, (double)ac_Surface.Dimensions.W, (double)ac_Surface.Dimensions.H,
+			(double)ac_Surface.OffsetD.W, (double)ac_Surface.OffsetD.H, (double)ac_Surface.OffsetP.X, (double)ac_Surface.OffsetP.Y,
+			(double)ac_Surface.Center.X, (double)ac_Surface.Center.Y, (double)ac_Surface.Scale.W, (double)ac_Surface.Scale.H,
+			(double)ac_Surface.Rotation, ac_Surface.uiWorldSpace, ac_Surface.bIsActive ? 1 : 0);
+	}
+
+	// - Runs the check for one camera, with the one surface of its type active. Returns how many mismatches there were
+	template <typename T>
+	unsigned int CheckCamera(const CameraCase& ac_Case, Graphics::GLSurface<T>& a_Surface, const Graphics::SurfaceUnion& ac_Union)
+	{
+		unsigned int uiFailures = 0;
+		unsigned int uiDrawn = 0;
+		unsigned int uiLoose = 0;
+		char szSurface[256];
+
+		for (unsigned int i = 0; i < kuiSurfaces; ++i)
+		{
+			Randomize(a_Surface);
+			Describe(a_Surface, szSurface, sizeof(szSurface));
+
+			Graphics::SetCulling(false);
+			DrawFrame();
+			const unsigned int uiPixels = CountDrawn();
+			const bool bKept = Graphics::IsSurfaceInCamera(ac_Union, 0);
+
+			// Keeping a surface that draws nothing only costs time, but culling one that draws something loses it
+			if (uiPixels != 0)
+				++uiDrawn;
+			if (uiPixels != 0 && !bKept)
+			{
+				printf("RenderCheck: '%s' camera culled a surface 'DrawSurface' drew %u pixels of, %s\n", ac_Case.szName, uiPixels, szSurface);
+				++uiFailures;
+			}
+			else if (uiPixels == 0 && bKept)
+			{
+				++uiLoose;
+			}
+
+			Graphics::SetCulling(true);
+			DrawFrame();
+
+			const Graphics::FrameStats& stats = Graphics::GetFrameStats();
+			const bool bInWorld = a_Surface.bIsActive && a_Surface.uiWorldSpace == 0;
+			const unsigned int uiSubmitted = bKept ? 1 : 0;
+			const unsigned int uiCulled = bInWorld && !bKept ? 1 : 0;
+			if (stats.uiSurfacesSubmitted[0] != uiSubmitted || stats.uiSurfacesCulled[0] != uiCulled)
+			{
+				printf("RenderCheck: '%s' camera counted %u drawn and %u culled instead of %u and %u, %s\n", ac_Case.szName,
+					stats.uiSurfacesSubmitted[0], stats.uiSurfacesCulled[0], uiSubmitted, uiCulled, szSurface);
+				++uiFailures;
+			}
+		}
+
+		printf("RenderCheck: '%s' camera, %u of %u surfaces drawn, %u kept that drew nothing, %u mismatches\n", ac_Case.szName, uiDrawn, kuiSurfaces, uiLoose, uiFailures);
+		return uiFailures;
+	}
+}
+
+bool RenderCheck::CheckCulling()
+{
+	// Solid white, so any pixel of it shows up against the black the window is cleared to
+	SDL_Surface* sdlFloat = SDL_CreateRGBSurface(0, 32, 32, 32, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+	SDL_FillRect(sdlFloat, NULL, 0xFFFFFFFF);
+	SDL_Surface* sdlInt = SDL_ConvertSurface(sdlFloat, sdlFloat->format, 0);
+
+	Graphics::GLSurface<float>* pFloat = Graphics::LoadSurface<float>(*sdlFloat);
+	Graphics::GLSurface<int>* pInt = Graphics::LoadSurface<int>(*sdlInt);
+	if (pFloat == nullptr || pInt == nullptr)
+	{
+		printf("RenderCheck: Could not load the surfaces to draw\n");
+		return false;
+	}
+
+	unsigned int uiFailures = 0;
+	for (unsigned int i = 0; i < sizeof(aCameraCases) / sizeof(aCameraCases[0]); ++i)
+	{
+		const CameraCase& cameraCase = aCameraCases[i];
+		SetCamera(cameraCase);
+
+		// Only one surface is active at a time, so whatever is read back was drawn by it
+		if (cameraCase.bInt)
+		{
+			pFloat->bIsActive = false;
+			uiFailures += CheckCamera(cameraCase, *pInt, *FindUnion(pInt));
+			pInt->bIsActive = false;
+		}
+		else
+		{
+			pInt->bIsActive = false;
+			uiFailures += CheckCamera(cameraCase, *pFloat, *FindUnion(pFloat));
+			pFloat->bIsActive = false;
+		}
+	}
+
+	ReleaseCameras();
+	ReleaseSurfaces();
+
+	printf("RenderCheck: culling %s\n", uiFailures == 0 ? "passed" : "FAILED");
+	return uiFailures == 0;
+}
+
+bool RenderCheck::CheckDepthPass()
+{
+	GLint iDepthBits = 0;
+	glGetIntegerv(GL_DEPTH_BITS, &iDepthBits);
+	if (iDepthBits == 0)
+	{
+		printf("RenderCheck: depth pass skipped, the window has no depth buffer\n");
+		return true;
+	}
+
+	// One camera over the whole window, so a pixel of the window is a unit of the world
+	ReleaseCameras();
+	Graphics::NewCamera<float>({ 0, 0 }, { 0, 0 }, RelativePos, { 100, 100 });
+
+	// The green one is later in painter's order, so it has to show where they overlap
+	Graphics::GLSurface<float>* pUnder = LoadSolid(255, 0, 0);
+	Graphics::GLSurface<float>* pOver = LoadSolid(0, 255, 0);
+	if (pUnder == nullptr || pOver == nullptr)
+	{
+		printf("RenderCheck: Could not load the surfaces to draw\n");
+		return false;
+	}
+	pUnder->Dimensions = pUnder->OffsetD = pOver->Dimensions = pOver->OffsetD = { 200, 200 };
+	pUnder->Center = pOver->Center = { 100, 100 };
+	pUnder->Pos = { 400, 450 };
+	pOver->Pos = { 500, 450 };
+	pUnder->Layer = Graphics::BACKGROUND;
+	pOver->Layer = Graphics::FOREGROUND;
+	std::sort(Graphics::vglSurfaces.begin(), Graphics::vglSurfaces.end(), Graphics::SortLayer);
+
+	const bool bWasDepthPass = Graphics::IsDepthPass();
+	Graphics::SetDepthPass(true);
+
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClearDepth(1.0);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	Graphics::DrawCameras();
+
+	/* With two surfaces 'DrawDepthPass' steps 2 / 3 along z from -1, so the red one is translated to z = -1 / 3 and the green one to 1 / 3
+	   'glOrtho' with a near of -1 and a far of 1 turns z into a depth of (1 - z) / 2. A library that reset the matrix would leave
+	   both at z = 0, a depth of 0.5
+	*/
+	const float afDepths[2] = { 2.0f / 3.0f, 1.0f / 3.0f };
+	const GLubyte aaColors[2][3] = { { 255, 0, 0 }, { 0, 255, 0 } };
+	const System::Size2D<unsigned int>& Resolution = Graphics::voWindows[0]->GetResolution();
+	const System::Size2D<unsigned int>& Dimensions = Graphics::voWindows[0]->GetDimensions();
+
+	// Where only the red one is, where they overlap, and where only the green one is
+	const float afWorldX[3] = { 350, 450, 550 };
+	const unsigned int auiExpected[3] = { 0, 1, 1 };
+
+	unsigned int uiFailures = 0;
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		const GLint iX = (GLint)(afWorldX[i] * Dimensions.W / Resolution.W);
+		const GLint iY = (GLint)(Dimensions.H / 2);
+
+		GLfloat fDepth = 0.0f;
+		GLubyte aColor[4] = { 0, 0, 0, 0 };
+		glReadPixels(iX, iY, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &fDepth);
+		glReadPixels(iX, iY, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, aColor);
+
+		const unsigned int uiSurface = auiExpected[i];
+		if (fabsf(fDepth - afDepths[uiSurface]) > kfDepthTolerance)
+		{
+			printf("RenderCheck: depth at %d,%d is %.3f instead of %.3f, so 'DrawSurface' didn't keep the model-view matrix it was given\n",
+				iX, iY, fDepth, afDepths[uiSurface]);
+			++uiFailures;
+		}
+		if (aColor[0] != aaColors[uiSurface][0] || aColor[1] != aaColors[uiSurface][1] || aColor[2] != aaColors[uiSurface][2])
+		{
+			printf("RenderCheck: color at %d,%d is %u,%u,%u instead of %u,%u,%u\n", iX, iY, aColor[0], aColor[1], aColor[2],
+				aaColors[uiSurface][0], aaColors[uiSurface][1], aaColors[uiSurface][2]);
+			++uiFailures;
+		}
+	}
+
+	Graphics::SetDepthPass(bWasDepthPass);
+	ReleaseCameras();
+	ReleaseSurfaces();
+
+	printf("RenderCheck: depth pass %s\n", uiFailures == 0 ? "passed" : "FAILED");
+	return uiFailures == 0;
+}
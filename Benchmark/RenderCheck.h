@@ -0,0 +1,32 @@
+//////////////////////////////////////////////////////////////
+// File: RenderCheck.h
+// Author: Ben Odom
+// Brief: Checks what 'DrawCameras' assumes about the prebuilt
+//		  'DrawSurface' against what it really draws. Surfaces
+//		  are drawn one at a time through cameras moved,
+//		  zoomed and rotated every way, and the window is read
+//		  back after each, so a library that places surfaces
+//		  differently fails here instead of losing sprites.
+//		  The window has to stay visible, since a hidden one
+//		  isn't guaranteed to keep what is drawn into it
+//////////////////////////////////////////////////////////////
+
+#ifndef _RENDERCHECK_H_
+#define _RENDERCHECK_H_
+
+namespace RenderCheck
+{
+	/* - Draws random surfaces one at a time with culling off and compares those that touched a pixel of the camera with those
+	   'IsSurfaceInCamera' keeps. Then draws each again with culling on and checks the frame stats count it as drawn or culled
+	   only when it is in the camera's world space. Prints every mismatch and returns false if there were any
+	*/
+	bool CheckCulling();
+	/* - Draws two overlapping opaque surfaces with the depth pass and reads back the depth and color where they overlap
+	   The depth pass carries each surface's depth through the model-view matrix, which only works while 'DrawSurface' keeps
+	   the matrix it is given. Returns false if the depths aren't the ones the pass set or the later surface isn't on top
+	   Passes without checking anything if the window has no depth buffer, since the depth pass is never used then
+	*/
+	bool CheckDepthPass();
+}
+
+#endif // _RENDERCHECK_H_
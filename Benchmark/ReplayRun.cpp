@@ -0,0 +1,91 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'fopen' with Visual Studio's SDL checks turned on
+
+#include "ReplayRun.h"
+
+#include "Replay.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+	// - Returns the time 'ac_dFraction' of the way through sorted frame times
+	double Percentile(const std::vector<double>& ac_vSorted, const double ac_dFraction)
+	{
+		if (ac_vSorted.empty())
+			return 0.0;
+
+		return ac_vSorted[std::min((size_t)(ac_dFraction * ac_vSorted.size()), ac_vSorted.size() - 1)];
+	}
+}
+
+bool ReplayRun::IsLoaded() const
+{
+	return m_bLoaded;
+}
+
+void ReplayRun::Update()
+{
+	const Uint64 uiNow = SDL_GetPerformanceCounter();
+	m_vMilliseconds.push_back((uiNow - m_uiLastFrame) * 1000.0 / SDL_GetPerformanceFrequency());
+	m_uiLastFrame = uiNow;
+
+	GameLoop::Update();
+
+	// The frame that reaches the end of the log is the last one played
+	if (!Replay::IsReplaying())
+		m_bRunning = false;
+}
+
+void ReplayRun::Report() const
+{
+	if (!m_bLoaded)
+		return;
+
+	std::vector<double> vSorted(m_vMilliseconds);
+	std::sort(vSorted.begin(), vSorted.end());
+
+	const double dTotal = (m_uiLastFrame - m_uiStart) * 1000.0 / SDL_GetPerformanceFrequency();
+	const double dAverage = vSorted.empty() ? 0.0 : dTotal / vSorted.size();
+	const bool bComplete = Replay::IsReplayFinished() && (unsigned int)vSorted.size() >= Replay::GetReplayFrames();
+
+	printf("Replay: %u of %u frames in %.1fms (average %.2fms, p50 %.2fms, p95 %.2fms, p99 %.2fms)%s\n",
+		(unsigned int)vSorted.size(), Replay::GetReplayFrames(), dTotal, dAverage,
+		Percentile(vSorted, 0.5), Percentile(vSorted, 0.95), Percentile(vSorted, 0.99), bComplete ? "" : " - stopped early");
+
+	if (m_Settings.szOut == nullptr)
+		return;
+
+	FILE* pFile = fopen(m_Settings.szOut, "w");
+	if (pFile == NULL)
+	{
+		printf("Replay: Could not open '%s' for writing\n", m_Settings.szOut);
+		return;
+	}
+
+	fprintf(pFile, "{\n  \"scenario\": \"replay\",\n  \"log\": \"%s\",\n  \"complete\": %s,\n  \"unthrottled\": %s,\n  \"frames\": %u,\n  \"total_ms\": %.3f,\n  \"average_ms\": %.3f,\n  \"p50_ms\": %.3f,\n  \"p95_ms\": %.3f,\n  \"p99_ms\": %.3f,\n  \"max_ms\": %.3f\n}\n",
+		m_Settings.szLog, bComplete ? "true" : "false", m_Settings.bUnthrottled ? "true" : "false", (unsigned int)vSorted.size(), dTotal, dAverage,
+		Percentile(vSorted, 0.5), Percentile(vSorted, 0.95), Percentile(vSorted, 0.99), vSorted.empty() ? 0.0 : vSorted.back());
+
+	fclose(pFile);
+}
+
+ReplayRun::ReplayRun(const Settings& ac_Settings) : m_Settings(ac_Settings)
+{
+	if (m_Settings.bUnthrottled)
+		SDL_GL_SetSwapInterval(0);
+	if (m_Settings.bHeadless)
+		SDL_HideWindow(Graphics::voWindows[0]->GetWindow());
+
+	m_bLoaded = Replay::StartReplay(m_Settings.szLog);
+	m_bRunning = m_bLoaded;
+
+	m_vMilliseconds.reserve(Replay::GetReplayFrames());
+
+	m_uiStart = SDL_GetPerformanceCounter();
+	m_uiLastFrame = m_uiStart;
+}
+ReplayRun::~ReplayRun()
+{
+	Replay::StopReplay();
+}
@@ -0,0 +1,47 @@
+//////////////////////////////////////////////////////////////
+// File: ReplayRun.h
+// Author: Ben Odom
+// Brief: Plays a recorded input log back through the game's
+//		  own 'GameLoop' and times every frame of it. The
+//		  same log run on two engine builds plays the same
+//		  game, so their frame times can be compared
+//////////////////////////////////////////////////////////////
+
+#ifndef _REPLAYRUN_H_
+#define _REPLAYRUN_H_
+
+#include "GameLoop.h"
+
+#include <vector>
+
+class ReplayRun : public GameLoop
+{
+public:
+	struct Settings
+	{
+		const char* szLog;	// The log 'Replay::StartRecording' wrote
+		bool bHeadless;		// Hides the window while running
+		bool bUnthrottled;	// Doesn't wait for vsync, so frames run as fast as they can be drawn
+		const char* szOut;	// Where to write the JSON result, or nullptr for the console only
+	};
+
+	// - Whether the log could be loaded. 'Loop' returns straight away if it couldn't
+	bool IsLoaded() const;
+	// - Prints the frame times and writes them to 'Settings::szOut'. Call after 'Loop' returns
+	void Report() const;
+
+	void Update() override;
+
+	ReplayRun(const Settings& ac_Settings);
+	~ReplayRun();
+
+private:
+	Settings m_Settings;
+	bool m_bLoaded;
+
+	Uint64 m_uiLastFrame;
+	Uint64 m_uiStart;
+	std::vector<double> m_vMilliseconds; // The time of every frame played back
+};
+
+#endif // _REPLAYRUN_H_
@@ -0,0 +1,180 @@
+//////////////////////////////////////////////////////////////
+// Project: Graphics Benchmarks
+// Author: Ben Odom
+// Usage: Benchmark.exe [--out results.json] [--samples 50]
+//						[--label name] [--headless]
+//		  Benchmark.exe --bunnymark [--seed 1] [--frames 0]
+//						[--budget 16.67] [--spawn 100]
+//						[--out result.json] [--headless]
+//						[--overdraw]
+//		  Benchmark.exe --replay input.rec [--unthrottled]
+//						[--out result.json] [--headless]
+//		  Benchmark.exe --latency [--seed 1] [--frames 600]
+//						[--unthrottled] [--gpu-wait]
+//						[--out result.json] [--headless]
+//		  Benchmark.exe --check
+//		  --input-thread pumps events on their own thread
+//		  while the bunnymark, a replay or the latency run
+//		  runs, and --counters publishes their frame counters
+//		  for 'PerfViewer'. --check compares what culling and
+//		  the depth pass assume about 'DrawSurface' with what
+//		  it draws, and exits with 1 if they differ
+//////////////////////////////////////////////////////////////
+
+#define SDL_MAIN_HANDLED // The benchmarks need 'argc' and 'argv' rather than 'wmain'
+
+#include "Benchmark.h"
+#include "Bunnymark.h"
+#include "LatencyRun.h"
+#include "RenderCheck.h"
+#include "ReplayRun.h"
+
+#include "CounterExport.h"
+#include "Input.h"
+
+#include "Graphics.h"
+
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char* argv[])
+{
+	const char* szOut = nullptr;
+	bool bHeadless = false;
+	bool bBunnymark = false;
+	bool bUnthrottled = false;
+	bool bLatency = false;
+	bool bGpuWait = false;
+	bool bCounters = false;
+	bool bCheck = false;
+	const char* szReplay = nullptr;
+
+	Bunnymark::Settings settings = Bunnymark::DefaultSettings();
+	LatencyRun::Settings latencySettings = LatencyRun::DefaultSettings();
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+			szOut = argv[++i];
+		else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+			Benchmark::SetSamples((unsigned int)atoi(argv[++i]));
+		else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc)
+			Benchmark::SetLabel(argv[++i]);
+		else if (strcmp(argv[i], "--headless") == 0)
+			bHeadless = true;
+		else if (strcmp(argv[i], "--bunnymark") == 0)
+			bBunnymark = true;
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+			szReplay = argv[++i];
+		else if (strcmp(argv[i], "--unthrottled") == 0)
+			bUnthrottled = true;
+		else if (strcmp(argv[i], "--latency") == 0)
+			bLatency = true;
+		else if (strcmp(argv[i], "--gpu-wait") == 0)
+			bGpuWait = true;
+		else if (strcmp(argv[i], "--input-thread") == 0)
+			Input::SetThreaded(true);
+		else if (strcmp(argv[i], "--counters") == 0)
+			bCounters = true;
+		else if (strcmp(argv[i], "--check") == 0)
+			bCheck = true;
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			settings.uiSeed = latencySettings.uiSeed = (unsigned int)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+			settings.uiMaxFrames = latencySettings.uiFrames = (unsigned int)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+			settings.dBudgetMilliseconds = atof(argv[++i]);
+		else if (strcmp(argv[i], "--spawn") == 0 && i + 1 < argc)
+			settings.uiSpawnPerFrame = (unsigned int)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--overdraw") == 0)
+			settings.bOverdraw = true;
+	}
+
+	SDL_SetMainReady();
+	Graphics::Init();
+
+	Graphics::NewWindow({ 1600, 900 }, false, { 1600, 900 }, "Graphics Benchmarks");
+
+	// Every way out of here returns, so the segment is removed at exit rather than before each 'Quit'
+	if (bCounters && CounterExport::Open())
+		atexit(CounterExport::Close);
+
+	// The window stays visible, so what is drawn into it can be read back
+	if (bCheck)
+	{
+		SDL_GL_SetSwapInterval(0);
+		const bool bCulling = RenderCheck::CheckCulling();
+		const bool bPassed = RenderCheck::CheckDepthPass() && bCulling;
+
+		Graphics::Quit();
+
+		return bPassed ? 0 : 1;
+	}
+
+	if (szReplay != nullptr)
+	{
+		const ReplayRun::Settings replaySettings = { szReplay, bHeadless, bUnthrottled, szOut };
+		bool bLoaded;
+
+		// Scoped so the replay is stopped before 'Quit'
+		{
+			ReplayRun oReplay(replaySettings);
+			oReplay.Loop();
+			oReplay.Report();
+			bLoaded = oReplay.IsLoaded();
+		}
+
+		Graphics::Quit();
+
+		return bLoaded ? 0 : 1;
+	}
+
+	if (bLatency)
+	{
+		latencySettings.bHeadless = bHeadless;
+		latencySettings.bUnthrottled = bUnthrottled;
+		latencySettings.bGpuWait = bGpuWait;
+		latencySettings.szOut = szOut;
+
+		// Scoped so the thread pushing events is stopped before 'Quit'
+		{
+			LatencyRun oLatency(latencySettings);
+			oLatency.Loop();
+			oLatency.Report();
+		}
+
+		Graphics::Quit();
+
+		return 0;
+	}
+
+	if (bBunnymark)
+	{
+		settings.bHeadless = bHeadless;
+		settings.szOut = szOut;
+
+		// Scoped so the sprites are released before 'Quit'
+		{
+			Bunnymark oBunnymark(settings);
+			oBunnymark.Loop();
+			oBunnymark.Report();
+		}
+
+		Graphics::Quit();
+
+		return 0;
+	}
+
+	// Nothing here should wait on the display, and a hidden window still has a working context to draw into
+	SDL_GL_SetSwapInterval(0);
+	if (bHeadless)
+		SDL_HideWindow(Graphics::voWindows[0]->GetWindow());
+
+	Benchmark::RunGraphicsBenchmarks();
+
+	const bool bWritten = Benchmark::WriteJSON(szOut);
+
+	Graphics::Quit();
+
+	return bWritten ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+//////////////////////////////////////////////////////////////
+// Project: Performance Counter Viewer
+// Author: Ben Odom
+// Usage: PerfViewer.exe <process ID> [--interval 250]
+//						 [--once]
+//		  Attaches to the counters a running game publishes
+//		  with 'CounterExport::Open' and shows them in the
+//		  terminal until the game closes. '--once' prints a
+//		  single snapshot and exits, for scripts
+//////////////////////////////////////////////////////////////
+
+#define _CRT_SECURE_NO_WARNINGS // Allows 'snprintf' with Visual Studio's SDL checks turned on
+
+#include "PerfCounters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace Graphics::PerfCounters;
+
+namespace
+{
+	const unsigned int kuiStalledSeconds = 2; // How long the frame count can stay still before the game is shown as not responding
+
+	// - Maps the segment of process 'ac_uiProcess' read only. Returns nullptr if it doesn't have one
+	const Segment* Attach(const Uint32 ac_uiProcess)
+	{
+		char szName[64];
+		SegmentName(ac_uiProcess, szName, sizeof(szName));
+
+#ifdef _WIN32
+		// The handle is left open so the segment outlives the game for as long as this is watching it
+		const HANDLE hMapping = OpenFileMappingA(FILE_MAP_READ, FALSE, szName);
+		if (hMapping == NULL)
+			return nullptr;
+
+		const void* pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, sizeof(Segment));
+		if (pData == nullptr)
+			CloseHandle(hMapping);
+		return (const Segment*)pData;
+#else
+		const int iFile = shm_open(szName, O_RDONLY, 0);
+		if (iFile < 0)
+			return nullptr;
+
+		void* pData = mmap(nullptr, sizeof(Segment), PROT_READ, MAP_SHARED, iFile, 0);
+		close(iFile);
+		return pData != MAP_FAILED ? (const Segment*)pData : nullptr;
+#endif
+	}
+
+	// - Moves the cursor to the top left and clears the terminal, so each snapshot is drawn over the last
+	void ClearScreen()
+	{
+#ifdef _WIN32
+		const HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+		CONSOLE_SCREEN_BUFFER_INFO info;
+		if (!GetConsoleScreenBufferInfo(hConsole, &info))
+			return;
+
+		const COORD home = { 0, 0 };
+		DWORD uiWritten;
+		FillConsoleOutputCharacterA(hConsole, ' ', info.dwSize.X * info.dwSize.Y, home, &uiWritten);
+		SetConsoleCursorPosition(hConsole, home);
+#else
+		printf("\x1b[H\x1b[2J");
+#endif
+	}
+
+	void PrintFrame(const Segment& ac_Segment, const FrameCounters& ac_Frame, const bool ac_bStalled)
+	{
+		// The history has every frame since the oldest one still in it, which may be fewer than 'kuiHistory' early on
+		const unsigned int uiHistory = (unsigned int)std::min<Uint64>(ac_Frame.ullFrame, kuiHistory);
+		float afSorted[kuiHistory];
+		for (unsigned int i = 0; i < uiHistory; ++i)
+			afSorted[i] = ac_Frame.afHistory[(ac_Frame.ullFrame - i) % kuiHistory];
+		std::sort(afSorted, afSorted + uiHistory);
+
+		float fTotal = 0.0f;
+		for (unsigned int i = 0; i < uiHistory; ++i)
+			fTotal += afSorted[i];
+		const float fAverage = uiHistory > 0 ? fTotal / uiHistory : 0.0f;
+		const float fP99 = uiHistory > 0 ? afSorted[std::min((unsigned int)(0.99f * uiHistory), uiHistory - 1)] : 0.0f;
+		const float fMax = uiHistory > 0 ? afSorted[uiHistory - 1] : 0.0f;
+
+		printf("Process %u  frame %llu%s\n\n", ac_Segment.Header.uiProcess, (unsigned long long)ac_Frame.ullFrame, ac_bStalled ? "  (not responding)" : "");
+
+		printf("Frame      %7.2f ms  %6.1f fps\n", ac_Frame.dFrameMilliseconds, ac_Frame.dFrameMilliseconds > 0.0 ? 1000.0 / ac_Frame.dFrameMilliseconds : 0.0);
+		printf("Last %-3u   %7.2f ms average  %.2f ms p99  %.2f ms max\n", uiHistory, fAverage, fP99, fMax);
+		printf("CPU        %7.2f ms\n", ac_Frame.dCpuMilliseconds);
+		for (unsigned int i = 0; i < PHASE_COUNT; ++i)
+			printf("  %-12.*s %7.2f ms\n", (int)kuiNameLength, ac_Segment.Header.aaPhaseNames[i], ac_Frame.adPhaseMilliseconds[i]);
+
+		printf("\nDraws      %7u  binds %u  vertices %u\n", ac_Frame.uiDrawCalls, ac_Frame.uiTextureBinds, ac_Frame.uiVertices);
+		printf("Surfaces   %7u  drawn %u  culled %u\n", ac_Frame.uiSurfaces, ac_Frame.uiSurfacesDrawn, ac_Frame.uiSurfacesCulled);
+		printf("Textures   %7u  %.1f MB\n", ac_Frame.uiTextures, ac_Frame.uiTextureBytes / (1024.0 * 1024.0));
+		printf("Uploads    %7u  %.1f KB\n", ac_Frame.uiTextureUploads, ac_Frame.uiTextureUploadBytes / 1024.0);
+		printf("Flips      %7u\n", ac_Frame.uiWindowsFlipped);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: PerfViewer <process ID> [--interval 250] [--once]\n");
+		return 1;
+	}
+
+	const Uint32 uiProcess = (Uint32)strtoul(argv[1], nullptr, 10);
+	unsigned int uiInterval = 250;
+	bool bOnce = false;
+	for (int i = 2; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc)
+			uiInterval = std::max(atoi(argv[++i]), 1);
+		else if (strcmp(argv[i], "--once") == 0)
+			bOnce = true;
+	}
+
+	const Segment* pSegment = Attach(uiProcess);
+	if (pSegment == nullptr)
+	{
+		printf("Process %u isn't publishing counters\n", uiProcess);
+		return 1;
+	}
+	if (!IsValid(*pSegment))
+	{
+		printf("Process %u publishes counters version %u, this viewer reads version %u\n", uiProcess, pSegment->Header.uiVersion, kuiVersion);
+		return 1;
+	}
+
+	Uint64 ullLastFrame = 0;
+	std::chrono::steady_clock::time_point lastChange = std::chrono::steady_clock::now();
+	for (;;)
+	{
+		FrameCounters frame;
+		if (Read(*pSegment, frame))
+		{
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (frame.ullFrame != ullLastFrame)
+			{
+				ullLastFrame = frame.ullFrame;
+				lastChange = now;
+			}
+
+			if (!bOnce)
+				ClearScreen();
+			PrintFrame(*pSegment, frame, now - lastChange > std::chrono::seconds(kuiStalledSeconds));
+			fflush(stdout);
+
+			if (bOnce)
+				return 0;
+		}
+
+		if (pSegment->Header.uiClosed != 0)
+		{
+			printf("\nProcess %u closed\n", uiProcess);
+			return 0;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(uiInterval));
+	}
+}
@@ -0,0 +1,173 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'snprintf' with Visual Studio's SDL checks turned on
+
+#include "CounterExport.h"
+#include "Graphics.h"
+
+#include <new>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const char* const aszPhaseNames[Graphics::PerfCounters::PHASE_COUNT] = { "Events", "Update", "LateUpdate", "Draw", "Present" };
+
+	Graphics::PerfCounters::Segment* pSegment = nullptr;
+	char szName[64];
+
+#ifdef _WIN32
+	HANDLE hMapping = NULL;
+#endif
+
+	Graphics::PerfCounters::FrameCounters Frame; // Built up here and copied into the segment in one go
+	Uint64 ullLastTicks = 0;
+
+	void* MapSegment()
+	{
+#ifdef _WIN32
+		hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(Graphics::PerfCounters::Segment), szName);
+		if (hMapping == NULL)
+			return nullptr;
+
+		void* pData = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Graphics::PerfCounters::Segment));
+		if (pData == nullptr)
+		{
+			CloseHandle(hMapping);
+			hMapping = NULL;
+		}
+		return pData;
+#else
+		// A segment left behind by a process that crashed with the same ID is taken over
+		const int iFile = shm_open(szName, O_CREAT | O_RDWR | O_TRUNC, 0644);
+		if (iFile < 0)
+			return nullptr;
+
+		void* pData = nullptr;
+		if (ftruncate(iFile, sizeof(Graphics::PerfCounters::Segment)) == 0)
+			pData = mmap(nullptr, sizeof(Graphics::PerfCounters::Segment), PROT_READ | PROT_WRITE, MAP_SHARED, iFile, 0);
+		close(iFile); // The mapping keeps the segment alive on its own
+
+		if (pData == nullptr || pData == MAP_FAILED)
+		{
+			shm_unlink(szName);
+			return nullptr;
+		}
+		return pData;
+#endif
+	}
+	void UnmapSegment()
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(pSegment);
+		CloseHandle(hMapping);
+		hMapping = NULL;
+#else
+		munmap(pSegment, sizeof(Graphics::PerfCounters::Segment));
+		shm_unlink(szName);
+#endif
+		pSegment = nullptr;
+	}
+}
+
+bool CounterExport::Open()
+{
+	if (pSegment != nullptr)
+		return true;
+
+#ifdef _WIN32
+	const Uint32 uiProcess = (Uint32)GetCurrentProcessId();
+#else
+	const Uint32 uiProcess = (Uint32)getpid();
+#endif
+	Graphics::PerfCounters::SegmentName(uiProcess, szName, sizeof(szName));
+
+	void* pData = MapSegment();
+	if (pData == nullptr)
+	{
+		printf("Counters: Could not make '%s'\n", szName);
+		return false;
+	}
+
+	pSegment = new (pData) Graphics::PerfCounters::Segment();
+
+	Graphics::PerfCounters::SegmentHeader& header = pSegment->Header;
+	memcpy(header.aMagic, Graphics::PerfCounters::kaMagic, sizeof(header.aMagic));
+	header.uiVersion = Graphics::PerfCounters::kuiVersion;
+	header.uiSize = sizeof(Graphics::PerfCounters::Segment);
+	header.uiProcess = uiProcess;
+	for (unsigned int i = 0; i < Graphics::PerfCounters::PHASE_COUNT; ++i)
+		snprintf(header.aaPhaseNames[i], Graphics::PerfCounters::kuiNameLength, "%s", aszPhaseNames[i]);
+
+	memset(&Frame, 0, sizeof(Frame));
+	Frame.ullTicksPerSecond = SDL_GetPerformanceFrequency();
+	ullLastTicks = 0;
+
+	printf("Counters: Publishing to '%s', watch with 'PerfViewer %u'\n", szName, uiProcess);
+	return true;
+}
+
+void CounterExport::Close()
+{
+	if (pSegment == nullptr)
+		return;
+
+	// Anyone still attached keeps their mapping after it is removed, and sees this instead of a frame count that stopped moving
+	pSegment->Header.uiClosed = 1;
+
+	UnmapSegment();
+}
+
+bool CounterExport::IsOpen()
+{
+	return pSegment != nullptr;
+}
+
+void CounterExport::Publish(const double ac_dCpuMilliseconds, const double (&ac_adPhaseMilliseconds)[Graphics::PerfCounters::PHASE_COUNT])
+{
+	if (pSegment == nullptr)
+		return;
+
+	const Uint64 ullTicks = SDL_GetPerformanceCounter();
+	const double dFrameMilliseconds = ullLastTicks != 0 ? (ullTicks - ullLastTicks) * 1000.0 / Frame.ullTicksPerSecond : ac_dCpuMilliseconds;
+	ullLastTicks = ullTicks;
+
+	++Frame.ullFrame;
+	Frame.ullTicks = ullTicks;
+	Frame.dFrameMilliseconds = dFrameMilliseconds;
+	Frame.dCpuMilliseconds = ac_dCpuMilliseconds;
+	for (unsigned int i = 0; i < Graphics::PerfCounters::PHASE_COUNT; ++i)
+		Frame.adPhaseMilliseconds[i] = ac_adPhaseMilliseconds[i];
+
+	const Graphics::FrameStats& frameStats = Graphics::GetFrameStats();
+	Frame.uiDrawCalls = frameStats.uiDrawCalls;
+	Frame.uiTextureBinds = frameStats.uiTextureBinds;
+	Frame.uiVertices = 0;
+	for (unsigned int i = 0; i < Graphics::PRIMITIVE_COUNT; ++i)
+		Frame.uiVertices += frameStats.uiVertices[i];
+	Frame.uiSurfacesDrawn = 0;
+	Frame.uiSurfacesCulled = 0;
+	for (unsigned int i = 0; i < Graphics::kuiStatsCameras; ++i)
+	{
+		Frame.uiSurfacesDrawn += frameStats.uiSurfacesSubmitted[i];
+		Frame.uiSurfacesCulled += frameStats.uiSurfacesCulled[i];
+	}
+	Frame.uiSurfaces = (Uint32)Graphics::vglSurfaces.size();
+	Frame.uiTextureUploads = frameStats.uiTextureUploads;
+	Frame.uiTextureUploadBytes = frameStats.uiTextureUploadBytes;
+	Frame.uiWindowsFlipped = frameStats.uiWindowsFlipped;
+
+	const Graphics::TextureCacheStats& textureStats = Graphics::GetTextureCacheStats();
+	Frame.uiTextures = textureStats.uiTextures;
+	Frame.uiTextureBytes = textureStats.uiResidentBytes;
+
+	Frame.afHistory[Frame.ullFrame % Graphics::PerfCounters::kuiHistory] = (float)dFrameMilliseconds;
+
+	Graphics::PerfCounters::Write(*pSegment, Frame);
+}
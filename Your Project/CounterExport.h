@@ -0,0 +1,31 @@
+//////////////////////////////////////////////////////////////
+// File: CounterExport.h
+// Author: Ben Odom
+// Brief: Publishes the frame stats, texture memory and the
+//		  time of every phase of the frame into shared memory
+//		  laid out as in 'PerfCounters.h', once a frame, so
+//		  'PerfViewer' or any other process can watch a
+//		  running game by its process ID
+//////////////////////////////////////////////////////////////
+
+#ifndef _COUNTEREXPORT_H_
+#define _COUNTEREXPORT_H_
+
+#include "PerfCounters.h"
+
+namespace CounterExport
+{
+	// - Makes this process's segment and starts publishing into it. Returns false if the segment couldn't be made
+	bool Open();
+	// - Marks the segment closed for anyone watching and removes it. Call before 'Quit'
+	void Close();
+	// - Whether frames are being published
+	bool IsOpen();
+
+	/* - Publishes the frame that just ended. 'GameLoop' calls it after 'EndFrameStats' while the segment is open
+	   'ac_dCpuMilliseconds' is how long the frame took to make before 'Present', and 'ac_adPhaseMilliseconds' how long each phase took
+	*/
+	void Publish(const double ac_dCpuMilliseconds, const double (&ac_adPhaseMilliseconds)[Graphics::PerfCounters::PHASE_COUNT]);
+}
+
+#endif // _COUNTEREXPORT_H_
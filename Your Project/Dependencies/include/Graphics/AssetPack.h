@@ -0,0 +1,194 @@
+//////////////////////////////////////////////////////////////
+// File: AssetPack.h
+// Author: Ben Odom
+// Brief: The layout of an asset pack, a single file holding
+//		  many images already decoded to RGBA, and the lookup
+//		  'LoadSurface' uses to find an image in the packs
+//		  that are open. The file is mapped into memory, so a
+//		  lookup is a hash and a probe, and the pixels are
+//		  uploaded straight from the mapping
+//////////////////////////////////////////////////////////////
+
+#ifndef _ASSETPACK_H_
+#define _ASSETPACK_H_
+
+#include "TextureCache.h"
+
+#include <cstring>
+
+/* Layout of a pack file, all little endian:
+   - 'PackHeader'
+   - 'uiSlots' 'PackEntry's, a hash table with open addressing. Empty slots have an offset of 0
+   - The names of every image, not null terminated
+   - The pixels of every image, each starting on a 'kuiPackAlignment' boundary
+*/
+namespace Graphics
+{
+	namespace AssetPack
+	{
+		const char kaMagic[4] = { 'A', 'P', 'A', 'K' };
+		const Uint32 kuiVersion = 1;
+		const Uint32 kuiPackAlignment = 64; // Pixels start on a cache line, so rows can be read with aligned loads
+
+		enum PixelFormat
+		{
+			FORMAT_RGBA8 = 0 // 4 bytes a pixel, red first, rows tightly packed
+		};
+
+		struct PackHeader
+		{
+			char   aMagic[4];
+			Uint32 uiVersion;
+			Uint32 uiSlots;	  // Always a power of 2
+			Uint32 uiEntries; // Slots in use
+			Uint64 ullFileSize;
+		};
+
+		struct PackEntry
+		{
+			Uint64 ullHash;	  // 'Hash' of the pack name
+			Uint64 ullOffset; // Where the pixels start, from the start of the file
+			Uint32 uiWidth;
+			Uint32 uiHeight;
+			Uint32 uiFormat;
+			Uint32 uiNameOffset; // Where the pack name starts, from the start of the file
+			Uint32 uiNameLength;
+			Uint32 uiPadding;
+		};
+
+		// An image found in a pack
+		struct PackedImage
+		{
+			const void* pPixels;
+			System::Size2D<int> Size;
+		};
+
+		// Every pack that is open
+		struct PackList
+		{
+			std::vector<const Uint8*> vData;
+			std::vector<Uint64>		  vSizes;
+		};
+
+		// - Returns the packs that are open. Only use it from the thread that draws
+		PackList& Packs();
+
+		// - Turns a path from 'NormalizePath' into the name a pack holds it under
+		//   A pack built on one platform may be read on another, so names are kept in lower case whichever it is
+		std::string PackName(const std::string& ac_sPath);
+		// - Hashes a pack name. 64 bit FNV-1a, never 0
+		Uint64 Hash(const std::string& ac_sKey);
+
+		// - Checks a pack in memory and adds it to the packs 'Find' searches. Returns false if it isn't a valid pack
+		bool Register(const void* ac_pData, const Uint64 ac_ullSize);
+		// - Stops 'Find' searching a pack. Surfaces already loaded from it keep their textures
+		void Unregister(const void* ac_pData);
+
+		// - Looks for an image by its normalized path in every registered pack, newest pack first
+		bool Find(const std::string& ac_sKey, PackedImage& a_Image);
+	}
+}
+
+namespace Graphics
+{
+	inline AssetPack::PackList& AssetPack::Packs()
+	{
+		static PackList packs;
+
+		return packs;
+	}
+
+	inline std::string AssetPack::PackName(const std::string& ac_sPath)
+	{
+		std::string sName = ac_sPath;
+		for (unsigned int i = 0; i < sName.size(); ++i)
+			sName[i] = (char)tolower((unsigned char)sName[i]);
+
+		return sName;
+	}
+	inline Uint64 AssetPack::Hash(const std::string& ac_sKey)
+	{
+		Uint64 ullHash = 14695981039346656037ULL;
+		for (unsigned int i = 0; i < ac_sKey.size(); ++i)
+			ullHash = (ullHash ^ (Uint8)ac_sKey[i]) * 1099511628211ULL;
+
+		// 0 is never a real hash, so a zeroed slot can't be mistaken for one
+		return ullHash != 0 ? ullHash : 1;
+	}
+
+	inline bool AssetPack::Register(const void* ac_pData, const Uint64 ac_ullSize)
+	{
+		const PackHeader* pHeader = (const PackHeader*)ac_pData;
+		if (ac_ullSize < sizeof(PackHeader) ||
+			memcmp(pHeader->aMagic, kaMagic, sizeof(kaMagic)) != 0 ||
+			pHeader->uiVersion != kuiVersion ||
+			pHeader->ullFileSize != ac_ullSize ||
+			pHeader->uiSlots == 0 || (pHeader->uiSlots & (pHeader->uiSlots - 1)) != 0 ||
+			sizeof(PackHeader) + (Uint64)pHeader->uiSlots * sizeof(PackEntry) > ac_ullSize)
+		{
+			printf("AssetPack: Not a valid version %u asset pack\n", kuiVersion);
+			return false;
+		}
+
+		Packs().vData.push_back((const Uint8*)ac_pData);
+		Packs().vSizes.push_back(ac_ullSize);
+
+		return true;
+	}
+	inline void AssetPack::Unregister(const void* ac_pData)
+	{
+		PackList& packs = Packs();
+		for (unsigned int i = 0; i < packs.vData.size(); ++i)
+		{
+			if (packs.vData[i] == ac_pData)
+			{
+				packs.vData.erase(packs.vData.begin() + i);
+				packs.vSizes.erase(packs.vSizes.begin() + i);
+				return;
+			}
+		}
+	}
+
+	inline bool AssetPack::Find(const std::string& ac_sKey, PackedImage& a_Image)
+	{
+		const PackList& packs = Packs();
+		if (packs.vData.empty())
+			return false;
+
+		const std::string sName = PackName(ac_sKey);
+		const Uint64 ullHash = Hash(sName);
+
+		// Packs opened later are searched first, so a patch pack can replace images in the one it was built on
+		for (unsigned int i = (unsigned int)packs.vData.size(); i-- > 0;)
+		{
+			const Uint8* pData = packs.vData[i];
+			const PackHeader& header = *(const PackHeader*)pData;
+			const PackEntry* pSlots = (const PackEntry*)(pData + sizeof(PackHeader));
+
+			for (Uint32 uiProbe = 0; uiProbe < header.uiSlots; ++uiProbe)
+			{
+				const PackEntry& entry = pSlots[(ullHash + uiProbe) & (header.uiSlots - 1)];
+				if (entry.ullOffset == 0)
+					break;
+				if (entry.ullHash != ullHash)
+					continue;
+
+				// Different paths can share a hash, so the name is checked too
+				if (entry.uiNameLength != sName.size() || (Uint64)entry.uiNameOffset + entry.uiNameLength > packs.vSizes[i] ||
+					memcmp(pData + entry.uiNameOffset, sName.data(), entry.uiNameLength) != 0)
+					continue;
+
+				if (entry.uiFormat != FORMAT_RGBA8 || entry.ullOffset + (Uint64)entry.uiWidth * entry.uiHeight * 4 > packs.vSizes[i])
+					return false;
+
+				a_Image.pPixels = pData + entry.ullOffset;
+				a_Image.Size = { (int)entry.uiWidth, (int)entry.uiHeight };
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+#endif // _ASSETPACK_H_
@@ -0,0 +1,316 @@
+//////////////////////////////////////////////////////////////
+// File: FrameStats.h
+// Author: Ben Odom
+// Brief: Counts how much work the renderer does each frame.
+//		  The 'Graphics' free functions add to the counters
+//		  as they go, and 'EndFrameStats' moves the totals
+//		  into a history of the last few frames. Counters are
+//		  relaxed atomics so any thread can add to them
+//////////////////////////////////////////////////////////////
+
+#ifndef _FRAMESTATS_H_
+#define _FRAMESTATS_H_
+
+#include "Window.h"
+
+#include <atomic>
+
+namespace Graphics
+{
+	// Every kind of thing the renderer draws
+	enum PrimitiveType
+	{
+		PRIMITIVE_SURFACE,
+		PRIMITIVE_RECT,
+		PRIMITIVE_LINE,
+		PRIMITIVE_POINT,
+		PRIMITIVE_RING,
+		PRIMITIVE_CIRCLE,
+
+		PRIMITIVE_COUNT
+	};
+
+	const unsigned int kuiStatsCameras = 16;	 // Cameras past this many are counted together in the last slot
+	const unsigned int kuiStatsHistory = 120;	 // How many finished frames 'GetFrameStats' can look back
+	const unsigned int kuiStatsLayers = 8;		 // One for each 'LayerType'
+
+	// How many times the pixels of a camera or a layer were drawn. Only measured while the overdraw mode is on
+	struct OverdrawStats
+	{
+		unsigned int uiPixels;	  // Pixels measured. A layer counts every pixel of each camera, whether it drew there or not
+		unsigned int uiFragments; // Times any of them was drawn
+		unsigned int uiMax;		  // The most times one pixel was drawn, up to 255
+
+		// - The times an average pixel was drawn
+		float Average() const { return uiPixels > 0 ? (float)uiFragments / uiPixels : 0.0f; }
+		// - Adds another camera or frame to these, such as to total a run
+		void Add(const OverdrawStats& ac_Other)
+		{
+			uiPixels += ac_Other.uiPixels;
+			uiFragments += ac_Other.uiFragments;
+			uiMax = ac_Other.uiMax > uiMax ? ac_Other.uiMax : uiMax;
+		}
+	};
+
+	// The totals of one finished frame
+	struct FrameStats
+	{
+		unsigned int uiFrame; // Which frame these are, counting from 0
+
+		unsigned int uiDrawCalls;
+		unsigned int uiTextureBinds;
+		unsigned int uiColorChanges;
+
+		unsigned int uiPrimitives[PRIMITIVE_COUNT];
+		unsigned int uiVertices[PRIMITIVE_COUNT];
+
+		unsigned int uiSurfacesSubmitted[kuiStatsCameras]; // Surfaces each camera drew
+		unsigned int uiSurfacesCulled[kuiStatsCameras];	   // Surfaces each camera skipped
+
+		unsigned int uiTextureUploads;
+		unsigned int uiTextureUploadBytes;
+
+		unsigned int uiWindowsFlipped; // Windows 'Present' swapped. Ones it skipped because nothing changed aren't counted
+
+		OverdrawStats CameraOverdraw[kuiStatsCameras];
+		OverdrawStats LayerOverdraw[kuiStatsLayers]; // Every camera's pixels together, for each 'LayerType'
+
+		unsigned int uiRedundantStateCalls; // OpenGL calls 'GLState' skipped. Only counted in debug builds
+	};
+
+	// The counters for the frame in progress. Only touch these through the 'Stats' functions
+	struct FrameCounters
+	{
+		std::atomic<bool> bDisabled; // Counting is on until this is set, since function statics start out as zero
+
+		std::atomic<unsigned int> uiDrawCalls;
+		std::atomic<unsigned int> uiTextureBinds;
+		std::atomic<unsigned int> uiColorChanges;
+
+		std::atomic<unsigned int> uiPrimitives[PRIMITIVE_COUNT];
+		std::atomic<unsigned int> uiVertices[PRIMITIVE_COUNT];
+
+		std::atomic<unsigned int> uiSurfacesSubmitted[kuiStatsCameras];
+		std::atomic<unsigned int> uiSurfacesCulled[kuiStatsCameras];
+
+		std::atomic<unsigned int> uiTextureUploads;
+		std::atomic<unsigned int> uiTextureUploadBytes;
+
+		std::atomic<unsigned int> uiWindowsFlipped;
+
+		std::atomic<unsigned int> uiCameraOverdraw[kuiStatsCameras][3]; // Pixels, fragments and the most of one pixel
+		std::atomic<unsigned int> uiLayerOverdraw[kuiStatsLayers][3];
+
+		std::atomic<unsigned int> uiRedundantStateCalls;
+
+		FrameStats aHistory[kuiStatsHistory]; // A ring buffer of finished frames
+		unsigned int uiFrames;				  // Frames finished so far
+	};
+
+	// - Turns counting on or off. While off, each counter costs a single branch
+	void EnableFrameStats(const bool ac_bEnabled);
+	// - Whether or not counters are being kept
+	bool IsFrameStatsEnabled();
+
+	// - Returns the totals of a finished frame. 0 is the most recently finished frame, 1 the one before it and so on
+	const FrameStats& GetFrameStats(const unsigned int ac_uiFramesAgo = 0);
+	// - Returns how many finished frames 'GetFrameStats' can currently look back through
+	unsigned int GetFrameStatsHistorySize();
+
+	// - Moves the counters of the frame in progress into the history and starts the next frame at 0
+	//   Call once per frame after 'Flip'
+	void EndFrameStats();
+
+	namespace Stats
+	{
+		// - Returns the one set of counters shared by everything that includes this file
+		FrameCounters& Counters();
+
+		// - Counts a draw call of 'ac_uiVertices' vertices
+		void AddDraw(const PrimitiveType ac_Type, const unsigned int ac_uiVertices);
+		// - Counts a 'glBindTexture'
+		void AddTextureBind();
+		// - Counts a 'glColor'
+		void AddColorChange();
+		// - Counts a camera drawing or skipping surfaces
+		void AddSurfaces(const unsigned int ac_uiCamera, const unsigned int ac_uiSubmitted, const unsigned int ac_uiCulled);
+		// - Counts a texture being uploaded with 'glTexImage2D'
+		void AddTextureUpload(const unsigned int ac_uiBytes);
+		// - Counts a window's buffers being swapped
+		void AddWindowFlip();
+		// - Counts an OpenGL call that was skipped because it wouldn't have changed anything. Does nothing outside debug builds
+		void AddRedundantStateCall();
+		// - Counts what the overdraw mode measured of a camera, or of one 'LayerType' of a camera
+		void AddCameraOverdraw(const unsigned int ac_uiCamera, const OverdrawStats& ac_Overdraw);
+		void AddLayerOverdraw(const unsigned int ac_uiLayer, const OverdrawStats& ac_Overdraw);
+	}
+}
+
+namespace Graphics
+{
+	inline FrameCounters& Stats::Counters()
+	{
+		// A function static means this header needs no source file, and every counter starts at 0
+		static FrameCounters counters;
+
+		return counters;
+	}
+
+	inline void Stats::AddDraw(const PrimitiveType ac_Type, const unsigned int ac_uiVertices)
+	{
+		FrameCounters& counters = Counters();
+		if (counters.bDisabled.load(std::memory_order_relaxed))
+			return;
+
+		counters.uiDrawCalls.fetch_add(1, std::memory_order_relaxed);
+		counters.uiPrimitives[ac_Type].fetch_add(1, std::memory_order_relaxed);
+		counters.uiVertices[ac_Type].fetch_add(ac_uiVertices, std::memory_order_relaxed);
+	}
+	inline void Stats::AddTextureBind()
+	{
+		FrameCounters& counters = Counters();
+		if (!counters.bDisabled.load(std::memory_order_relaxed))
+			counters.uiTextureBinds.fetch_add(1, std::memory_order_relaxed);
+	}
+	inline void Stats::AddColorChange()
+	{
+		FrameCounters& counters = Counters();
+		if (!counters.bDisabled.load(std::memory_order_relaxed))
+			counters.uiColorChanges.fetch_add(1, std::memory_order_relaxed);
+	}
+	inline void Stats::AddSurfaces(const unsigned int ac_uiCamera, const unsigned int ac_uiSubmitted, const unsigned int ac_uiCulled)
+	{
+		FrameCounters& counters = Counters();
+		if (counters.bDisabled.load(std::memory_order_relaxed))
+			return;
+
+		const unsigned int uiSlot = ac_uiCamera < kuiStatsCameras ? ac_uiCamera : kuiStatsCameras - 1;
+		counters.uiSurfacesSubmitted[uiSlot].fetch_add(ac_uiSubmitted, std::memory_order_relaxed);
+		counters.uiSurfacesCulled[uiSlot].fetch_add(ac_uiCulled, std::memory_order_relaxed);
+	}
+	inline void Stats::AddTextureUpload(const unsigned int ac_uiBytes)
+	{
+		FrameCounters& counters = Counters();
+		if (counters.bDisabled.load(std::memory_order_relaxed))
+			return;
+
+		counters.uiTextureUploads.fetch_add(1, std::memory_order_relaxed);
+		counters.uiTextureUploadBytes.fetch_add(ac_uiBytes, std::memory_order_relaxed);
+	}
+
+	inline void Stats::AddWindowFlip()
+	{
+		FrameCounters& counters = Counters();
+		if (counters.bDisabled.load(std::memory_order_relaxed))
+			return;
+
+		counters.uiWindowsFlipped.fetch_add(1, std::memory_order_relaxed);
+	}
+	inline void Stats::AddRedundantStateCall()
+	{
+#ifdef _DEBUG
+		FrameCounters& counters = Counters();
+		if (!counters.bDisabled.load(std::memory_order_relaxed))
+			counters.uiRedundantStateCalls.fetch_add(1, std::memory_order_relaxed);
+#endif
+	}
+
+	namespace Stats
+	{
+		// - Adds to the three counters of one camera or layer, keeping the largest of the maximums
+		inline void AddOverdraw(std::atomic<unsigned int>* a_pCounters, const OverdrawStats& ac_Overdraw)
+		{
+			a_pCounters[0].fetch_add(ac_Overdraw.uiPixels, std::memory_order_relaxed);
+			a_pCounters[1].fetch_add(ac_Overdraw.uiFragments, std::memory_order_relaxed);
+
+			unsigned int uiMax = a_pCounters[2].load(std::memory_order_relaxed);
+			while (ac_Overdraw.uiMax > uiMax && !a_pCounters[2].compare_exchange_weak(uiMax, ac_Overdraw.uiMax, std::memory_order_relaxed))
+			{
+				// A failed exchange loads what another thread stored, so this only tries again while it is still smaller
+			}
+		}
+
+		// - Moves three counters into 'a_Overdraw' and starts them at 0 again
+		inline void TakeOverdraw(std::atomic<unsigned int>* a_pCounters, OverdrawStats& a_Overdraw)
+		{
+			a_Overdraw.uiPixels = a_pCounters[0].exchange(0, std::memory_order_relaxed);
+			a_Overdraw.uiFragments = a_pCounters[1].exchange(0, std::memory_order_relaxed);
+			a_Overdraw.uiMax = a_pCounters[2].exchange(0, std::memory_order_relaxed);
+		}
+	}
+	inline void Stats::AddCameraOverdraw(const unsigned int ac_uiCamera, const OverdrawStats& ac_Overdraw)
+	{
+		FrameCounters& counters = Counters();
+		if (!counters.bDisabled.load(std::memory_order_relaxed))
+			AddOverdraw(counters.uiCameraOverdraw[ac_uiCamera < kuiStatsCameras ? ac_uiCamera : kuiStatsCameras - 1], ac_Overdraw);
+	}
+	inline void Stats::AddLayerOverdraw(const unsigned int ac_uiLayer, const OverdrawStats& ac_Overdraw)
+	{
+		FrameCounters& counters = Counters();
+		if (!counters.bDisabled.load(std::memory_order_relaxed) && ac_uiLayer < kuiStatsLayers)
+			AddOverdraw(counters.uiLayerOverdraw[ac_uiLayer], ac_Overdraw);
+	}
+
+	inline void EnableFrameStats(const bool ac_bEnabled)
+	{
+		Stats::Counters().bDisabled.store(!ac_bEnabled, std::memory_order_relaxed);
+	}
+	inline bool IsFrameStatsEnabled()
+	{
+		return !Stats::Counters().bDisabled.load(std::memory_order_relaxed);
+	}
+
+	inline const FrameStats& GetFrameStats(const unsigned int ac_uiFramesAgo)
+	{
+		const FrameCounters& counters = Stats::Counters();
+
+		// Before the first frame finishes this returns a slot that is still all zeros
+		const unsigned int uiFramesAgo = ac_uiFramesAgo < GetFrameStatsHistorySize() ? ac_uiFramesAgo : GetFrameStatsHistorySize() - 1;
+		return counters.aHistory[(counters.uiFrames + kuiStatsHistory - 1 - uiFramesAgo) % kuiStatsHistory];
+	}
+	inline unsigned int GetFrameStatsHistorySize()
+	{
+		const unsigned int uiFrames = Stats::Counters().uiFrames;
+
+		return uiFrames == 0 ? 1 : (uiFrames < kuiStatsHistory ? uiFrames : kuiStatsHistory);
+	}
+
+	inline void EndFrameStats()
+	{
+		FrameCounters& counters = Stats::Counters();
+		FrameStats& stats = counters.aHistory[counters.uiFrames % kuiStatsHistory];
+
+		stats.uiFrame = counters.uiFrames;
+
+		stats.uiDrawCalls = counters.uiDrawCalls.exchange(0, std::memory_order_relaxed);
+		stats.uiTextureBinds = counters.uiTextureBinds.exchange(0, std::memory_order_relaxed);
+		stats.uiColorChanges = counters.uiColorChanges.exchange(0, std::memory_order_relaxed);
+
+		for (unsigned int i = 0; i < PRIMITIVE_COUNT; ++i)
+		{
+			stats.uiPrimitives[i] = counters.uiPrimitives[i].exchange(0, std::memory_order_relaxed);
+			stats.uiVertices[i] = counters.uiVertices[i].exchange(0, std::memory_order_relaxed);
+		}
+		for (unsigned int i = 0; i < kuiStatsCameras; ++i)
+		{
+			stats.uiSurfacesSubmitted[i] = counters.uiSurfacesSubmitted[i].exchange(0, std::memory_order_relaxed);
+			stats.uiSurfacesCulled[i] = counters.uiSurfacesCulled[i].exchange(0, std::memory_order_relaxed);
+		}
+
+		stats.uiTextureUploads = counters.uiTextureUploads.exchange(0, std::memory_order_relaxed);
+		stats.uiTextureUploadBytes = counters.uiTextureUploadBytes.exchange(0, std::memory_order_relaxed);
+
+		stats.uiRedundantStateCalls = counters.uiRedundantStateCalls.exchange(0, std::memory_order_relaxed);
+
+		stats.uiWindowsFlipped = counters.uiWindowsFlipped.exchange(0, std::memory_order_relaxed);
+
+		for (unsigned int i = 0; i < kuiStatsCameras; ++i)
+			Stats::TakeOverdraw(counters.uiCameraOverdraw[i], stats.CameraOverdraw[i]);
+		for (unsigned int i = 0; i < kuiStatsLayers; ++i)
+			Stats::TakeOverdraw(counters.uiLayerOverdraw[i], stats.LayerOverdraw[i]);
+
+		++counters.uiFrames;
+	}
+}
+
+#endif // _FRAMESTATS_H_
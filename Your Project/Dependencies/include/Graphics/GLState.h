@@ -0,0 +1,320 @@
+//////////////////////////////////////////////////////////////
+// File: GLState.h
+// Author: Ben Odom
+// Brief: Remembers the OpenGL state 'Graphics' last set for
+//		  each context (bound texture, color, blending,
+//		  view-port and scissor) and skips any call that
+//		  wouldn't change it. Debug builds count the calls
+//		  that were skipped in 'FrameStats'
+//////////////////////////////////////////////////////////////
+
+#ifndef _GLSTATE_H_
+#define _GLSTATE_H_
+
+#include "FrameStats.h"
+
+#include <SDL.h>
+#include <glut.h>
+
+namespace Graphics
+{
+	namespace GLState
+	{
+		// What 'GLState' believes is set in one context. 'b...Known' is false after 'Invalidate' until the state is set again
+		struct Cache
+		{
+			SDL_GLContext sdlContext;
+
+			GLuint uiTexture;
+			bool   bTextureKnown;
+
+			GLubyte aColor[4];
+			bool	bColorKnown;
+
+			bool   bBlend;
+			GLenum eBlendSource;
+			GLenum eBlendDest;
+			bool   bBlendKnown;
+			bool   bBlendFuncKnown;
+
+			GLint aViewport[4];
+			bool  bViewportKnown;
+
+			bool  bScissor;
+			GLint aScissor[4];
+			bool  bScissorKnown;
+			bool  bScissorBoxKnown;
+		};
+
+		const unsigned int kuiMaxContexts = 8;
+
+		// Every window draws with the one 'glContext', but threads with a context of their own ('CreateSharedContext') each need a cache
+		// for it. There are only ever a handful, so a linear search is fine
+		struct CacheList
+		{
+			Cache aCaches[kuiMaxContexts];
+			unsigned int uiCount;
+			unsigned int uiLast; // The cache that was asked for last, checked first
+		};
+
+		// - Returns the caches of every context that has been current on this thread
+		CacheList& Caches();
+		// - Returns the cache of the current context
+		Cache& Current();
+
+		// - Forgets everything about the current context. Call after any code that changes OpenGL state without going through 'GLState'
+		void Invalidate();
+		// - Forgets the bound texture and color of the current context
+		void InvalidateDraw();
+		// - Forgets everything about every context. Call after 'Flip', which can switch contexts and change state
+		void InvalidateAll();
+
+		/* - Forgets everything about every context when it goes out of scope. Put one around each call into the library's drawing
+		   ('Draw', 'UpdateCameras', 'DrawSurface' and 'Flip'), which binds textures, sets colors and blending without going through
+		   'GLState'. Nothing is needed going in, since every change 'GLState' makes goes straight to OpenGL
+		*/
+		struct Untracked
+		{
+			~Untracked();
+		};
+
+		// - Binds 'ac_uiTexture' to GL_TEXTURE_2D unless it already is
+		void BindTexture(const GLuint ac_uiTexture);
+		/* - Forgets 'ac_uiTexture' was bound, in every context of this thread. Call before 'glDeleteTextures'
+		   Deleting a bound texture binds 0, and 'glGenTextures' hands the same name straight back, so a cache still holding it
+		   would skip the next bind and the upload after it would go into texture 0
+		*/
+		void ForgetTexture(const GLuint ac_uiTexture);
+
+		// - Returns the flag 'TextureUploaded' sets. Only touch it through the two functions below
+		std::atomic<bool>& UploadFlag();
+		// - Records that a texture's pixels changed. Every upload calls it, whether or not frame stats are being kept
+		void TextureUploaded();
+		// - Whether any texture was uploaded since the last call, clearing it. 'Present' calls it once a frame
+		bool TakeTextureUploads();
+		// - Sets the current color unless it already is
+		void Color(const GLubyte ac_uiRed, const GLubyte ac_uiGreen, const GLubyte ac_uiBlue, const GLubyte ac_uiAlpha);
+		// - Turns blending on or off unless it already is
+		void Blend(const bool ac_bEnabled);
+		// - Sets the blend function unless it already is
+		void BlendFunc(const GLenum ac_eSource, const GLenum ac_eDest);
+		// - Sets the view-port unless it already is
+		void Viewport(const GLint ac_iX, const GLint ac_iY, const GLsizei ac_iWidth, const GLsizei ac_iHeight);
+		// - Turns the scissor test on or off unless it already is
+		void Scissor(const bool ac_bEnabled);
+		// - Sets the scissor box unless it already is
+		void ScissorBox(const GLint ac_iX, const GLint ac_iY, const GLsizei ac_iWidth, const GLsizei ac_iHeight);
+	}
+}
+
+namespace Graphics
+{
+	inline GLState::CacheList& GLState::Caches()
+	{
+		// A context can only be current on one thread at a time, so each thread keeps its own list
+		static thread_local CacheList caches = {};
+
+		return caches;
+	}
+	inline GLState::Cache& GLState::Current()
+	{
+		CacheList& caches = Caches();
+
+		const SDL_GLContext sdlContext = SDL_GL_GetCurrentContext();
+		if (caches.uiLast < caches.uiCount && caches.aCaches[caches.uiLast].sdlContext == sdlContext)
+			return caches.aCaches[caches.uiLast];
+
+		for (caches.uiLast = 0; caches.uiLast < caches.uiCount; ++caches.uiLast)
+		{
+			if (caches.aCaches[caches.uiLast].sdlContext == sdlContext)
+				return caches.aCaches[caches.uiLast];
+		}
+
+		// Past 'kuiMaxContexts' the first context gets forgotten, which only means its next calls go straight through
+		caches.uiLast = caches.uiCount < kuiMaxContexts ? caches.uiCount++ : 0;
+
+		const Cache cache = {};
+		caches.aCaches[caches.uiLast] = cache;
+		caches.aCaches[caches.uiLast].sdlContext = sdlContext;
+
+		return caches.aCaches[caches.uiLast];
+	}
+
+	inline void GLState::Invalidate()
+	{
+		Cache& cache = Current();
+
+		cache.bTextureKnown = false;
+		cache.bColorKnown = false;
+		cache.bBlendKnown = false;
+		cache.bBlendFuncKnown = false;
+		cache.bViewportKnown = false;
+		cache.bScissorKnown = false;
+		cache.bScissorBoxKnown = false;
+	}
+	inline void GLState::InvalidateDraw()
+	{
+		Cache& cache = Current();
+
+		cache.bTextureKnown = false;
+		cache.bColorKnown = false;
+	}
+
+	inline void GLState::InvalidateAll()
+	{
+		// Every context gets a fresh cache the next time it is current
+		Caches().uiCount = 0;
+	}
+
+	inline GLState::Untracked::~Untracked()
+	{
+		InvalidateAll();
+	}
+
+	inline void GLState::BindTexture(const GLuint ac_uiTexture)
+	{
+		Cache& cache = Current();
+		if (cache.bTextureKnown && cache.uiTexture == ac_uiTexture)
+		{
+			Stats::AddRedundantStateCall();
+			return;
+		}
+
+		glBindTexture(GL_TEXTURE_2D, ac_uiTexture);
+		Stats::AddTextureBind();
+
+		cache.uiTexture = ac_uiTexture;
+		cache.bTextureKnown = true;
+	}
+	inline std::atomic<bool>& GLState::UploadFlag()
+	{
+		static std::atomic<bool> bUploaded(false);
+
+		return bUploaded;
+	}
+	inline void GLState::TextureUploaded()
+	{
+		UploadFlag().store(true, std::memory_order_relaxed);
+	}
+	inline bool GLState::TakeTextureUploads()
+	{
+		return UploadFlag().exchange(false, std::memory_order_relaxed);
+	}
+
+	inline void GLState::ForgetTexture(const GLuint ac_uiTexture)
+	{
+		// Contexts share textures, so any of them may have it bound
+		CacheList& caches = Caches();
+		for (unsigned int i = 0; i < caches.uiCount; ++i)
+		{
+			if (caches.aCaches[i].uiTexture == ac_uiTexture)
+				caches.aCaches[i].bTextureKnown = false;
+		}
+	}
+	inline void GLState::Color(const GLubyte ac_uiRed, const GLubyte ac_uiGreen, const GLubyte ac_uiBlue, const GLubyte ac_uiAlpha)
+	{
+		Cache& cache = Current();
+		if (cache.bColorKnown &&
+			cache.aColor[0] == ac_uiRed && cache.aColor[1] == ac_uiGreen && cache.aColor[2] == ac_uiBlue && cache.aColor[3] == ac_uiAlpha)
+		{
+			Stats::AddRedundantStateCall();
+			return;
+		}
+
+		glColor4ub(ac_uiRed, ac_uiGreen, ac_uiBlue, ac_uiAlpha);
+		Stats::AddColorChange();
+
+		cache.aColor[0] = ac_uiRed;
+		cache.aColor[1] = ac_uiGreen;
+		cache.aColor[2] = ac_uiBlue;
+		cache.aColor[3] = ac_uiAlpha;
+		cache.bColorKnown = true;
+	}
+	inline void GLState::Blend(const bool ac_bEnabled)
+	{
+		Cache& cache = Current();
+		if (cache.bBlendKnown && cache.bBlend == ac_bEnabled)
+		{
+			Stats::AddRedundantStateCall();
+			return;
+		}
+
+		if (ac_bEnabled)
+			glEnable(GL_BLEND);
+		else
+			glDisable(GL_BLEND);
+
+		cache.bBlend = ac_bEnabled;
+		cache.bBlendKnown = true;
+	}
+	inline void GLState::BlendFunc(const GLenum ac_eSource, const GLenum ac_eDest)
+	{
+		Cache& cache = Current();
+		if (cache.bBlendFuncKnown && cache.eBlendSource == ac_eSource && cache.eBlendDest == ac_eDest)
+		{
+			Stats::AddRedundantStateCall();
+			return;
+		}
+
+		glBlendFunc(ac_eSource, ac_eDest);
+
+		cache.eBlendSource = ac_eSource;
+		cache.eBlendDest = ac_eDest;
+		cache.bBlendFuncKnown = true;
+	}
+	inline void GLState::Viewport(const GLint ac_iX, const GLint ac_iY, const GLsizei ac_iWidth, const GLsizei ac_iHeight)
+	{
+		Cache& cache = Current();
+		if (cache.bViewportKnown &&
+			cache.aViewport[0] == ac_iX && cache.aViewport[1] == ac_iY && cache.aViewport[2] == ac_iWidth && cache.aViewport[3] == ac_iHeight)
+		{
+			Stats::AddRedundantStateCall();
+			return;
+		}
+
+		glViewport(ac_iX, ac_iY, ac_iWidth, ac_iHeight);
+
+		cache.aViewport[0] = ac_iX;
+		cache.aViewport[1] = ac_iY;
+		cache.aViewport[2] = ac_iWidth;
+		cache.aViewport[3] = ac_iHeight;
+		cache.bViewportKnown = true;
+	}
+	inline void GLState::Scissor(const bool ac_bEnabled)
+	{
+		Cache& cache = Current();
+		if (cache.bScissorKnown && cache.bScissor == ac_bEnabled)
+		{
+			Stats::AddRedundantStateCall();
+			return;
+		}
+
+		if (ac_bEnabled)
+			glEnable(GL_SCISSOR_TEST);
+		else
+			glDisable(GL_SCISSOR_TEST);
+
+		cache.bScissor = ac_bEnabled;
+		cache.bScissorKnown = true;
+	}
+	inline void GLState::ScissorBox(const GLint ac_iX, const GLint ac_iY, const GLsizei ac_iWidth, const GLsizei ac_iHeight)
+	{
+		Cache& cache = Current();
+		if (cache.bScissorBoxKnown &&
+			cache.aScissor[0] == ac_iX && cache.aScissor[1] == ac_iY && cache.aScissor[2] == ac_iWidth && cache.aScissor[3] == ac_iHeight)
+		{
+			Stats::AddRedundantStateCall();
+			return;
+		}
+
+		glScissor(ac_iX, ac_iY, ac_iWidth, ac_iHeight);
+
+		cache.aScissor[0] = ac_iX;
+		cache.aScissor[1] = ac_iY;
+		cache.aScissor[2] = ac_iWidth;
+		cache.aScissor[3] = ac_iHeight;
+		cache.bScissorBoxKnown = true;
+	}
+}
+
+#endif // _GLSTATE_H_
@@ -3,6 +3,11 @@
 
 #include "Window.h"
 #include "Camera.h"
+#include "FrameStats.h"
+#include "GLState.h"
+#include "TextureCache.h"
+#include "AssetPack.h"
+#include "PixelConvert.h"
 
 #include <algorithm> // Holds the 'sort()' function
 
@@ -116,13 +121,16 @@ namespace Graphics
 	void ResizeCameras(Camera<T>& a_Camera, const System::Size2D<unsigned int>& ac_uiDimensions, const unsigned int ac_uiIndex);
 
 	// - Draws all surfaces currently in the 'vglSurfaces' vector
+	//   The library's drawing changes OpenGL state behind 'GLState', so call it inside a 'GLState::Untracked' scope
 	void Draw();
 
 	// - Updates the view-port to match the current 'Camera' object used to draw and then draws all surfaces in its world space
+	//   The library's drawing changes OpenGL state behind 'GLState', so call it inside a 'GLState::Untracked' scope
 	template <typename T>
 	void UpdateCameras(Camera<T>& a_Camera);
 
 	// - Draws a 'GLSurface' in relation to a 'Camera' object
+	//   The library's drawing changes OpenGL state behind 'GLState', so call it inside a 'GLState::Untracked' scope
 	template <typename T, typename U>
 	void DrawSurface(const GLSurface<T>& ac_glSurface, Camera<U>& a_Camera);
 
@@ -131,13 +139,37 @@ namespace Graphics
 	// - Sorts each surface based on its camera order
 	bool SortCamera(SurfaceUnion* ac_pglLeft, SurfaceUnion* ac_pglRight);
 
-	// - Loads a 'GLSurface' from a filename
+	// - Loads a 'GLSurface' from a filename. A file that is already loaded shares its texture instead of being read again
+	//   Open asset packs are searched before the disk, and an image found in one is uploaded without decoding
 	template <typename T = float>
 	GLSurface<T>* LoadSurface(const char* ac_szFilename);
-	// - Loads a 'GLSurface' from an existing 'SDL_Surface'
+	// - Loads a 'GLSurface' from an existing 'SDL_Surface'. Identical pixels that are already loaded share their texture
 	template <typename T = float>
 	GLSurface<T>* LoadSurface(SDL_Surface& a_sdlSurface);
 
+	// - Creates a 'GLSurface' that draws a texture the caller holds a 'TextureCache' reference to, and pushes it without sorting
+	template <typename T = float>
+	GLSurface<T>* NewSurface(const GLuint ac_uiTexture, const System::Size2D<int>& ac_Size);
+	// - Uploads the pixels of an 'SDL_Surface' of any format into a new texture, converting them to RGBA first if needed
+	//   'ac_bPersistent' means the pixels outlive the texture, as a mapped asset pack does
+	GLuint UploadTexture(const SDL_Surface& ac_sdlSurface, const bool ac_bPersistent = false);
+	/* - Uploads tightly packed RGBA pixels into a new texture, with a mip chain if 'SetMipmaps' is on
+	   With a texture budget set, the pixels are only kept and the texture is uploaded when it is first drawn
+	   'ac_bPersistent' means the pixels outlive the texture, so they are kept without a copy
+	*/
+	GLuint UploadTexture(const void* ac_pPixels, const System::Size2D<int>& ac_Size, const bool ac_bPersistent = false);
+
+	// - Sets how a surface's texture is filtered. Every surface sharing the texture is filtered the same way
+	template <typename T>
+	void SetSurfaceFilter(GLSurface<T>* a_pglSurface, const FilterMode ac_eFilter);
+	// - Keeps the mip levels of streamed textures matched to the most zoomed in camera, for up to 'ac_dBudgetMilliseconds'
+	//   Call once a frame on the thread that draws. A budget of 0 catches up all at once
+	void UpdateTextureStreaming(const double ac_dBudgetMilliseconds = 1.0);
+
+	// - Takes a 'GLSurface' out of the 'vglSurfaces' vector, releases its texture and deletes it
+	template <typename T>
+	void ReleaseSurface(GLSurface<T>* a_pglSurface);
+
 	// - Pushes a 'GLSurface' of type int into the 'vglSurfaces' vector
 	void PushSurface(GLSurface<int>* a_glSurface);
 	// - Pushes a 'GLSurface' of type float into the 'vglSurfaces' vector
@@ -164,7 +196,7 @@ namespace Graphics
 	template <typename T>
 	void DrawCircle(const System::Point2D<T> ac_Center, const T ac_Radius, const T ac_Quality, const System::Color<T>& ac_Color);
 
-	void Flip(); // Clears the buffer of all windows to allow all the new information to be displayed
+	void Flip(); // Clears the buffer of all windows to allow all the new information to be displayed. Call inside a 'GLState::Untracked' scope
 
 	void Quit();
 }
@@ -201,35 +233,95 @@ namespace Graphics
 	template <typename T>
 	GLSurface<T>* LoadSurface(const char* ac_szFilename)
 	{
-		SDL_Surface* sdlSurface;
+		const std::string sPath = TextureCache::NormalizePath(ac_szFilename);
+		const std::string sKey = TextureCache::PathKey(sPath, IsPremultipliedAlpha());
 
-		sdlSurface = IMG_Load(ac_szFilename);
-		if (sdlSurface == NULL)
+		System::Size2D<int> Size;
+		GLuint uiTexture = TextureCache::Acquire(sKey, Size);
+
+		AssetPack::PackedImage packedImage;
+		if (uiTexture == 0 && AssetPack::Find(sPath, packedImage))
 		{
-			printf("SDL_Error: %s\n", SDL_GetError());
+			Size = packedImage.Size;
+
+			// Packs hold straight alpha, so the pixels are only copied when they need premultiplying
+			SDL_Surface* sdlPacked = SDL_CreateRGBSurfaceFrom((void*)packedImage.pPixels, Size.W, Size.H, 32, Size.W * 4,
+				0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+			uiTexture = UploadTexture(*sdlPacked, true);
+			SDL_FreeSurface(sdlPacked);
+
+			// Nothing is cached when the upload failed, so the next load tries again
+			if (uiTexture == 0)
+				return nullptr;
+			uiTexture = TextureCache::Insert(sKey, uiTexture, Size);
+		}
 
-			GLSurface<T> *glSurface = nullptr;
-			return glSurface;
+		if (uiTexture == 0)
+		{
+			SDL_Surface* sdlSurface;
+
+			sdlSurface = IMG_Load(ac_szFilename);
+			if (sdlSurface == NULL)
+			{
+				printf("SDL_Error: %s\n", SDL_GetError());
+
+				GLSurface<T> *glSurface = nullptr;
+				return glSurface;
+			}
+
+			Size = { sdlSurface->w, sdlSurface->h };
+			uiTexture = UploadTexture(*sdlSurface);
+
+			SDL_FreeSurface(sdlSurface);
+
+			if (uiTexture == 0)
+				return nullptr;
+			uiTexture = TextureCache::Insert(sKey, uiTexture, Size);
 		}
 
-		return LoadSurface<T>(*sdlSurface);
+		GLSurface<T>* glSurface = NewSurface<T>(uiTexture, Size);
+		std::sort(vglSurfaces.begin(), vglSurfaces.end(), SortCamera);
+		std::sort(vglSurfaces.begin(), vglSurfaces.end(), SortLayer);
+
+		return glSurface;
 	}
 	template <typename T>
 	GLSurface<T>* LoadSurface(SDL_Surface& a_sdlSurface)
+	{
+		const std::string sKey = TextureCache::HashSurface(a_sdlSurface, IsPremultipliedAlpha());
+
+		System::Size2D<int> Size = { a_sdlSurface.w, a_sdlSurface.h };
+		GLuint uiTexture = TextureCache::Acquire(sKey, Size);
+		if (uiTexture == 0)
+		{
+			uiTexture = UploadTexture(a_sdlSurface);
+			if (uiTexture != 0)
+				uiTexture = TextureCache::Insert(sKey, uiTexture, Size);
+		}
+
+		SDL_FreeSurface(&a_sdlSurface);
+		if (uiTexture == 0)
+			return nullptr;
+
+		GLSurface<T>* glSurface = NewSurface<T>(uiTexture, Size);
+		std::sort(vglSurfaces.begin(), vglSurfaces.end(), SortCamera);
+		std::sort(vglSurfaces.begin(), vglSurfaces.end(), SortLayer);
+
+		return glSurface;
+	}
+
+	template <typename T>
+	GLSurface<T>* NewSurface(const GLuint ac_uiTexture, const System::Size2D<int>& ac_Size)
 	{
 		GLSurface<T>* glSurface = new GLSurface<T>;
 
-		glGenTextures(1, &glSurface->Surface);
-		glBindTexture(GL_TEXTURE_2D, glSurface->Surface);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, a_sdlSurface.w, a_sdlSurface.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, a_sdlSurface.pixels);
+		glSurface->Surface = ac_uiTexture;
 
 		glSurface->Pos = { NULL, NULL };
 		glSurface->OffsetP = { NULL, NULL };
 
-		glSurface->Dimensions.W = a_sdlSurface.w;
-		glSurface->Dimensions.H = a_sdlSurface.h;
+		glSurface->Dimensions.W = (T)ac_Size.W;
+		glSurface->Dimensions.H = (T)ac_Size.H;
 
 		glSurface->Center.X = glSurface->Dimensions.W / 2.0f;
 		glSurface->Center.Y = glSurface->Dimensions.H / 2.0f;
@@ -248,23 +340,133 @@ namespace Graphics
 
 		glSurface->bIsActive = true;
 
-		SDL_FreeSurface(&a_sdlSurface);
-
 		PushSurface(glSurface);
-		std::sort(vglSurfaces.begin(), vglSurfaces.end(), SortCamera);
-		std::sort(vglSurfaces.begin(), vglSurfaces.end(), SortLayer);
 
 		return glSurface;
 	}
+	inline GLuint UploadTexture(const SDL_Surface& ac_sdlSurface, const bool ac_bPersistent)
+	{
+		const System::Size2D<int> Size = { ac_sdlSurface.w, ac_sdlSurface.h };
+
+		const bool bPremultiply = IsPremultipliedAlpha();
+		if (IsUploadReady(ac_sdlSurface) && !bPremultiply)
+			return UploadTexture(ac_sdlSurface.pixels, Size, ac_bPersistent);
+
+		SDL_Surface* sdlConverted = ConvertSurface(ac_sdlSurface, bPremultiply);
+		if (sdlConverted == nullptr)
+		{
+			printf("SDL_Error: %s\n", SDL_GetError());
+			return 0;
+		}
+
+		const GLuint uiTexture = UploadTexture(sdlConverted->pixels, Size);
+		SDL_FreeSurface(sdlConverted);
+
+		return uiTexture;
+	}
+	inline GLuint UploadTexture(const void* ac_pPixels, const System::Size2D<int>& ac_Size, const bool ac_bPersistent)
+	{
+		GLuint uiTexture;
+
+		glGenTextures(1, &uiTexture);
+		GLState::BindTexture(uiTexture);
+
+		// Known up front so the depth pass of 'DrawCameras' can draw surfaces nothing shows through front to back
+		TextureCache::SetOpaque(uiTexture, PixelConvert::IsOpaque(ac_pPixels, ac_Size.W, ac_Size.H, ac_Size.W * 4));
+
+		if (IsResidencyManaged())
+		{
+			Residency::Manage(uiTexture, ac_pPixels, ac_Size, ac_bPersistent);
+
+			return uiTexture;
+		}
+
+		if (AreMipmapsEnabled())
+		{
+			Mipmap::Chain chain;
+			Mipmap::Build(ac_pPixels, ac_Size, ac_Size.W * 4, chain);
+			Mipmap::Attach(uiTexture, chain, false);
+
+			return uiTexture;
+		}
+
+		Mipmap::ApplyFilter(GetDefaultFilter(), false);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, ac_Size.W, ac_Size.H, 0, GL_RGBA, GL_UNSIGNED_BYTE, ac_pPixels);
+		Stats::AddTextureUpload(ac_Size.W * ac_Size.H * 4);
+		GLState::TextureUploaded();
+
+		return uiTexture;
+	}
 
 	template <typename T>
-	void DrawRect(const System::Point2D<T>& ac_Pos, const System::Size2D<T>& ac_Size, const System::Color<T>& ac_Color)
+	void SetSurfaceFilter(GLSurface<T>* a_pglSurface, const FilterMode ac_eFilter)
+	{
+		SetTextureFilter(a_pglSurface->Surface, ac_eFilter);
+	}
+	inline void UpdateTextureStreaming(const double ac_dBudgetMilliseconds)
+	{
+		// With no cameras nothing is drawn, so there is no reason to drop or stream anything
+		if (voCameras.empty())
+			return;
+
+		/* - The most zoomed in camera decides, since any texture could be drawn by it
+		   A camera's units are its window's resolution, which the window stretches to its dimensions, so that ratio counts as zoom too
+		*/
+		float fMaxZoom = 0.0f;
+		for (unsigned int i = 0; i < voCameras.size(); ++i)
+		{
+			const System::Size2D<float> Zoom = voCameras[i]->Tag == CameraUnion::FLOAT ?
+				voCameras[i]->fCamera->GetZoom() :
+				System::Size2D<float>{ (float)voCameras[i]->iCamera->GetZoom().W, (float)voCameras[i]->iCamera->GetZoom().H };
+			Window* pWindow = voWindows[voCameras[i]->Tag == CameraUnion::FLOAT ? voCameras[i]->fCamera->GetWindowIndex() : voCameras[i]->iCamera->GetWindowIndex()];
+
+			const float fStretchW = (float)pWindow->GetDimensions().W / (float)pWindow->GetResolution().W;
+			const float fStretchH = (float)pWindow->GetDimensions().H / (float)pWindow->GetResolution().H;
+			fMaxZoom = std::max(fMaxZoom, std::max(fabsf(Zoom.W) * fStretchW, fabsf(Zoom.H) * fStretchH));
+		}
+
+		// - The most scaled up streamed surface decides as well, since its texels are drawn that much larger
+		float fMaxScale = 0.0f;
+		for (unsigned int i = 0; i < vglSurfaces.size(); ++i)
+		{
+			const GLuint uiTexture = vglSurfaces[i]->Tag == SurfaceUnion::FLOAT ? vglSurfaces[i]->fGLSurface->Surface : vglSurfaces[i]->iGLSurface->Surface;
+			const std::unordered_map<GLuint, Mipmap::Texture>::const_iterator Found = Mipmap::Get().mTextures.find(uiTexture);
+			if (Found == Mipmap::Get().mTextures.end() || !Found->second.bStreamed)
+				continue;
+
+			const System::Size2D<float> Scale = vglSurfaces[i]->Tag == SurfaceUnion::FLOAT ?
+				vglSurfaces[i]->fGLSurface->Scale :
+				System::Size2D<float>{ (float)vglSurfaces[i]->iGLSurface->Scale.W, (float)vglSurfaces[i]->iGLSurface->Scale.H };
+			fMaxScale = std::max(fMaxScale, std::max(fabsf(Scale.W), fabsf(Scale.H)));
+		}
+
+		Mipmap::Stream(fMaxZoom * fMaxScale, (Uint64)(ac_dBudgetMilliseconds * SDL_GetPerformanceFrequency() / 1000.0));
+	}
+
+	template <typename T>
+	void ReleaseSurface(GLSurface<T>* a_pglSurface)
 	{
-		glPushMatrix(); // Save the current matrix.
+		for (unsigned int i = 0; i < vglSurfaces.size(); ++i)
+		{
+			const void* pSurface = vglSurfaces[i]->Tag == SurfaceUnion::FLOAT ? (void*)vglSurfaces[i]->fGLSurface : (void*)vglSurfaces[i]->iGLSurface;
+			if (pSurface == a_pglSurface)
+			{
+				delete vglSurfaces[i];
+				vglSurfaces.erase(vglSurfaces.begin() + i); // Erased in place so the vector stays sorted
+				break;
+			}
+		}
 
-		glBindTexture(GL_TEXTURE_2D, NULL);
+		TextureCache::Release(a_pglSurface->Surface);
+		delete a_pglSurface;
+	}
 
-		glColor4ub(ac_Color.Red, ac_Color.Green, ac_Color.Blue, ac_Color.Alpha);
+	template <typename T>
+	void DrawRect(const System::Point2D<T>& ac_Pos, const System::Size2D<T>& ac_Size, const System::Color<T>& ac_Color)
+	{
+		// None of the primitives touch the matrix, and 'GLState' skips the texture and color when they're already set
+		GLState::BindTexture(0);
+		GLState::Color((GLubyte)ac_Color.Red, (GLubyte)ac_Color.Green, (GLubyte)ac_Color.Blue, (GLubyte)ac_Color.Alpha);
 		glBegin(GL_QUADS);
 		{
 			//Bottom-left vertex (corner)
@@ -280,17 +482,13 @@ namespace Graphics
 			glVertex3f(ac_Pos.X, ac_Pos.Y + ac_Size.H, 0.f);
 		}
 		glEnd();
-
-		glPopMatrix(); // Reset the current matrix to the one that was saved.
+		Stats::AddDraw(PRIMITIVE_RECT, 4);
 	}
 	template <typename T>
 	void DrawLine(const System::Point2D<T>& ac_Begin, const System::Point2D<T>& ac_End, const System::Color<T>& ac_Color)
 	{
-		glPushMatrix(); // Save the current matrix.
-
-		glBindTexture(GL_TEXTURE_2D, NULL);
-
-		glColor4ub(ac_Color.Red, ac_Color.Green, ac_Color.Blue, ac_Color.Alpha);
+		GLState::BindTexture(0);
+		GLState::Color((GLubyte)ac_Color.Red, (GLubyte)ac_Color.Green, (GLubyte)ac_Color.Blue, (GLubyte)ac_Color.Alpha);
 
 		glBegin(GL_LINES);
 		{
@@ -298,32 +496,24 @@ namespace Graphics
 			glVertex2f(ac_End.X, ac_End.Y);
 		}
 		glEnd();
-
-		glPopMatrix(); // Reset the current matrix to the one that was saved.
+		Stats::AddDraw(PRIMITIVE_LINE, 2);
 	}
 	template <typename T>
 	void DrawPoint(const System::Point2D<T>& ac_Pos, const System::Color<T>& ac_Color)
 	{
-		glPushMatrix(); // Save the current matrix.
-
-		glBindTexture(GL_TEXTURE_2D, NULL);
-
-		glColor4ub(ac_Color.Red, ac_Color.Green, ac_Color.Blue, ac_Color.Alpha);
+		GLState::BindTexture(0);
+		GLState::Color((GLubyte)ac_Color.Red, (GLubyte)ac_Color.Green, (GLubyte)ac_Color.Blue, (GLubyte)ac_Color.Alpha);
 
 		glBegin(GL_POINTS);
 		glVertex2f(ac_Pos.X, ac_Pos.Y);
 		glEnd();
-
-		glPopMatrix(); // Reset the current matrix to the one that was saved.
+		Stats::AddDraw(PRIMITIVE_POINT, 1);
 	}
 	template <typename T>
 	void DrawRing(const System::Point2D<T> ac_Center, const T ac_Radius, const T ac_Quality, const System::Color<T>& ac_Color)
 	{
-		glPushMatrix(); // Save the current matrix.
-
-		glBindTexture(GL_TEXTURE_2D, NULL);
-
-		glColor4ub(ac_Color.Red, ac_Color.Green, ac_Color.Blue, ac_Color.Alpha);
+		GLState::BindTexture(0);
+		GLState::Color((GLubyte)ac_Color.Red, (GLubyte)ac_Color.Green, (GLubyte)ac_Color.Blue, (GLubyte)ac_Color.Alpha);
 
 		glBegin(GL_LINE_LOOP);
 		{
@@ -335,17 +525,13 @@ namespace Graphics
 			}
 		}
 		glEnd();
-
-		glPopMatrix(); // Reset the current matrix to the one that was saved.
+		Stats::AddDraw(PRIMITIVE_RING, (unsigned int)ac_Quality + 1);
 	}
 	template <typename T>
 	void DrawCircle(const System::Point2D<T> ac_Center, const T ac_Radius, const T ac_Quality, const System::Color<T>& ac_Color)
 	{
-		glPushMatrix(); // Save the current matrix.
-
-		glBindTexture(GL_TEXTURE_2D, NULL);
-
-		glColor4ub(ac_Color.Red, ac_Color.Green, ac_Color.Blue, ac_Color.Alpha);
+		GLState::BindTexture(0);
+		GLState::Color((GLubyte)ac_Color.Red, (GLubyte)ac_Color.Green, (GLubyte)ac_Color.Blue, (GLubyte)ac_Color.Alpha);
 
 		glBegin(GL_TRIANGLE_FAN);
 		{
@@ -358,8 +544,7 @@ namespace Graphics
 			}
 		}
 		glEnd();
-
-		glPopMatrix(); // Reset the current matrix to the one that was saved.
+		Stats::AddDraw(PRIMITIVE_CIRCLE, (unsigned int)ac_Quality + 2);
 	}
 }
 #endif // _GRAPHICS_H_
@@ -0,0 +1,480 @@
+//////////////////////////////////////////////////////////////
+// File: Mipmap.h
+// Author: Ben Odom
+// Brief: Builds mip chains on the CPU with a 2x2 box filter
+//		  and sets how each texture is filtered. Streaming
+//		  keeps the chain in memory and only the levels the
+//		  most zoomed in camera can see uploaded, adding the
+//		  finer levels back as soon as a camera zooms in
+//////////////////////////////////////////////////////////////
+
+#ifndef _MIPMAP_H_
+#define _MIPMAP_H_
+
+#include "GLState.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define MIPMAP_SSE
+#include <emmintrin.h>
+#endif
+
+// OpenGL 1.2, missing from the 1.1 headers Windows ships
+#ifndef GL_TEXTURE_BASE_LEVEL
+#define GL_TEXTURE_BASE_LEVEL 0x813C
+#endif
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+
+namespace Graphics
+{
+	// How a texture is sampled when it is drawn smaller (minified) or larger (magnified) than it is
+	enum FilterMode
+	{
+		FILTER_NEAREST,			   // Blocky both ways. What every texture used before filter modes
+		FILTER_LINEAR,			   // Smooth both ways, without mips
+		FILTER_MIPMAP_NEAREST_MAG, // Blends mips when minified, blocky when magnified. Suits pixel art that zooms out
+		FILTER_TRILINEAR		   // Smooth both ways, blending mips when minified
+	};
+
+	// What mipmapping and streaming are holding
+	struct MipmapStats
+	{
+		unsigned int uiTextures;	  // Textures with a mip chain
+		unsigned int uiStreamed;	  // Of those, how many keep their chain in memory to stream from
+		unsigned int uiResidentBytes; // What the textures with a chain take up on the GPU
+		unsigned int uiSourceBytes;	  // What the chains kept for streaming take up in memory
+
+		unsigned int uiLevelsUploaded; // Since the program started
+		unsigned int uiLevelsDropped;
+
+		int iTargetLevel; // The finest level streaming keeps uploaded
+	};
+
+	// - Whether textures loaded from now on get a mip chain. Off by default
+	void SetMipmaps(const bool ac_bEnabled);
+	bool AreMipmapsEnabled();
+	// - Whether textures loaded from now on keep their mip chain in memory and only upload the levels cameras need
+	//   Needs mipmaps on. Call 'UpdateTextureStreaming' once a frame for it to follow the cameras
+	void SetTextureStreaming(const bool ac_bEnabled);
+	bool IsTextureStreaming();
+
+	// - The filter textures get when they are loaded. 'FILTER_NEAREST' by default
+	void SetDefaultFilter(const FilterMode ac_eFilter);
+	FilterMode GetDefaultFilter();
+	// - Sets how one texture is filtered. A mip filter on a texture without a chain uses the filter without mips
+	void SetTextureFilter(const GLuint ac_uiTexture, const FilterMode ac_eFilter);
+
+	// - Returns what mipmapping and streaming are holding
+	const MipmapStats& GetMipmapStats();
+
+	namespace Mipmap
+	{
+		const int kiMaxLevels = 16;	   // Enough for a 32768 pixel texture
+		const int kiDropFrames = 120; // How long cameras have to stay zoomed out before finer levels are dropped
+
+		// Every level of one image, finest first, tightly packed RGBA
+		struct Chain
+		{
+			System::Size2D<int> Size;
+			int iLevels;
+			size_t auiOffsets[kiMaxLevels];
+			std::vector<Uint8> vPixels;
+		};
+
+		// One texture with a chain
+		struct Texture
+		{
+			Chain chain;	   // Only kept when streaming
+			int iBaseLevel;	   // The finest level uploaded
+			bool bStreamed;
+			FilterMode eFilter;
+		};
+
+		struct Registry
+		{
+			std::unordered_map<GLuint, Texture> mTextures;
+
+			bool bEnabled;
+			bool bStreaming;
+			FilterMode eDefaultFilter;
+
+			int iTargetLevel;	// The finest level streamed textures should have uploaded
+			int iCoarserFrames; // How many updates in a row the cameras have wanted a coarser level
+			bool bSettled;		// Every streamed texture is at the target level
+
+			MipmapStats Stats;
+		};
+
+		// - Returns the one registry shared by everything that includes this file. Only use it from the thread that draws
+		Registry& Get();
+
+		// - Returns how many levels an image of 'ac_Size' has, down to 1x1
+		int CountLevels(const System::Size2D<int>& ac_Size);
+		// - Returns the size of level 'ac_iLevel' of an image of 'ac_Size'
+		System::Size2D<int> LevelSize(const System::Size2D<int>& ac_Size, const int ac_iLevel);
+		// - Returns the bytes taken up by levels 'ac_iFirst' onwards
+		unsigned int LevelBytes(const System::Size2D<int>& ac_Size, const int ac_iFirst);
+		// - Returns the finest level worth uploading for a texel drawn 'ac_fZoom' window pixels wide
+		int LevelForZoom(const float ac_fZoom);
+
+		// - Halves an RGBA image, averaging each 2x2 block. An odd last row or column is averaged with itself
+		void Downsample(const Uint8* ac_pSource, const System::Size2D<int>& ac_Size, const int ac_iPitch, Uint8* a_pDestination);
+		// - Builds every level of an RGBA image into 'a_Chain', level 0 included
+		void Build(const void* ac_pPixels, const System::Size2D<int>& ac_Size, const int ac_iPitch, Chain& a_Chain);
+
+		/* - Gives a texture its mip chain and uploads the levels it needs. The texture must be bound
+		   'ac_bLevel0Uploaded' is true if level 0 was uploaded already, as the 'SurfaceLoader' does a strip at a time
+		   The chain is moved from, and kept if streaming
+		*/
+		void Attach(const GLuint ac_uiTexture, Chain& a_Chain, const bool ac_bLevel0Uploaded);
+		// - Whether a texture has a chain
+		bool IsKnown(const GLuint ac_uiTexture);
+		// - Forgets a texture that is about to be deleted
+		void Forget(const GLuint ac_uiTexture);
+
+		// - Uploads or drops levels of streamed textures so the finest is right for texels drawn 'ac_fMaxZoom' window pixels wide
+		//   Stops once 'ac_uiBudgetTicks' have passed, carrying on at the next call. 0 has no budget
+		void Stream(const float ac_fMaxZoom, const Uint64 ac_uiBudgetTicks);
+
+		// - Uploads levels 'ac_iFirst' up to 'ac_iLast' of a bound texture from its chain
+		void UploadLevels(Texture& a_Texture, const int ac_iFirst, const int ac_iLast);
+		// - Makes 'ac_iLevel' the finest level of a bound texture, freeing or uploading levels to match
+		void SetBaseLevel(Texture& a_Texture, const int ac_iLevel);
+		// - Sets the filter parameters of a bound texture
+		void ApplyFilter(const FilterMode ac_eFilter, const bool ac_bHasMips);
+	}
+}
+
+namespace Graphics
+{
+	inline Mipmap::Registry& Mipmap::Get()
+	{
+		static Registry registry = {};
+
+		return registry;
+	}
+
+	inline void SetMipmaps(const bool ac_bEnabled)
+	{
+		Mipmap::Get().bEnabled = ac_bEnabled;
+	}
+	inline bool AreMipmapsEnabled()
+	{
+		return Mipmap::Get().bEnabled;
+	}
+	inline void SetTextureStreaming(const bool ac_bEnabled)
+	{
+		Mipmap::Get().bStreaming = ac_bEnabled;
+	}
+	inline bool IsTextureStreaming()
+	{
+		return Mipmap::Get().bEnabled && Mipmap::Get().bStreaming;
+	}
+
+	inline void SetDefaultFilter(const FilterMode ac_eFilter)
+	{
+		Mipmap::Get().eDefaultFilter = ac_eFilter;
+	}
+	inline FilterMode GetDefaultFilter()
+	{
+		return Mipmap::Get().eDefaultFilter;
+	}
+	inline void SetTextureFilter(const GLuint ac_uiTexture, const FilterMode ac_eFilter)
+	{
+		Mipmap::Registry& registry = Mipmap::Get();
+
+		GLState::BindTexture(ac_uiTexture);
+
+		const std::unordered_map<GLuint, Mipmap::Texture>::iterator Found = registry.mTextures.find(ac_uiTexture);
+		if (Found != registry.mTextures.end())
+			Found->second.eFilter = ac_eFilter;
+
+		Mipmap::ApplyFilter(ac_eFilter, Found != registry.mTextures.end());
+	}
+
+	inline const MipmapStats& GetMipmapStats()
+	{
+		return Mipmap::Get().Stats;
+	}
+
+	inline int Mipmap::CountLevels(const System::Size2D<int>& ac_Size)
+	{
+		int iLevels = 1;
+		for (int iLargest = std::max(ac_Size.W, ac_Size.H); iLargest > 1 && iLevels < kiMaxLevels; iLargest /= 2)
+			++iLevels;
+
+		return iLevels;
+	}
+	inline System::Size2D<int> Mipmap::LevelSize(const System::Size2D<int>& ac_Size, const int ac_iLevel)
+	{
+		const System::Size2D<int> Size = { std::max(ac_Size.W >> ac_iLevel, 1), std::max(ac_Size.H >> ac_iLevel, 1) };
+
+		return Size;
+	}
+	inline unsigned int Mipmap::LevelBytes(const System::Size2D<int>& ac_Size, const int ac_iFirst)
+	{
+		unsigned int uiBytes = 0;
+		for (int iLevel = ac_iFirst; iLevel < CountLevels(ac_Size); ++iLevel)
+		{
+			const System::Size2D<int> Size = LevelSize(ac_Size, iLevel);
+			uiBytes += Size.W * Size.H * 4;
+		}
+
+		return uiBytes;
+	}
+	inline int Mipmap::LevelForZoom(const float ac_fZoom)
+	{
+		// At half a pixel per texel level 1 maps a texel to a pixel, at a quarter level 2, and so on. Magnified always needs level 0
+		if (ac_fZoom >= 1.0f || ac_fZoom <= 0.0f)
+			return 0;
+
+		return std::min((int)std::floor(-std::log2(ac_fZoom) + 0.001f), kiMaxLevels - 1);
+	}
+
+	inline void Mipmap::Downsample(const Uint8* ac_pSource, const System::Size2D<int>& ac_Size, const int ac_iPitch, Uint8* a_pDestination)
+	{
+		const System::Size2D<int> Half = LevelSize(ac_Size, 1);
+
+		for (int iRow = 0; iRow < Half.H; ++iRow)
+		{
+			const Uint8* pTop = ac_pSource + (iRow * 2) * ac_iPitch;
+			const Uint8* pBottom = ac_pSource + std::min(iRow * 2 + 1, ac_Size.H - 1) * ac_iPitch;
+			Uint8* pDestination = a_pDestination + iRow * Half.W * 4;
+
+			int i = 0;
+#ifdef MIPMAP_SSE
+			// 4 source pixels from each row make 2, summed at 16 bits a channel so nothing is lost before the divide
+			const __m128i xZero = _mm_setzero_si128();
+			const __m128i xRound = _mm_set1_epi16(2);
+			for (; (i + 2) * 2 <= ac_Size.W; i += 2)
+			{
+				const __m128i xTop = _mm_loadu_si128((const __m128i*)(pTop + i * 8));
+				const __m128i xBottom = _mm_loadu_si128((const __m128i*)(pBottom + i * 8));
+
+				const __m128i xLow = _mm_add_epi16(_mm_unpacklo_epi8(xTop, xZero), _mm_unpacklo_epi8(xBottom, xZero));
+				const __m128i xHigh = _mm_add_epi16(_mm_unpackhi_epi8(xTop, xZero), _mm_unpackhi_epi8(xBottom, xZero));
+
+				// Each half holds 2 pixels, so adding the half shifted down by a pixel sums the pair in the low pixel
+				const __m128i xSums = _mm_unpacklo_epi64(_mm_add_epi16(xLow, _mm_srli_si128(xLow, 8)), _mm_add_epi16(xHigh, _mm_srli_si128(xHigh, 8)));
+				const __m128i xAverage = _mm_srli_epi16(_mm_add_epi16(xSums, xRound), 2);
+
+				_mm_storel_epi64((__m128i*)(pDestination + i * 4), _mm_packus_epi16(xAverage, xZero));
+			}
+#endif
+			for (; i < Half.W; ++i)
+			{
+				const int iLeft = i * 2 * 4;
+				const int iRight = std::min(i * 2 + 1, ac_Size.W - 1) * 4;
+				for (int iChannel = 0; iChannel < 4; ++iChannel)
+				{
+					pDestination[i * 4 + iChannel] = (Uint8)((pTop[iLeft + iChannel] + pTop[iRight + iChannel] +
+						pBottom[iLeft + iChannel] + pBottom[iRight + iChannel] + 2) >> 2);
+				}
+			}
+		}
+	}
+	inline void Mipmap::Build(const void* ac_pPixels, const System::Size2D<int>& ac_Size, const int ac_iPitch, Chain& a_Chain)
+	{
+		a_Chain.Size = ac_Size;
+		a_Chain.iLevels = CountLevels(ac_Size);
+
+		size_t uiBytes = 0;
+		for (int iLevel = 0; iLevel < a_Chain.iLevels; ++iLevel)
+		{
+			const System::Size2D<int> Size = LevelSize(ac_Size, iLevel);
+			a_Chain.auiOffsets[iLevel] = uiBytes;
+			uiBytes += Size.W * Size.H * 4;
+		}
+		a_Chain.vPixels.resize(uiBytes);
+
+		for (int iRow = 0; iRow < ac_Size.H; ++iRow)
+			memcpy(&a_Chain.vPixels[iRow * ac_Size.W * 4], (const Uint8*)ac_pPixels + iRow * ac_iPitch, ac_Size.W * 4);
+
+		// Each level is made from the one before it, which is still in the cache if it was small enough
+		for (int iLevel = 1; iLevel < a_Chain.iLevels; ++iLevel)
+		{
+			const System::Size2D<int> Finer = LevelSize(ac_Size, iLevel - 1);
+			Downsample(&a_Chain.vPixels[a_Chain.auiOffsets[iLevel - 1]], Finer, Finer.W * 4, &a_Chain.vPixels[a_Chain.auiOffsets[iLevel]]);
+		}
+	}
+
+	inline void Mipmap::UploadLevels(Texture& a_Texture, const int ac_iFirst, const int ac_iLast)
+	{
+		Registry& registry = Get();
+		const Chain& chain = a_Texture.chain;
+
+		for (int iLevel = ac_iFirst; iLevel <= ac_iLast; ++iLevel)
+		{
+			const System::Size2D<int> Size = LevelSize(chain.Size, iLevel);
+			glTexImage2D(GL_TEXTURE_2D, iLevel, GL_RGBA, Size.W, Size.H, 0, GL_RGBA, GL_UNSIGNED_BYTE, &chain.vPixels[chain.auiOffsets[iLevel]]);
+
+			Stats::AddTextureUpload(Size.W * Size.H * 4);
+			GLState::TextureUploaded();
+			registry.Stats.uiResidentBytes += Size.W * Size.H * 4;
+			++registry.Stats.uiLevelsUploaded;
+		}
+	}
+	inline void Mipmap::SetBaseLevel(Texture& a_Texture, const int ac_iLevel)
+	{
+		Registry& registry = Get();
+
+		// Finer levels are uploaded before the base moves down to them, so the texture is never incomplete
+		if (ac_iLevel < a_Texture.iBaseLevel)
+			UploadLevels(a_Texture, ac_iLevel, a_Texture.iBaseLevel - 1);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, ac_iLevel);
+
+		// Levels below the base aren't sampled, so giving them no size frees them without making the texture incomplete
+		for (int iLevel = a_Texture.iBaseLevel; iLevel < ac_iLevel; ++iLevel)
+		{
+			const System::Size2D<int> Size = LevelSize(a_Texture.chain.Size, iLevel);
+			glTexImage2D(GL_TEXTURE_2D, iLevel, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+			registry.Stats.uiResidentBytes -= Size.W * Size.H * 4;
+			++registry.Stats.uiLevelsDropped;
+		}
+
+		a_Texture.iBaseLevel = ac_iLevel;
+	}
+	inline void Mipmap::ApplyFilter(const FilterMode ac_eFilter, const bool ac_bHasMips)
+	{
+		GLint iMin = GL_NEAREST;
+		GLint iMag = GL_NEAREST;
+		switch (ac_eFilter)
+		{
+		case FILTER_NEAREST:			iMin = GL_NEAREST; iMag = GL_NEAREST; break;
+		case FILTER_LINEAR:				iMin = GL_LINEAR; iMag = GL_LINEAR; break;
+		case FILTER_MIPMAP_NEAREST_MAG: iMin = ac_bHasMips ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR; iMag = GL_NEAREST; break;
+		case FILTER_TRILINEAR:			iMin = ac_bHasMips ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR; iMag = GL_LINEAR; break;
+		}
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, iMin);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, iMag);
+	}
+
+	inline void Mipmap::Attach(const GLuint ac_uiTexture, Chain& a_Chain, const bool ac_bLevel0Uploaded)
+	{
+		Registry& registry = Get();
+
+		Texture& texture = registry.mTextures[ac_uiTexture];
+		texture.chain.Size = a_Chain.Size;
+		texture.chain.iLevels = a_Chain.iLevels;
+		memcpy(texture.chain.auiOffsets, a_Chain.auiOffsets, sizeof(a_Chain.auiOffsets));
+		texture.chain.vPixels.swap(a_Chain.vPixels);
+		texture.bStreamed = IsTextureStreaming();
+		texture.eFilter = registry.eDefaultFilter;
+		texture.iBaseLevel = 0;
+
+		++registry.Stats.uiTextures;
+
+		const int iBase = texture.bStreamed ? std::min(registry.iTargetLevel, texture.chain.iLevels - 1) : 0;
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.chain.iLevels - 1);
+
+		if (ac_bLevel0Uploaded)
+		{
+			const System::Size2D<int> Size = texture.chain.Size;
+			registry.Stats.uiResidentBytes += Size.W * Size.H * 4;
+			UploadLevels(texture, 1, texture.chain.iLevels - 1);
+			SetBaseLevel(texture, iBase);
+		}
+		else
+		{
+			texture.iBaseLevel = iBase;
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, iBase);
+			UploadLevels(texture, iBase, texture.chain.iLevels - 1);
+		}
+		ApplyFilter(texture.eFilter, true);
+
+		if (texture.bStreamed)
+		{
+			++registry.Stats.uiStreamed;
+			registry.Stats.uiSourceBytes += (unsigned int)texture.chain.vPixels.size();
+		}
+		else
+		{
+			std::vector<Uint8>().swap(texture.chain.vPixels);
+		}
+	}
+	inline bool Mipmap::IsKnown(const GLuint ac_uiTexture)
+	{
+		return Get().mTextures.count(ac_uiTexture) != 0;
+	}
+	inline void Mipmap::Forget(const GLuint ac_uiTexture)
+	{
+		Registry& registry = Get();
+
+		const std::unordered_map<GLuint, Texture>::iterator Found = registry.mTextures.find(ac_uiTexture);
+		if (Found == registry.mTextures.end())
+			return;
+
+		const Texture& texture = Found->second;
+		registry.Stats.uiResidentBytes -= LevelBytes(texture.chain.Size, texture.iBaseLevel);
+		--registry.Stats.uiTextures;
+		if (texture.bStreamed)
+		{
+			--registry.Stats.uiStreamed;
+			registry.Stats.uiSourceBytes -= (unsigned int)texture.chain.vPixels.size();
+		}
+
+		registry.mTextures.erase(Found);
+	}
+
+	inline void Mipmap::Stream(const float ac_fMaxZoom, const Uint64 ac_uiBudgetTicks)
+	{
+		Registry& registry = Get();
+		const Uint64 uiBegin = SDL_GetPerformanceCounter();
+
+		// Zooming in is followed at once. Zooming out has to last 'kiDropFrames' first, so a quick zoom doesn't thrash
+		const int iWanted = LevelForZoom(ac_fMaxZoom);
+		if (iWanted < registry.iTargetLevel)
+		{
+			registry.iTargetLevel = iWanted;
+			registry.iCoarserFrames = 0;
+			registry.bSettled = false;
+		}
+		else if (iWanted > registry.iTargetLevel)
+		{
+			if (++registry.iCoarserFrames >= kiDropFrames)
+			{
+				registry.iTargetLevel = iWanted;
+				registry.iCoarserFrames = 0;
+				registry.bSettled = false;
+			}
+		}
+		else
+		{
+			registry.iCoarserFrames = 0;
+		}
+		registry.Stats.iTargetLevel = registry.iTargetLevel;
+
+		if (registry.bSettled)
+			return;
+
+		registry.bSettled = true;
+		for (std::unordered_map<GLuint, Texture>::iterator it = registry.mTextures.begin(); it != registry.mTextures.end(); ++it)
+		{
+			Texture& texture = it->second;
+			const int iBase = std::min(registry.iTargetLevel, texture.chain.iLevels - 1);
+			if (!texture.bStreamed || texture.iBaseLevel == iBase)
+				continue;
+
+			if (ac_uiBudgetTicks != 0 && SDL_GetPerformanceCounter() - uiBegin >= ac_uiBudgetTicks)
+			{
+				registry.bSettled = false;
+				break;
+			}
+
+			GLState::BindTexture(it->first);
+			SetBaseLevel(texture, iBase);
+		}
+	}
+}
+
+#endif // _MIPMAP_H_
@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////
+// File: PerfCounters.h
+// Author: Ben Odom
+// Brief: The layout of the shared memory a running game
+//		  publishes its frame counters in, so another process
+//		  can watch it without a debugger or a log. The game
+//		  writes a new frame into it every frame under a
+//		  sequence lock: readers never block the writer, and
+//		  retry whenever a frame was changing while they read
+//////////////////////////////////////////////////////////////
+
+#ifndef _PERFCOUNTERS_H_
+#define _PERFCOUNTERS_H_
+
+#include <SDL_stdinc.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+/* Layout of a segment, native byte order, with the same offsets in 32 and 64 bit builds:
+   - 'SegmentHeader', written once when the segment is made, except 'uiClosed'
+   - 'uiSequence', odd while a frame is being written
+   - 'FrameCounters', the last frame published
+   Segments are named after the process that publishes them, see 'SegmentName'
+*/
+namespace Graphics
+{
+	namespace PerfCounters
+	{
+		const char kaMagic[4] = { 'P', 'C', 'N', 'T' };
+		const Uint32 kuiVersion = 1;		 // Goes up whenever anything below changes
+		const unsigned int kuiHistory = 128; // Frame times kept, so a reader sampling now and then still sees every frame
+		const unsigned int kuiNameLength = 16;
+
+		// The parts of a frame timed on their own
+		enum Phase
+		{
+			PHASE_EVENTS,
+			PHASE_UPDATE,
+			PHASE_LATE_UPDATE,
+			PHASE_DRAW,
+			PHASE_PRESENT,
+			PHASE_COUNT
+		};
+
+		struct SegmentHeader
+		{
+			char   aMagic[4];
+			Uint32 uiVersion;
+			Uint32 uiSize;	   // Of the whole segment, so a reader can check it agrees on the layout
+			Uint32 uiProcess;  // The ID of the process publishing
+			Uint32 uiClosed;   // Set once the process has stopped publishing
+			Uint32 uiPadding;
+			char   aaPhaseNames[PHASE_COUNT][kuiNameLength]; // Null terminated
+		};
+
+		struct FrameCounters
+		{
+			Uint64 ullFrame;	// How many frames have been published, counting this one
+			Uint64 ullTicks;	// 'SDL_GetPerformanceCounter' when it was published
+			Uint64 ullTicksPerSecond;
+
+			double dFrameMilliseconds; // Since the frame before was published, including waiting for vsync
+			double dCpuMilliseconds;   // From the start of the frame until it was handed to 'Present'
+			double adPhaseMilliseconds[PHASE_COUNT];
+
+			Uint32 uiDrawCalls;
+			Uint32 uiTextureBinds;
+			Uint32 uiVertices;
+			Uint32 uiSurfacesDrawn;	 // By every camera together
+			Uint32 uiSurfacesCulled;
+			Uint32 uiSurfaces;		 // Loaded, drawn or not
+			Uint32 uiTextures;		 // Held by the texture cache
+			Uint32 uiTextureBytes;	 // What those take up on the GPU
+			Uint32 uiTextureUploads; // This frame
+			Uint32 uiTextureUploadBytes;
+			Uint32 uiWindowsFlipped;
+			Uint32 uiPadding;
+
+			float afHistory[kuiHistory]; // Frame times in milliseconds. Frame 'n' is at 'n % kuiHistory'
+		};
+
+		struct Segment
+		{
+			SegmentHeader Header;
+			std::atomic<Uint32> uiSequence;
+			Uint32 uiPadding;
+			FrameCounters Frame;
+		};
+
+		// - Writes the name the segment of process 'ac_uiProcess' is shared under. On Linux it shows up in '/dev/shm'
+		inline void SegmentName(const Uint32 ac_uiProcess, char* a_szName, const size_t ac_uiSize)
+		{
+#ifdef _WIN32
+			snprintf(a_szName, ac_uiSize, "Local\\GraphicsPerfCounters.%u", ac_uiProcess);
+#else
+			snprintf(a_szName, ac_uiSize, "/graphics_perf_counters.%u", ac_uiProcess);
+#endif
+		}
+
+		// - Whether a segment was made by a build with this layout
+		inline bool IsValid(const Segment& ac_Segment)
+		{
+			return memcmp(ac_Segment.Header.aMagic, kaMagic, sizeof(kaMagic)) == 0 && ac_Segment.Header.uiVersion == kuiVersion &&
+				ac_Segment.Header.uiSize == sizeof(Segment);
+		}
+
+		// - Writes a frame. Only the publishing process may call it, and only from one thread
+		inline void Write(Segment& a_Segment, const FrameCounters& ac_Frame)
+		{
+			// An odd sequence tells readers the frame is being changed, and the fences keep the copy between the two stores
+			const Uint32 uiSequence = a_Segment.uiSequence.load(std::memory_order_relaxed);
+			a_Segment.uiSequence.store(uiSequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			memcpy(&a_Segment.Frame, &ac_Frame, sizeof(FrameCounters));
+
+			a_Segment.uiSequence.store(uiSequence + 2, std::memory_order_release);
+		}
+
+		// - Copies the last frame written. Returns false if it was being written every time it was tried
+		inline bool Read(const Segment& ac_Segment, FrameCounters& a_Frame, const unsigned int ac_uiTries = 100)
+		{
+			for (unsigned int i = 0; i < ac_uiTries; ++i)
+			{
+				const Uint32 uiBefore = ac_Segment.uiSequence.load(std::memory_order_acquire);
+				if (uiBefore & 1)
+					continue;
+
+				memcpy(&a_Frame, (const void*)&ac_Segment.Frame, sizeof(FrameCounters));
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (ac_Segment.uiSequence.load(std::memory_order_relaxed) == uiBefore)
+					return true;
+			}
+			return false;
+		}
+	}
+}
+
+#endif // _PERFCOUNTERS_H_
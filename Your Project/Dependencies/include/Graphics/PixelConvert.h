@@ -0,0 +1,465 @@
+//////////////////////////////////////////////////////////////
+// File: PixelConvert.h
+// Author: Ben Odom
+// Brief: Converts decoded images into the RGBA byte order
+//		  every texture is uploaded in. The common layouts
+//		  (RGB, BGR, BGRA, gray and paletted) each have a row
+//		  loop written with SSE2 or SSSE3, and can multiply
+//		  the color by alpha in the same pass. Anything else
+//		  goes through 'SDL_ConvertSurfaceFormat'
+//////////////////////////////////////////////////////////////
+
+#ifndef _PIXELCONVERT_H_
+#define _PIXELCONVERT_H_
+
+#include <SDL.h>
+
+#include <atomic>
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define PIXELCONVERT_SSE
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#endif
+
+// GCC and Clang only emit SSSE3 instructions in functions marked for it. Visual Studio emits whatever it is asked for
+#if defined(PIXELCONVERT_SSE) && defined(__GNUC__)
+#define PIXELCONVERT_SSSE3 __attribute__((target("ssse3")))
+#else
+#define PIXELCONVERT_SSSE3
+#endif
+
+namespace Graphics
+{
+	// - Whether images are premultiplied by their alpha as they are loaded. Off by default
+	//   Set it before loading anything. Premultiplied textures are drawn with 'GLState::BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)'
+	void SetPremultipliedAlpha(const bool ac_bPremultiply);
+	bool IsPremultipliedAlpha();
+
+	// - Converts the pixels of any 'SDL_Surface' to RGBA at 'a_pDestination', 'ac_iPitch' bytes apart a row
+	//   Returns false if SDL can't convert the format either
+	bool ConvertToRGBA(const SDL_Surface& ac_sdlSource, void* a_pDestination, const int ac_iPitch, const bool ac_bPremultiply);
+	// - Returns a new RGBA surface (ABGR8888 with tightly packed rows) holding the pixels of 'ac_sdlSource', or nullptr
+	SDL_Surface* ConvertSurface(const SDL_Surface& ac_sdlSource, const bool ac_bPremultiply);
+	// - Whether 'ac_sdlSurface' can be uploaded as it is: RGBA with tightly packed rows
+	bool IsUploadReady(const SDL_Surface& ac_sdlSurface);
+
+	namespace PixelConvert
+	{
+		// How the bytes of a pixel are laid out in memory
+		enum Layout
+		{
+			LAYOUT_RGBA,
+			LAYOUT_BGRA,
+			LAYOUT_RGBX, // 4 bytes, the last unused and treated as opaque
+			LAYOUT_BGRX,
+			LAYOUT_RGB,
+			LAYOUT_BGR,
+			LAYOUT_GRAY,	// 8 bit palette that is a ramp from black to white
+			LAYOUT_INDEXED, // 8 bit palette
+			LAYOUT_OTHER	// Converted by SDL, as is every keyed surface without a palette
+		};
+
+		// - Works out the layout of a surface's pixels from its format
+		Layout GetLayout(const SDL_Surface& ac_sdlSurface);
+
+		// - Converts one row of 'ac_iWidth' pixels to RGBA. 'a_pDestination' may not overlap 'ac_pSource'
+		void RowRGBA(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth);
+		void RowBGRA(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth, const Uint32 ac_uiAlpha);
+		void RowRGBX(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth);
+		void RowRGB(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth, const bool ac_bSwap);
+		void RowGray(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth);
+		void RowIndexed(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth, const Uint32* ac_pPalette);
+
+		// - Multiplies the color of a row of RGBA pixels by their alpha, in place
+		void PremultiplyRow(Uint8* a_pPixels, const int ac_iWidth);
+		// - Whether every one of 'ac_iWidth' by 'ac_iHeight' RGBA pixels, 'ac_iPitch' bytes apart a row, has an alpha of 255
+		bool IsOpaque(const void* ac_pPixels, const int ac_iWidth, const int ac_iHeight, const int ac_iPitch);
+
+		// - Whether the SSSE3 byte shuffle can be used. SDL 2.0.3 can only ask about SSE4.1, which every SSSE3 chip but the first few has
+		bool HasShuffle();
+	}
+}
+
+namespace Graphics
+{
+	namespace PixelConvert
+	{
+		inline std::atomic<bool>& Premultiply()
+		{
+			static std::atomic<bool> bPremultiply(false);
+
+			return bPremultiply;
+		}
+
+		// - Multiplies 'ac_uiColor' by 'ac_uiAlpha' and divides by 255, rounding to nearest, without a division
+		inline Uint32 MultiplyAlpha(const Uint32 ac_uiColor, const Uint32 ac_uiAlpha)
+		{
+			const Uint32 uiProduct = ac_uiColor * ac_uiAlpha + 128;
+			return (uiProduct + (uiProduct >> 8)) >> 8;
+		}
+	}
+
+	inline void SetPremultipliedAlpha(const bool ac_bPremultiply)
+	{
+		PixelConvert::Premultiply() = ac_bPremultiply;
+	}
+	inline bool IsPremultipliedAlpha()
+	{
+		return PixelConvert::Premultiply();
+	}
+
+	inline PixelConvert::Layout PixelConvert::GetLayout(const SDL_Surface& ac_sdlSurface)
+	{
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+		const SDL_PixelFormat& format = *ac_sdlSurface.format;
+
+		// A color key makes one color transparent. Only the palette converter applies it, so SDL converts every other keyed layout
+		Uint32 uiKey;
+		const bool bKeyed = SDL_GetColorKey((SDL_Surface*)&ac_sdlSurface, &uiKey) == 0;
+		if (bKeyed && format.format != SDL_PIXELFORMAT_INDEX8)
+			return LAYOUT_OTHER;
+
+		if (format.BytesPerPixel == 4 && format.Gmask == 0x0000FF00)
+		{
+			if (format.Rmask == 0x000000FF && format.Bmask == 0x00FF0000)
+				return format.Amask == 0xFF000000 ? LAYOUT_RGBA : LAYOUT_RGBX;
+			if (format.Rmask == 0x00FF0000 && format.Bmask == 0x000000FF)
+				return format.Amask == 0xFF000000 ? LAYOUT_BGRA : LAYOUT_BGRX;
+		}
+		else if (format.BytesPerPixel == 3 && format.Gmask == 0x0000FF00)
+		{
+			if (format.Rmask == 0x000000FF && format.Bmask == 0x00FF0000)
+				return LAYOUT_RGB;
+			if (format.Rmask == 0x00FF0000 && format.Bmask == 0x000000FF)
+				return LAYOUT_BGR;
+		}
+		else if (format.format == SDL_PIXELFORMAT_INDEX8 && format.palette != nullptr)
+		{
+			// The gray ramp can't make the keyed index transparent
+			if (bKeyed || format.palette->ncolors != 256)
+				return LAYOUT_INDEXED;
+
+			for (int i = 0; i < 256; ++i)
+			{
+				const SDL_Color& color = format.palette->colors[i];
+				if (color.r != i || color.g != i || color.b != i || color.a != 255)
+					return LAYOUT_INDEXED;
+			}
+			return LAYOUT_GRAY;
+		}
+#endif
+
+		return LAYOUT_OTHER;
+	}
+
+	inline void PixelConvert::RowRGBA(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth)
+	{
+		memcpy(a_pDestination, ac_pSource, ac_iWidth * 4);
+	}
+
+	inline void PixelConvert::RowBGRA(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth, const Uint32 ac_uiAlpha)
+	{
+		// Red and blue trade places, green stays and 'ac_uiAlpha' is ORed in, which makes BGRX opaque
+		int i = 0;
+#ifdef PIXELCONVERT_SSE
+		const __m128i xGreenAlpha = _mm_set1_epi32(0xFF00FF00);
+		const __m128i xLow = _mm_set1_epi32(0x000000FF);
+		const __m128i xAlpha = _mm_set1_epi32((int)ac_uiAlpha);
+		for (; i + 4 <= ac_iWidth; i += 4)
+		{
+			const __m128i xPixels = _mm_loadu_si128((const __m128i*)(ac_pSource + i * 4));
+
+			__m128i xResult = _mm_and_si128(xPixels, xGreenAlpha);
+			xResult = _mm_or_si128(xResult, _mm_and_si128(_mm_srli_epi32(xPixels, 16), xLow));
+			xResult = _mm_or_si128(xResult, _mm_slli_epi32(_mm_and_si128(xPixels, xLow), 16));
+			xResult = _mm_or_si128(xResult, xAlpha);
+
+			_mm_storeu_si128((__m128i*)(a_pDestination + i * 4), xResult);
+		}
+#endif
+		for (; i < ac_iWidth; ++i)
+		{
+			Uint32 uiPixel;
+			memcpy(&uiPixel, ac_pSource + i * 4, 4);
+			uiPixel = (uiPixel & 0xFF00FF00) | ((uiPixel >> 16) & 0xFF) | ((uiPixel & 0xFF) << 16) | ac_uiAlpha;
+			memcpy(a_pDestination + i * 4, &uiPixel, 4);
+		}
+	}
+
+	inline void PixelConvert::RowRGBX(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth)
+	{
+		int i = 0;
+#ifdef PIXELCONVERT_SSE
+		const __m128i xAlpha = _mm_set1_epi32(0xFF000000);
+		for (; i + 4 <= ac_iWidth; i += 4)
+		{
+			const __m128i xPixels = _mm_loadu_si128((const __m128i*)(ac_pSource + i * 4));
+			_mm_storeu_si128((__m128i*)(a_pDestination + i * 4), _mm_or_si128(xPixels, xAlpha));
+		}
+#endif
+		for (; i < ac_iWidth; ++i)
+		{
+			a_pDestination[i * 4 + 0] = ac_pSource[i * 4 + 0];
+			a_pDestination[i * 4 + 1] = ac_pSource[i * 4 + 1];
+			a_pDestination[i * 4 + 2] = ac_pSource[i * 4 + 2];
+			a_pDestination[i * 4 + 3] = 0xFF;
+		}
+	}
+
+#ifdef PIXELCONVERT_SSE
+	namespace PixelConvert
+	{
+		// - Spreads 3 byte pixels out to 4, 4 pixels at a time. Reads 16 bytes for every 12 it uses
+		PIXELCONVERT_SSSE3 inline int ShuffleRGB(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth, const bool ac_bSwap)
+		{
+			const __m128i xOrder = ac_bSwap ?
+				_mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1) :
+				_mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+			const __m128i xAlpha = _mm_set1_epi32(0xFF000000);
+
+			// The last load of a row must not read past it, so the loop stops 2 pixels short of where it otherwise could
+			int i = 0;
+			for (; i + 6 <= ac_iWidth; i += 4)
+			{
+				const __m128i xPixels = _mm_loadu_si128((const __m128i*)(ac_pSource + i * 3));
+				_mm_storeu_si128((__m128i*)(a_pDestination + i * 4), _mm_or_si128(_mm_shuffle_epi8(xPixels, xOrder), xAlpha));
+			}
+			return i;
+		}
+	}
+#endif
+
+	inline void PixelConvert::RowRGB(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth, const bool ac_bSwap)
+	{
+		int i = 0;
+#ifdef PIXELCONVERT_SSE
+		if (HasShuffle())
+			i = ShuffleRGB(ac_pSource, a_pDestination, ac_iWidth, ac_bSwap);
+#endif
+		const int iRed = ac_bSwap ? 2 : 0;
+		for (; i < ac_iWidth; ++i)
+		{
+			a_pDestination[i * 4 + 0] = ac_pSource[i * 3 + iRed];
+			a_pDestination[i * 4 + 1] = ac_pSource[i * 3 + 1];
+			a_pDestination[i * 4 + 2] = ac_pSource[i * 3 + 2 - iRed];
+			a_pDestination[i * 4 + 3] = 0xFF;
+		}
+	}
+
+	inline void PixelConvert::RowGray(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth)
+	{
+		int i = 0;
+#ifdef PIXELCONVERT_SSE
+		// Each gray byte is doubled, then doubled again, giving 4 copies that the alpha is ORed over
+		const __m128i xAlpha = _mm_set1_epi32(0xFF000000);
+		for (; i + 16 <= ac_iWidth; i += 16)
+		{
+			const __m128i xGray = _mm_loadu_si128((const __m128i*)(ac_pSource + i));
+			const __m128i xLow = _mm_unpacklo_epi8(xGray, xGray);
+			const __m128i xHigh = _mm_unpackhi_epi8(xGray, xGray);
+
+			__m128i* pDestination = (__m128i*)(a_pDestination + i * 4);
+			_mm_storeu_si128(pDestination + 0, _mm_or_si128(_mm_unpacklo_epi16(xLow, xLow), xAlpha));
+			_mm_storeu_si128(pDestination + 1, _mm_or_si128(_mm_unpackhi_epi16(xLow, xLow), xAlpha));
+			_mm_storeu_si128(pDestination + 2, _mm_or_si128(_mm_unpacklo_epi16(xHigh, xHigh), xAlpha));
+			_mm_storeu_si128(pDestination + 3, _mm_or_si128(_mm_unpackhi_epi16(xHigh, xHigh), xAlpha));
+		}
+#endif
+		for (; i < ac_iWidth; ++i)
+		{
+			a_pDestination[i * 4 + 0] = ac_pSource[i];
+			a_pDestination[i * 4 + 1] = ac_pSource[i];
+			a_pDestination[i * 4 + 2] = ac_pSource[i];
+			a_pDestination[i * 4 + 3] = 0xFF;
+		}
+	}
+
+	inline void PixelConvert::RowIndexed(const Uint8* ac_pSource, Uint8* a_pDestination, const int ac_iWidth, const Uint32* ac_pPalette)
+	{
+		// A lookup per pixel has nothing for SIMD to speed up before AVX2's gather, so it is only unrolled
+		Uint32* pDestination = (Uint32*)a_pDestination;
+		int i = 0;
+		for (; i + 4 <= ac_iWidth; i += 4)
+		{
+			const Uint32 uiPixel0 = ac_pPalette[ac_pSource[i + 0]];
+			const Uint32 uiPixel1 = ac_pPalette[ac_pSource[i + 1]];
+			const Uint32 uiPixel2 = ac_pPalette[ac_pSource[i + 2]];
+			const Uint32 uiPixel3 = ac_pPalette[ac_pSource[i + 3]];
+			memcpy(pDestination + i + 0, &uiPixel0, 4);
+			memcpy(pDestination + i + 1, &uiPixel1, 4);
+			memcpy(pDestination + i + 2, &uiPixel2, 4);
+			memcpy(pDestination + i + 3, &uiPixel3, 4);
+		}
+		for (; i < ac_iWidth; ++i)
+			memcpy(pDestination + i, &ac_pPalette[ac_pSource[i]], 4);
+	}
+
+	inline void PixelConvert::PremultiplyRow(Uint8* a_pPixels, const int ac_iWidth)
+	{
+		int i = 0;
+#ifdef PIXELCONVERT_SSE
+		// Pixels are widened to 16 bits a channel, 2 at a time. Alpha is copied over the color channels and 255 over
+		// itself, so one multiply does every channel and leaves alpha as it was
+		const __m128i xZero = _mm_setzero_si128();
+		const __m128i xAlphaLanes = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+		const __m128i x255 = _mm_set1_epi16(255);
+		const __m128i xRound = _mm_set1_epi16(128);
+		for (; i + 4 <= ac_iWidth; i += 4)
+		{
+			const __m128i xPixels = _mm_loadu_si128((const __m128i*)(a_pPixels + i * 4));
+
+			__m128i axHalves[2] = { _mm_unpacklo_epi8(xPixels, xZero), _mm_unpackhi_epi8(xPixels, xZero) };
+			for (int iHalf = 0; iHalf < 2; ++iHalf)
+			{
+				__m128i xAlpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(axHalves[iHalf], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+				xAlpha = _mm_or_si128(_mm_andnot_si128(xAlphaLanes, xAlpha), _mm_and_si128(xAlphaLanes, x255));
+
+				const __m128i xProduct = _mm_add_epi16(_mm_mullo_epi16(axHalves[iHalf], xAlpha), xRound);
+				axHalves[iHalf] = _mm_srli_epi16(_mm_add_epi16(xProduct, _mm_srli_epi16(xProduct, 8)), 8);
+			}
+
+			_mm_storeu_si128((__m128i*)(a_pPixels + i * 4), _mm_packus_epi16(axHalves[0], axHalves[1]));
+		}
+#endif
+		for (; i < ac_iWidth; ++i)
+		{
+			Uint8* pPixel = a_pPixels + i * 4;
+			pPixel[0] = (Uint8)MultiplyAlpha(pPixel[0], pPixel[3]);
+			pPixel[1] = (Uint8)MultiplyAlpha(pPixel[1], pPixel[3]);
+			pPixel[2] = (Uint8)MultiplyAlpha(pPixel[2], pPixel[3]);
+		}
+	}
+
+	inline bool PixelConvert::IsOpaque(const void* ac_pPixels, const int ac_iWidth, const int ac_iHeight, const int ac_iPitch)
+	{
+		for (int iRow = 0; iRow < ac_iHeight; ++iRow)
+		{
+			const Uint8* pRow = (const Uint8*)ac_pPixels + iRow * ac_iPitch;
+
+			int i = 0;
+#ifdef PIXELCONVERT_SSE
+			// Every pixel is ANDed together, so the alpha bytes only stay 255 if each one was
+			__m128i xAll = _mm_set1_epi32(-1);
+			for (; i + 4 <= ac_iWidth; i += 4)
+				xAll = _mm_and_si128(xAll, _mm_loadu_si128((const __m128i*)(pRow + i * 4)));
+
+			const __m128i xAlphaMask = _mm_set1_epi32((int)0xFF000000);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(xAll, xAlphaMask), xAlphaMask)) != 0xFFFF)
+				return false;
+#endif
+			for (; i < ac_iWidth; ++i)
+			{
+				if (pRow[i * 4 + 3] != 0xFF)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	inline bool PixelConvert::HasShuffle()
+	{
+		static const bool bHasShuffle = SDL_HasSSE41() == SDL_TRUE;
+
+		return bHasShuffle;
+	}
+
+	inline bool ConvertToRGBA(const SDL_Surface& ac_sdlSource, void* a_pDestination, const int ac_iPitch, const bool ac_bPremultiply)
+	{
+		using namespace PixelConvert;
+
+		const Layout layout = GetLayout(ac_sdlSource);
+		if (layout == LAYOUT_OTHER)
+		{
+			SDL_Surface* sdlConverted = SDL_ConvertSurfaceFormat((SDL_Surface*)&ac_sdlSource, SDL_PIXELFORMAT_ABGR8888, 0);
+			if (sdlConverted == NULL)
+				return false;
+
+			const bool bConverted = ConvertToRGBA(*sdlConverted, a_pDestination, ac_iPitch, ac_bPremultiply);
+			SDL_FreeSurface(sdlConverted);
+			return bConverted;
+		}
+
+		// Only layouts with an alpha channel can have anything to premultiply, and the palette is premultiplied up front
+		const bool bPremultiplyRows = ac_bPremultiply && (layout == LAYOUT_RGBA || layout == LAYOUT_BGRA);
+
+		Uint32 auiPalette[256];
+		if (layout == LAYOUT_INDEXED)
+		{
+			const SDL_Palette& palette = *ac_sdlSource.format->palette;
+
+			Uint32 uiKey;
+			const bool bKeyed = SDL_GetColorKey((SDL_Surface*)&ac_sdlSource, &uiKey) == 0;
+
+			for (int i = 0; i < 256; ++i)
+			{
+				// Indices past the palette come out black, as they do through SDL
+				const SDL_Color color = i < palette.ncolors ? palette.colors[i] : SDL_Color{ 0, 0, 0, 255 };
+				Uint32 auiColor[4] = { color.r, color.g, color.b, (bKeyed && (Uint32)i == uiKey) ? 0u : color.a };
+				if (ac_bPremultiply)
+				{
+					for (int iChannel = 0; iChannel < 3; ++iChannel)
+						auiColor[iChannel] = MultiplyAlpha(auiColor[iChannel], auiColor[3]);
+				}
+				auiPalette[i] = auiColor[0] | (auiColor[1] << 8) | (auiColor[2] << 16) | (auiColor[3] << 24);
+			}
+		}
+
+		SDL_Surface* sdlSource = (SDL_Surface*)&ac_sdlSource;
+		if (SDL_MUSTLOCK(sdlSource))
+			SDL_LockSurface(sdlSource);
+
+		for (int iRow = 0; iRow < ac_sdlSource.h; ++iRow)
+		{
+			const Uint8* pSource = (const Uint8*)ac_sdlSource.pixels + iRow * ac_sdlSource.pitch;
+			Uint8* pDestination = (Uint8*)a_pDestination + iRow * ac_iPitch;
+
+			switch (layout)
+			{
+			case LAYOUT_RGBA:	 RowRGBA(pSource, pDestination, ac_sdlSource.w); break;
+			case LAYOUT_BGRA:	 RowBGRA(pSource, pDestination, ac_sdlSource.w, 0); break;
+			case LAYOUT_RGBX:	 RowRGBX(pSource, pDestination, ac_sdlSource.w); break;
+			case LAYOUT_BGRX:	 RowBGRA(pSource, pDestination, ac_sdlSource.w, 0xFF000000); break;
+			case LAYOUT_RGB:	 RowRGB(pSource, pDestination, ac_sdlSource.w, false); break;
+			case LAYOUT_BGR:	 RowRGB(pSource, pDestination, ac_sdlSource.w, true); break;
+			case LAYOUT_GRAY:	 RowGray(pSource, pDestination, ac_sdlSource.w); break;
+			case LAYOUT_INDEXED: RowIndexed(pSource, pDestination, ac_sdlSource.w, auiPalette); break;
+			default: break;
+			}
+
+			// Done a row at a time while the row is still in the cache
+			if (bPremultiplyRows)
+				PremultiplyRow(pDestination, ac_sdlSource.w);
+		}
+
+		if (SDL_MUSTLOCK(sdlSource))
+			SDL_UnlockSurface(sdlSource);
+
+		return true;
+	}
+
+	inline SDL_Surface* ConvertSurface(const SDL_Surface& ac_sdlSource, const bool ac_bPremultiply)
+	{
+		SDL_Surface* sdlConverted = SDL_CreateRGBSurface(0, ac_sdlSource.w, ac_sdlSource.h, 32, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+		if (sdlConverted == NULL)
+			return nullptr;
+
+		// SDL pads rows to 4 bytes, which 32 bit pixels always are, so the rows are tightly packed
+		if (!ConvertToRGBA(ac_sdlSource, sdlConverted->pixels, sdlConverted->pitch, ac_bPremultiply))
+		{
+			SDL_FreeSurface(sdlConverted);
+			return nullptr;
+		}
+
+		return sdlConverted;
+	}
+
+	inline bool IsUploadReady(const SDL_Surface& ac_sdlSurface)
+	{
+		return PixelConvert::GetLayout(ac_sdlSurface) == PixelConvert::LAYOUT_RGBA && ac_sdlSurface.pitch == ac_sdlSurface.w * 4 && !SDL_MUSTLOCK(&ac_sdlSurface);
+	}
+}
+
+#endif // _PIXELCONVERT_H_
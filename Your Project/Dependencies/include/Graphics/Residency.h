@@ -0,0 +1,292 @@
+//////////////////////////////////////////////////////////////
+// File: Residency.h
+// Author: Ben Odom
+// Brief: Keeps texture memory under a budget. With a budget
+//		  set, loading keeps the decoded pixels (or where they
+//		  sit in an asset pack) instead of uploading them, and
+//		  a texture is uploaded the first time 'DrawCameras'
+//		  draws it. When the budget is exceeded the textures
+//		  drawn least recently give their memory back, keeping
+//		  the same texture name so their surfaces still work
+//////////////////////////////////////////////////////////////
+
+#ifndef _RESIDENCY_H_
+#define _RESIDENCY_H_
+
+#include "Mipmap.h"
+
+#include <list>
+
+namespace Graphics
+{
+	// What the residency manager is holding and how hard it is working
+	struct ResidencyStats
+	{
+		unsigned int uiBudgetBytes;
+
+		unsigned int uiManaged;		  // Textures with their pixels kept to upload from
+		unsigned int uiResident;	  // Of those, how many are uploaded
+		unsigned int uiResidentBytes; // What the uploaded ones take up, counting every mip level
+		unsigned int uiSourceBytes;	  // What the kept pixels take up in memory. Pixels in an asset pack aren't counted
+
+		unsigned int uiUploads; // Since the program started
+		unsigned int uiEvictions;
+
+		unsigned int uiFrameUploads; // In the last frame drawn
+		unsigned int uiFrameEvictions;
+		bool bOverBudget; // The last frame drew more than the budget holds, so nothing it drew could be evicted
+	};
+
+	// - Sets the most texture memory loaded textures may take up. 0, the default, uploads everything as it loads and never evicts
+	//   Textures loaded before a budget is set stay uploaded and don't count towards it. Needs 'DrawCameras' rather than 'Draw'
+	void SetTextureBudget(const unsigned int ac_uiBytes);
+	// - Whether textures loaded from now on are uploaded when first drawn rather than when loaded
+	bool IsResidencyManaged();
+
+	// - Returns what the residency manager is holding
+	const ResidencyStats& GetResidencyStats();
+
+	namespace Residency
+	{
+		// One texture the manager can upload and evict
+		struct Texture
+		{
+			System::Size2D<int> Size;
+			const Uint8* pPacked;	   // Pixels in a mapped asset pack, or nullptr if they are kept in 'vPixels'
+			std::vector<Uint8> vPixels;
+
+			bool bMipmaps;		// Whether it was loaded with 'SetMipmaps' on
+			FilterMode eFilter; // The filter of a mipmapped texture, which 'Mipmap' forgets when it is evicted
+			bool bResident;
+			unsigned int uiBytes;		// What it takes up while resident
+			unsigned int uiLastFrame;	// The frame it was last drawn in
+			std::list<GLuint>::iterator itRecent;
+		};
+
+		struct Manager
+		{
+			std::unordered_map<GLuint, Texture> mTextures;
+			std::list<GLuint> lRecent; // Resident textures, most recently drawn first
+
+			unsigned int uiFrame;
+			unsigned int uiUploadsBefore; // 'uiUploads' when the frame started
+			unsigned int uiEvictionsBefore;
+			unsigned int uiFlatBytes; // The part of 'uiResidentBytes' without mips, which 'Mipmap' doesn't count
+
+			ResidencyStats Stats;
+		};
+
+		// - Returns the one manager shared by everything that includes this file. Only use it from the thread that draws
+		Manager& Get();
+
+		/* - Takes charge of a texture name that has nothing uploaded yet, keeping its RGBA pixels to upload when it is drawn
+		   'ac_bPersistent' means the pixels outlive the texture, as a mapped asset pack does, so they aren't copied
+		*/
+		void Manage(const GLuint ac_uiTexture, const void* ac_pPixels, const System::Size2D<int>& ac_Size, const bool ac_bPersistent);
+		// - Whether the manager is in charge of a texture
+		bool IsManaged(const GLuint ac_uiTexture);
+		// - Forgets a texture that is about to be deleted
+		void Forget(const GLuint ac_uiTexture);
+
+		// - Marks a texture as drawn this frame, uploading it first if it isn't resident. Cheap for textures the manager doesn't know
+		void Touch(const GLuint ac_uiTexture);
+		// - Evicts the textures drawn least recently until the budget is met, and starts a new frame. Call after drawing
+		void EndFrame();
+
+		// - Uploads a texture's kept pixels into its name
+		void Upload(const GLuint ac_uiTexture, Texture& a_Texture);
+		// - Frees the memory of a texture's uploaded levels without deleting its name
+		void Evict(const GLuint ac_uiTexture, Texture& a_Texture);
+	}
+}
+
+namespace Graphics
+{
+	inline Residency::Manager& Residency::Get()
+	{
+		static Manager manager = {};
+
+		return manager;
+	}
+
+	inline void SetTextureBudget(const unsigned int ac_uiBytes)
+	{
+		Residency::Get().Stats.uiBudgetBytes = ac_uiBytes;
+	}
+	inline bool IsResidencyManaged()
+	{
+		return Residency::Get().Stats.uiBudgetBytes != 0;
+	}
+
+	inline const ResidencyStats& GetResidencyStats()
+	{
+		return Residency::Get().Stats;
+	}
+
+	inline void Residency::Manage(const GLuint ac_uiTexture, const void* ac_pPixels, const System::Size2D<int>& ac_Size, const bool ac_bPersistent)
+	{
+		Manager& manager = Get();
+
+		Texture& texture = manager.mTextures[ac_uiTexture];
+		texture.Size = ac_Size;
+		texture.pPacked = ac_bPersistent ? (const Uint8*)ac_pPixels : nullptr;
+		if (!ac_bPersistent)
+		{
+			texture.vPixels.assign((const Uint8*)ac_pPixels, (const Uint8*)ac_pPixels + ac_Size.W * ac_Size.H * 4);
+			manager.Stats.uiSourceBytes += (unsigned int)texture.vPixels.size();
+		}
+
+		texture.bMipmaps = AreMipmapsEnabled();
+		texture.eFilter = GetDefaultFilter();
+		texture.bResident = false;
+		texture.uiBytes = texture.bMipmaps ? Mipmap::LevelBytes(ac_Size, 0) : ac_Size.W * ac_Size.H * 4;
+		texture.uiLastFrame = manager.uiFrame;
+		texture.itRecent = manager.lRecent.end();
+
+		// The filter goes on now, since the texture parameters belong to the name and outlive every eviction
+		GLState::BindTexture(ac_uiTexture);
+		Mipmap::ApplyFilter(texture.eFilter, false);
+
+		++manager.Stats.uiManaged;
+	}
+	inline bool Residency::IsManaged(const GLuint ac_uiTexture)
+	{
+		const Manager& manager = Get();
+
+		return !manager.mTextures.empty() && manager.mTextures.count(ac_uiTexture) != 0;
+	}
+	inline void Residency::Forget(const GLuint ac_uiTexture)
+	{
+		Manager& manager = Get();
+
+		const std::unordered_map<GLuint, Texture>::iterator Found = manager.mTextures.find(ac_uiTexture);
+		if (Found == manager.mTextures.end())
+			return;
+
+		Texture& texture = Found->second;
+		if (texture.bResident)
+		{
+			manager.lRecent.erase(texture.itRecent);
+			manager.Stats.uiResidentBytes -= texture.uiBytes;
+			manager.uiFlatBytes -= texture.bMipmaps ? 0 : texture.uiBytes;
+			--manager.Stats.uiResident;
+			Mipmap::Forget(ac_uiTexture);
+		}
+		manager.Stats.uiSourceBytes -= (unsigned int)texture.vPixels.size();
+		--manager.Stats.uiManaged;
+
+		manager.mTextures.erase(Found);
+	}
+
+	inline void Residency::Touch(const GLuint ac_uiTexture)
+	{
+		Manager& manager = Get();
+		if (manager.mTextures.empty())
+			return;
+
+		const std::unordered_map<GLuint, Texture>::iterator Found = manager.mTextures.find(ac_uiTexture);
+		if (Found == manager.mTextures.end())
+			return;
+
+		Texture& texture = Found->second;
+		if (!texture.bResident)
+		{
+			Upload(ac_uiTexture, texture);
+		}
+		else if (texture.uiLastFrame != manager.uiFrame)
+		{
+			// Moved to the front once a frame, however many surfaces draw it
+			manager.lRecent.splice(manager.lRecent.begin(), manager.lRecent, texture.itRecent);
+		}
+		texture.uiLastFrame = manager.uiFrame;
+	}
+	inline void Residency::EndFrame()
+	{
+		Manager& manager = Get();
+		ResidencyStats& stats = manager.Stats;
+
+		stats.bOverBudget = false;
+		while (stats.uiBudgetBytes != 0 && stats.uiResidentBytes > stats.uiBudgetBytes && !manager.lRecent.empty())
+		{
+			const GLuint uiTexture = manager.lRecent.back();
+			Texture& texture = manager.mTextures[uiTexture];
+
+			// The back of the list was drawn this frame, so everything was. Evicting it would only upload it again next frame
+			if (texture.uiLastFrame == manager.uiFrame)
+			{
+				stats.bOverBudget = true;
+				break;
+			}
+
+			Evict(uiTexture, texture);
+		}
+
+		++manager.uiFrame;
+
+		stats.uiFrameUploads = stats.uiUploads - manager.uiUploadsBefore;
+		stats.uiFrameEvictions = stats.uiEvictions - manager.uiEvictionsBefore;
+		manager.uiUploadsBefore = stats.uiUploads;
+		manager.uiEvictionsBefore = stats.uiEvictions;
+	}
+
+	inline void Residency::Upload(const GLuint ac_uiTexture, Texture& a_Texture)
+	{
+		Manager& manager = Get();
+
+		const void* pPixels = a_Texture.pPacked != nullptr ? (const void*)a_Texture.pPacked : (const void*)a_Texture.vPixels.data();
+
+		GLState::BindTexture(ac_uiTexture);
+		if (a_Texture.bMipmaps)
+		{
+			Mipmap::Chain chain;
+			Mipmap::Build(pPixels, a_Texture.Size, a_Texture.Size.W * 4, chain);
+			Mipmap::Attach(ac_uiTexture, chain, false);
+			SetTextureFilter(ac_uiTexture, a_Texture.eFilter);
+		}
+		else
+		{
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, a_Texture.Size.W, a_Texture.Size.H, 0, GL_RGBA, GL_UNSIGNED_BYTE, pPixels);
+			Stats::AddTextureUpload(a_Texture.Size.W * a_Texture.Size.H * 4);
+			GLState::TextureUploaded();
+		}
+
+		a_Texture.bResident = true;
+		manager.lRecent.push_front(ac_uiTexture);
+		a_Texture.itRecent = manager.lRecent.begin();
+
+		manager.Stats.uiResidentBytes += a_Texture.uiBytes;
+		manager.uiFlatBytes += a_Texture.bMipmaps ? 0 : a_Texture.uiBytes;
+		++manager.Stats.uiResident;
+		++manager.Stats.uiUploads;
+	}
+	inline void Residency::Evict(const GLuint ac_uiTexture, Texture& a_Texture)
+	{
+		Manager& manager = Get();
+
+		GLState::BindTexture(ac_uiTexture);
+
+		// Giving every level no size frees the memory but keeps the name, so surfaces drawing it need nothing changed
+		const int iLevels = a_Texture.bMipmaps ? Mipmap::CountLevels(a_Texture.Size) : 1;
+		for (int iLevel = 0; iLevel < iLevels; ++iLevel)
+			glTexImage2D(GL_TEXTURE_2D, iLevel, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+		if (a_Texture.bMipmaps)
+		{
+			const std::unordered_map<GLuint, Mipmap::Texture>::const_iterator Mips = Mipmap::Get().mTextures.find(ac_uiTexture);
+			if (Mips != Mipmap::Get().mTextures.end())
+				a_Texture.eFilter = Mips->second.eFilter;
+			Mipmap::Forget(ac_uiTexture);
+		}
+
+		a_Texture.bResident = false;
+		manager.lRecent.erase(a_Texture.itRecent);
+		a_Texture.itRecent = manager.lRecent.end();
+
+		manager.Stats.uiResidentBytes -= a_Texture.uiBytes;
+		manager.uiFlatBytes -= a_Texture.bMipmaps ? 0 : a_Texture.uiBytes;
+		--manager.Stats.uiResident;
+		++manager.Stats.uiEvictions;
+	}
+}
+
+#endif // _RESIDENCY_H_
@@ -10,6 +10,8 @@
 #ifndef _SYSTEM_H_
 #define _SYSTEM_H_
 
+#include <cmath> // Holds 'cos()' and 'sin()', used to move a point along an angle
+
 #define PI 3.1415926535897932384626433832795 // PI in such a way that anything that includes "System.h" can use it
 
 namespace System
@@ -35,22 +37,22 @@ namespace System
 		T X, Y;
 
 		// Addition of two 'Point2D's
-		template <typename T, typename U>
-		friend const Point2D<T> operator+(const Point2D<T>& ac_PointA, const Point2D<U>& ac_PointB);
+		template <typename V, typename U>
+		friend const Point2D<V> operator+(const Point2D<V>& ac_PointA, const Point2D<U>& ac_PointB);
 		// Subtraction of two 'Point2D's
-		template <typename T, typename U>
-		friend const Point2D<T> operator-(const Point2D<T>& ac_PointA, const Point2D<U>& ac_PointB);
+		template <typename V, typename U>
+		friend const Point2D<V> operator-(const Point2D<V>& ac_PointA, const Point2D<U>& ac_PointB);
 		// Applying a negative sign to a single Point2D; ex: "NegativeA = -PointA;"
-		template <typename T>
-		friend const Point2D<T> operator-(const Point2D<T>& ac_PointA);
+		template <typename V>
+		friend const Point2D<V> operator-(const Point2D<V>& ac_PointA);
 
 		// Division of two 'Point2D's
-		template <typename T, typename U>
-		friend const Point2D<T> operator/(const Point2D<T>& ac_PointA, const Point2D<U>& ac_PointB);
+		template <typename V, typename U>
+		friend const Point2D<V> operator/(const Point2D<V>& ac_PointA, const Point2D<U>& ac_PointB);
 		
 		// Division of a 'Point2D' and an integer; ex: "HalfofA = PointA / 2;"
-		template <typename T>
-		friend const Point2D<T> operator/(const Point2D<T>& ac_PointA, const int ac_iNum);
+		template <typename V>
+		friend const Point2D<V> operator/(const Point2D<V>& ac_PointA, const int ac_iNum);
 	};
 
 	// Defines a templated struct for dimensions/size in 2D space as well as some overloaded operators to go along with it
@@ -59,8 +61,8 @@ namespace System
 	{
 		T W, H;
 
-		template <typename T>
-		friend const Size2D<T> operator/(const Size2D<T>& ac_SizeA, const int ac_iNum);
+		template <typename V>
+		friend const Size2D<V> operator/(const Size2D<V>& ac_SizeA, const int ac_iNum);
 
 	};
 	// Defines a templated struct for angular velocity in 2D space
@@ -126,7 +128,7 @@ namespace System
 	template <typename T>
 	const Size2D<T> operator/(const Size2D<T>& ac_SizeA, const int ac_iNum)
 	{
-		const Size2D<T> SizeC = { ac_Dimension.W / ac_iNum, ac_Dimension.H / ac_iNum };
+		const Size2D<T> SizeC = { ac_SizeA.W / ac_iNum, ac_SizeA.H / ac_iNum };
 
 		return SizeC;
 	}
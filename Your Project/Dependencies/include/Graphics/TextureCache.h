@@ -0,0 +1,288 @@
+//////////////////////////////////////////////////////////////
+// File: TextureCache.h
+// Author: Ben Odom
+// Brief: Shares one OpenGL texture between every 'GLSurface'
+//		  loaded from the same image. Files are looked up by
+//		  their normalized path and 'SDL_Surface's by a hash
+//		  of their pixels, each along with how the texture was
+//		  uploaded. Each texture counts the surfaces
+//		  using it and is deleted when the last one releases it
+//////////////////////////////////////////////////////////////
+
+#ifndef _TEXTURECACHE_H_
+#define _TEXTURECACHE_H_
+
+#include "Residency.h"
+
+#include <cctype>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Graphics
+{
+	// How well the cache has done since the program started
+	struct TextureCacheStats
+	{
+		unsigned int uiHits;
+		unsigned int uiMisses;
+
+		unsigned int uiTextures;	  // Textures currently held
+		unsigned int uiResidentBytes; // What those textures take up on the GPU
+
+		float HitRate() const { return uiHits + uiMisses > 0 ? (float)uiHits / (uiHits + uiMisses) : 0.0f; }
+	};
+
+	// - Returns the hit rate and size of the texture cache
+	const TextureCacheStats& GetTextureCacheStats();
+
+	namespace TextureCache
+	{
+		// One shared texture
+		struct Entry
+		{
+			std::string sKey;
+			System::Size2D<int> Size;
+			unsigned int uiReferences;
+		};
+
+		struct Cache
+		{
+			std::unordered_map<std::string, GLuint> mTextures; // Key to texture
+			std::unordered_map<GLuint, Entry> mEntries;		   // Texture to what is known about it
+			std::unordered_set<GLuint> Opaque;				   // Textures whose every pixel has an alpha of 255
+
+			TextureCacheStats Stats;
+			unsigned int uiFlatBytes; // What the textures without a mip chain take up. 'Mipmap' and 'Residency' count the rest
+		};
+
+		// - Returns the one cache shared by everything that includes this file. Only use it from the thread that draws
+		Cache& Get();
+
+		// - Turns a file name into the path it is known by, so "Art\\Tree.png" and "./Art/Tree.png" find the same image
+		//   Case is only ignored on Windows, whose file names ignore it too
+		std::string NormalizePath(const char* ac_szFilename);
+		// - Turns a path from 'NormalizePath' into a key, given whether its texture is uploaded with premultiplied alpha
+		std::string PathKey(const std::string& ac_sPath, const bool ac_bPremultiplied);
+		/* - Turns the pixels of an 'SDL_Surface' into a key, so identical images find the same texture
+		   The color key and whether alpha is premultiplied change what is uploaded, so they are part of the key too
+		*/
+		std::string HashSurface(const SDL_Surface& ac_sdlSurface, const bool ac_bPremultiplied);
+
+		// - Returns the texture stored under 'ac_sKey' with one more reference, or 0 if there isn't one
+		GLuint Acquire(const std::string& ac_sKey, System::Size2D<int>& a_Size);
+		// - Stores a newly uploaded texture under 'ac_sKey' with one reference and returns it
+		//   If the key was stored in the meantime, 'ac_uiTexture' is deleted and the stored texture is returned instead
+		GLuint Insert(const std::string& ac_sKey, const GLuint ac_uiTexture, const System::Size2D<int>& ac_Size);
+
+		// - Adds a reference to a texture, for when a 'GLSurface' is copied
+		void AddReference(const GLuint ac_uiTexture);
+		// - Removes a reference to a texture and deletes it if that was the last one. Textures the cache doesn't know are deleted straight away
+		void Release(const GLuint ac_uiTexture);
+
+		// - Records whether every pixel of a texture has an alpha of 255. 'UploadTexture' calls it with what it uploads
+		void SetOpaque(const GLuint ac_uiTexture, const bool ac_bOpaque);
+		// - Whether every pixel of a texture is known to have an alpha of 255. Textures nothing was recorded for count as translucent
+		bool IsOpaque(const GLuint ac_uiTexture);
+	}
+}
+
+namespace Graphics
+{
+	inline TextureCache::Cache& TextureCache::Get()
+	{
+		static Cache cache;
+
+		return cache;
+	}
+
+	inline const TextureCacheStats& GetTextureCacheStats()
+	{
+		// Streaming changes what a mipmapped texture takes up while it is held, so the total is worked out when asked for
+		TextureCache::Cache& cache = TextureCache::Get();
+		cache.Stats.uiResidentBytes = cache.uiFlatBytes + GetMipmapStats().uiResidentBytes + Residency::Get().uiFlatBytes;
+
+		return cache.Stats;
+	}
+
+	inline std::string TextureCache::NormalizePath(const char* ac_szFilename)
+	{
+		// Windows paths ignore case and accept either slash
+		std::string sPath = ac_szFilename;
+		for (unsigned int i = 0; i < sPath.size(); ++i)
+		{
+#ifdef _WIN32
+			sPath[i] = sPath[i] == '\\' ? '/' : (char)tolower((unsigned char)sPath[i]);
+#else
+			sPath[i] = sPath[i] == '\\' ? '/' : sPath[i];
+#endif
+		}
+
+		// Walks the path a folder at a time, dropping '.' and letting '..' undo the folder before it
+		std::vector<std::string> vParts;
+		size_t uiBegin = 0;
+		while (uiBegin <= sPath.size())
+		{
+			size_t uiEnd = sPath.find('/', uiBegin);
+			if (uiEnd == std::string::npos)
+				uiEnd = sPath.size();
+
+			const std::string sPart = sPath.substr(uiBegin, uiEnd - uiBegin);
+			if (sPart == ".." && !vParts.empty() && vParts.back() != "..")
+				vParts.pop_back();
+			else if (!sPart.empty() && sPart != ".")
+				vParts.push_back(sPart);
+
+			uiBegin = uiEnd + 1;
+		}
+
+		std::string sNormalized = !sPath.empty() && sPath[0] == '/' ? "/" : "";
+		for (unsigned int i = 0; i < vParts.size(); ++i)
+			sNormalized += (i > 0 ? "/" : "") + vParts[i];
+
+		return sNormalized;
+	}
+	inline std::string TextureCache::PathKey(const std::string& ac_sPath, const bool ac_bPremultiplied)
+	{
+		// Every path key starts with one of these and every 'HashSurface' key with '#', so keys of different kinds never match
+		return (ac_bPremultiplied ? "p:" : "s:") + ac_sPath;
+	}
+	inline std::string TextureCache::HashSurface(const SDL_Surface& ac_sdlSurface, const bool ac_bPremultiplied)
+	{
+		// 64 bit FNV-1a over each row, skipping any padding at the end of a row. Formats of under 8 bits a pixel pack several pixels into a byte
+		unsigned long long ullHash = 14695981039346656037ULL;
+		const unsigned int uiRowBytes = (ac_sdlSurface.w * ac_sdlSurface.format->BitsPerPixel + 7) / 8;
+		for (int iRow = 0; iRow < ac_sdlSurface.h; ++iRow)
+		{
+			const Uint8* pRow = (const Uint8*)ac_sdlSurface.pixels + iRow * ac_sdlSurface.pitch;
+			for (unsigned int i = 0; i < uiRowBytes; ++i)
+				ullHash = (ullHash ^ pRow[i]) * 1099511628211ULL;
+		}
+
+		// Indexed surfaces with the same pixels but different palettes upload different textures
+		const SDL_Palette* sdlPalette = ac_sdlSurface.format->palette;
+		if (sdlPalette != nullptr)
+		{
+			const Uint8* pColors = (const Uint8*)sdlPalette->colors;
+			for (unsigned int i = 0; i < sdlPalette->ncolors * sizeof(SDL_Color); ++i)
+				ullHash = (ullHash ^ pColors[i]) * 1099511628211ULL;
+		}
+
+		// Pixels matching the color key are uploaded transparent, so the same pixels with and without one are different textures
+		Uint32 uiColorKey = 0;
+		const bool bColorKey = SDL_GetColorKey(const_cast<SDL_Surface*>(&ac_sdlSurface), &uiColorKey) == 0;
+
+		// Starts with '#' so it can never match a path
+		char szKey[96];
+		snprintf(szKey, sizeof(szKey), "#%016llx:%dx%d:%08x:%c%08x:%c", ullHash, ac_sdlSurface.w, ac_sdlSurface.h, (unsigned int)ac_sdlSurface.format->format,
+			bColorKey ? 'k' : '-', (unsigned int)uiColorKey, ac_bPremultiplied ? 'p' : 's');
+
+		return szKey;
+	}
+
+	inline GLuint TextureCache::Acquire(const std::string& ac_sKey, System::Size2D<int>& a_Size)
+	{
+		Cache& cache = Get();
+
+		const std::unordered_map<std::string, GLuint>::const_iterator Found = cache.mTextures.find(ac_sKey);
+		if (Found == cache.mTextures.end())
+		{
+			++cache.Stats.uiMisses;
+			return 0;
+		}
+
+		Entry& entry = cache.mEntries[Found->second];
+		++entry.uiReferences;
+		a_Size = entry.Size;
+
+		++cache.Stats.uiHits;
+		return Found->second;
+	}
+	inline GLuint TextureCache::Insert(const std::string& ac_sKey, const GLuint ac_uiTexture, const System::Size2D<int>& ac_Size)
+	{
+		Cache& cache = Get();
+
+		const std::unordered_map<std::string, GLuint>::const_iterator Found = cache.mTextures.find(ac_sKey);
+		if (Found != cache.mTextures.end())
+		{
+			Residency::Forget(ac_uiTexture);
+			Mipmap::Forget(ac_uiTexture);
+			cache.Opaque.erase(ac_uiTexture);
+			GLState::ForgetTexture(ac_uiTexture);
+			glDeleteTextures(1, &ac_uiTexture);
+			++cache.mEntries[Found->second].uiReferences;
+
+			return Found->second;
+		}
+
+		Entry entry;
+		entry.sKey = ac_sKey;
+		entry.Size = ac_Size;
+		entry.uiReferences = 1;
+
+		cache.mTextures[ac_sKey] = ac_uiTexture;
+		cache.mEntries[ac_uiTexture] = entry;
+
+		++cache.Stats.uiTextures;
+		if (!Mipmap::IsKnown(ac_uiTexture) && !Residency::IsManaged(ac_uiTexture))
+			cache.uiFlatBytes += ac_Size.W * ac_Size.H * 4;
+
+		return ac_uiTexture;
+	}
+
+	inline void TextureCache::AddReference(const GLuint ac_uiTexture)
+	{
+		Cache& cache = Get();
+
+		const std::unordered_map<GLuint, Entry>::iterator Found = cache.mEntries.find(ac_uiTexture);
+		if (Found != cache.mEntries.end())
+			++Found->second.uiReferences;
+	}
+	inline void TextureCache::Release(const GLuint ac_uiTexture)
+	{
+		Cache& cache = Get();
+
+		const std::unordered_map<GLuint, Entry>::iterator Found = cache.mEntries.find(ac_uiTexture);
+		if (Found == cache.mEntries.end())
+		{
+			Residency::Forget(ac_uiTexture);
+			Mipmap::Forget(ac_uiTexture);
+			cache.Opaque.erase(ac_uiTexture);
+			GLState::ForgetTexture(ac_uiTexture);
+			glDeleteTextures(1, &ac_uiTexture);
+			return;
+		}
+
+		if (--Found->second.uiReferences > 0)
+			return;
+
+		--cache.Stats.uiTextures;
+		if (Residency::IsManaged(ac_uiTexture))
+			Residency::Forget(ac_uiTexture);
+		else if (Mipmap::IsKnown(ac_uiTexture))
+			Mipmap::Forget(ac_uiTexture);
+		else
+			cache.uiFlatBytes -= Found->second.Size.W * Found->second.Size.H * 4;
+
+		GLState::ForgetTexture(ac_uiTexture);
+		glDeleteTextures(1, &ac_uiTexture);
+		cache.Opaque.erase(ac_uiTexture);
+		cache.mTextures.erase(Found->second.sKey);
+		cache.mEntries.erase(Found);
+	}
+
+	inline void TextureCache::SetOpaque(const GLuint ac_uiTexture, const bool ac_bOpaque)
+	{
+		if (ac_bOpaque)
+			Get().Opaque.insert(ac_uiTexture);
+		else
+			Get().Opaque.erase(ac_uiTexture);
+	}
+	inline bool TextureCache::IsOpaque(const GLuint ac_uiTexture)
+	{
+		return Get().Opaque.count(ac_uiTexture) != 0;
+	}
+}
+
+#endif // _TEXTURECACHE_H_
@@ -5,7 +5,9 @@
 //		  the OpenGL context and SDL Window. Multiple 
 //		  instances of this class will exist at any given
 //		  time, and each has functions that the 'Graphics'
-//		  namespace can use to handle it internally
+//		  namespace can use to handle it internally. Every
+//		  window draws with the one context 'glContext', so a
+//		  texture uploaded once can be drawn in any of them
 //////////////////////////////////////////////////////////////
 
 #ifndef _WINDOW_H_
@@ -20,6 +22,9 @@
 
 namespace Graphics
 {
+	// The context every window draws with. The first 'NewWindow' creates it, and later windows are made current with it too
+	extern SDL_GLContext glContext;
+
 	class Window
 	{
 	private:
@@ -50,12 +55,12 @@ namespace Graphics
 		const System::Size2D<unsigned int>& GetNonFullscreen();
 
 		SDL_Window* GetWindow();
-		const SDL_GLContext& GetContext();
+		const SDL_GLContext& GetContext(); // The same for every window, since they all share 'glContext'
 		const System::Size2D<unsigned int>& GetResolution();
 
 		const bool GetIsFullscreen();
 
-		void Flip();
+		void Flip(); // Call inside a 'GLState::Untracked' scope, like 'Graphics::Flip'
 
 		// This is the only usable constructor
 		Window(
@@ -69,6 +74,29 @@ namespace Graphics
 		Window() = delete; // Make sure the default constructor cannot be called
 		~Window();
 	};
+
+	inline const SDL_GLContext& Window::GetContext()
+	{
+		return glContext;
+	}
+
+	/* - Creates another context for a window that shares textures and display lists with 'glContext'
+	   For threads that need a context of their own. The context that was current before stays current
+	*/
+	inline SDL_GLContext CreateSharedContext(SDL_Window* a_sdlWindow)
+	{
+		SDL_Window* sdlWindow = SDL_GL_GetCurrentWindow();
+		SDL_GLContext sdlContext = SDL_GL_GetCurrentContext();
+
+		// Sharing is with whichever context is current when the new one is created
+		SDL_GL_MakeCurrent(sdlWindow != NULL ? sdlWindow : a_sdlWindow, glContext);
+		SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+		SDL_GLContext sdlShared = SDL_GL_CreateContext(a_sdlWindow);
+		SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+
+		SDL_GL_MakeCurrent(sdlWindow, sdlContext);
+		return sdlShared;
+	}
 }
 
 #endif // _WINDOW_H_
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "DynamicResolution.h"
+#include "Framebuffer.h"
+#include "GLState.h"
+#include "Present.h"
+#include "Profiler.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	const double kdSmoothing = 0.1;			// How much of each new frame time goes into the average the controller looks at
+	const unsigned int kuiSettleFrames = 16; // Frames to wait after a change before the next, so one slow frame can't swing the scale
+	const double kdHeadroom = 0.9;			// The scale is only raised when the frame is predicted to still take under this much of the target
+	const float kfMaxStepDown = 0.75f;		// The most the scale drops in one change
+	const float kfStepUp = 0.05f;			// How much the scale rises in one change
+
+	// The texture a window is drawn into at its internal size. Its size is rounded up to a power of two, which OpenGL 1.1 requires
+	struct Target
+	{
+		GLuint uiTexture;
+		GLsizei iWidth;
+		GLsizei iHeight;
+
+		Graphics::Framebuffer::Target framebuffer; // Empty without framebuffer objects, when the back buffer is copied in instead
+		bool bDrawn;							   // Whether 'framebuffer' has been cleared for the frame being drawn
+		System::Size2D<unsigned int> Drawn;		   // The internal size the frame is being drawn at
+	};
+
+	bool bDynamic = false;
+	bool bInteger = false;
+	double dTargetMilliseconds = 1000.0 / 60.0;
+	float fMinScale = 0.5f;
+	float fMaxScale = 1.0f;
+
+	float fScale = 1.0f;
+	unsigned int uiFactor = 1; // What window sizes are divided by with integer scaling on
+
+	double dSmoothed = 0.0; // 0 until the first frame at the current scale
+	unsigned int uiSettle = 0;
+
+	std::vector<Target> vTargets;
+
+	GLsizei PowerOfTwo(const unsigned int ac_uiSize)
+	{
+		GLsizei iPower = 1;
+		while ((unsigned int)iPower < ac_uiSize)
+			iPower <<= 1;
+		return iPower;
+	}
+
+	// - Turns a length in window pixels into internal pixels
+	GLint ScaleLength(const GLint ac_iLength)
+	{
+		if (bInteger)
+			return ac_iLength / (GLint)uiFactor;
+		return (GLint)floor(ac_iLength * fScale + 0.5f);
+	}
+
+	void SetScale(const float ac_fScale, const unsigned int ac_uiFactor)
+	{
+		if (ac_fScale == fScale && ac_uiFactor == uiFactor)
+			return;
+
+		fScale = ac_fScale;
+		uiFactor = ac_uiFactor;
+
+		// Frame times taken at the old scale say nothing about the new one
+		dSmoothed = 0.0;
+		uiSettle = 0;
+
+		// The same content stretched differently still has to be swapped
+		for (unsigned int i = 0; i < Graphics::voWindows.size(); ++i)
+			Graphics::MarkWindowChanged(i);
+
+		// Whatever is drawn from here on is drawn at the new size
+		Graphics::BindCurrentWindowTarget();
+	}
+
+	// - Makes sure a window's texture is at least as big as its internal size
+	Target& GetTarget(const unsigned int ac_uiWindow, const System::Size2D<unsigned int>& ac_Internal)
+	{
+		while (vTargets.size() <= ac_uiWindow)
+		{
+			const Target target = {};
+			vTargets.push_back(target);
+		}
+
+		Target& target = vTargets[ac_uiWindow];
+		const GLsizei iWidth = PowerOfTwo(ac_Internal.W);
+		const GLsizei iHeight = PowerOfTwo(ac_Internal.H);
+		if (target.uiTexture != 0 && iWidth <= target.iWidth && iHeight <= target.iHeight)
+			return target;
+
+		if (target.uiTexture == 0)
+			glGenTextures(1, &target.uiTexture);
+
+		target.iWidth = iWidth > target.iWidth ? iWidth : target.iWidth;
+		target.iHeight = iHeight > target.iHeight ? iHeight : target.iHeight;
+
+		Graphics::GLState::BindTexture(target.uiTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, target.iWidth, target.iHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); // The default expects mipmaps, which it never has
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+
+		// The depth buffer has to grow with the texture, so the framebuffer is made again
+		target.bDrawn = false;
+		if (Graphics::Framebuffer::IsSupported())
+			Graphics::Framebuffer::Create(target.framebuffer, target.uiTexture, target.iWidth, target.iHeight);
+
+		return target;
+	}
+
+	// - Adds up the GPU time of every camera pass in the newest frame the profiler has results for
+	double GpuMilliseconds()
+	{
+		const Profiler::FrameTimings& frameTimings = Profiler::GetFrameTimings();
+
+		double dMilliseconds = 0.0;
+		for (unsigned int i = 0; i < frameTimings.vGpu.size(); ++i)
+		{
+			if (strcmp(frameTimings.vGpu[i].szName, "Camera Pass") == 0)
+				dMilliseconds += frameTimings.vGpu[i].dMilliseconds;
+		}
+		return dMilliseconds;
+	}
+}
+
+void Graphics::SetDynamicResolution(const bool ac_bEnabled)
+{
+	bDynamic = ac_bEnabled;
+	dSmoothed = 0.0;
+	uiSettle = 0;
+}
+bool Graphics::IsDynamicResolution()
+{
+	return bDynamic;
+}
+
+void Graphics::SetTargetFrameTime(const double ac_dMilliseconds)
+{
+	dTargetMilliseconds = ac_dMilliseconds;
+}
+double Graphics::GetTargetFrameTime()
+{
+	return dTargetMilliseconds;
+}
+void Graphics::SetResolutionScaleRange(const float ac_fMin, const float ac_fMax)
+{
+	fMinScale = ac_fMin;
+	fMaxScale = ac_fMax;
+
+	SetResolutionScale(fScale);
+}
+
+void Graphics::SetIntegerScaling(const bool ac_bEnabled)
+{
+	bInteger = ac_bEnabled;
+
+	SetResolutionScale(fScale);
+}
+bool Graphics::IsIntegerScaling()
+{
+	return bInteger;
+}
+
+void Graphics::SetResolutionScale(const float ac_fScale)
+{
+	const float fClamped = ac_fScale < fMinScale ? fMinScale : (ac_fScale > fMaxScale ? fMaxScale : ac_fScale);
+	if (!bInteger)
+	{
+		SetScale(fClamped, 1);
+		return;
+	}
+
+	// Rounded down to the nearest 1 / n, unless that would go below the smallest scale allowed
+	unsigned int uiNewFactor = (unsigned int)ceil(1.0f / fClamped - 0.001f);
+	if (1.0f / uiNewFactor < fMinScale && uiNewFactor > 1)
+		--uiNewFactor;
+	SetScale(1.0f / uiNewFactor, uiNewFactor);
+}
+float Graphics::GetResolutionScale()
+{
+	return fScale;
+}
+System::Size2D<unsigned int> Graphics::GetInternalSize(const unsigned int ac_uiWindow)
+{
+	const System::Size2D<unsigned int>& Dimensions = voWindows[ac_uiWindow]->GetDimensions();
+
+	const GLint iWidth = ScaleLength((GLint)Dimensions.W);
+	const GLint iHeight = ScaleLength((GLint)Dimensions.H);
+
+	const System::Size2D<unsigned int> Internal = { iWidth > 0 ? (unsigned int)iWidth : 1, iHeight > 0 ? (unsigned int)iHeight : 1 };
+	return Internal;
+}
+
+void Graphics::ScaledViewport(const GLint ac_iX, const GLint ac_iY, const GLsizei ac_iWidth, const GLsizei ac_iHeight)
+{
+	// Both edges are scaled rather than the width, so cameras that share an edge still share it afterwards
+	const GLint iLeft = ScaleLength(ac_iX);
+	const GLint iBottom = ScaleLength(ac_iY);
+	GLState::Viewport(iLeft, iBottom, ScaleLength(ac_iX + ac_iWidth) - iLeft, ScaleLength(ac_iY + ac_iHeight) - iBottom);
+}
+
+void Graphics::UpdateResolutionScale(const double ac_dMilliseconds)
+{
+	if (!bDynamic)
+		return;
+
+	// Whichever of the CPU and the GPU is slower is what holds the frame up
+	const double dGpu = GpuMilliseconds();
+	const double dFrame = dGpu > ac_dMilliseconds ? dGpu : ac_dMilliseconds;
+
+	dSmoothed = dSmoothed == 0.0 ? dFrame : dSmoothed + (dFrame - dSmoothed) * kdSmoothing;
+	if (++uiSettle < kuiSettleFrames)
+		return;
+
+	// The time spent filling pixels grows with the square of the scale, so that is what the next scale is predicted from
+	if (dSmoothed > dTargetMilliseconds)
+	{
+		if (bInteger)
+		{
+			if (1.0f / (uiFactor + 1) >= fMinScale)
+				SetScale(1.0f / (uiFactor + 1), uiFactor + 1);
+			return;
+		}
+
+		float fNewScale = fScale * (float)sqrt(dTargetMilliseconds / dSmoothed);
+		fNewScale = fNewScale < fScale * kfMaxStepDown ? fScale * kfMaxStepDown : fNewScale;
+		SetScale(fNewScale < fMinScale ? fMinScale : fNewScale, 1);
+	}
+	else
+	{
+		const float fNewScale = bInteger ? (uiFactor > 1 ? 1.0f / (uiFactor - 1) : 1.0f) : (fScale + kfStepUp > fMaxScale ? fMaxScale : fScale + kfStepUp);
+		if (fNewScale <= fScale || fNewScale > fMaxScale)
+			return;
+
+		const double dRatio = fNewScale / fScale;
+		if (dSmoothed * dRatio * dRatio < dTargetMilliseconds * kdHeadroom)
+			SetScale(fNewScale, bInteger ? uiFactor - 1 : 1);
+	}
+}
+
+void Graphics::BindWindowTarget(const unsigned int ac_uiWindow)
+{
+	const System::Size2D<unsigned int>& Dimensions = voWindows[ac_uiWindow]->GetDimensions();
+	const System::Size2D<unsigned int> Internal = GetInternalSize(ac_uiWindow);
+	if ((Internal.W == Dimensions.W && Internal.H == Dimensions.H) || !Framebuffer::IsSupported())
+	{
+		// Anything the window's texture already holds of this frame was drawn at another scale and is left behind
+		if (ac_uiWindow < vTargets.size())
+			vTargets[ac_uiWindow].bDrawn = false;
+
+		Framebuffer::Bind(0);
+		return;
+	}
+
+	Target& target = GetTarget(ac_uiWindow, Internal);
+	Framebuffer::Bind(target.framebuffer.uiFramebuffer);
+	if (target.framebuffer.uiFramebuffer == 0)
+		return;
+
+	// 'Flip' clears the back buffer once the frame is shown, so the texture is cleared the same way before each frame
+	target.Drawn = Internal;
+	if (!target.bDrawn)
+	{
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		target.bDrawn = true;
+	}
+}
+void Graphics::BindCurrentWindowTarget()
+{
+	SDL_Window* sdlWindow = SDL_GL_GetCurrentWindow();
+	for (unsigned int i = 0; i < voWindows.size(); ++i)
+	{
+		if (voWindows[i]->GetWindow() == sdlWindow)
+		{
+			BindWindowTarget(i);
+			return;
+		}
+	}
+}
+
+void Graphics::Upscale(const unsigned int ac_uiWindow)
+{
+	Window* pWindow = voWindows[ac_uiWindow];
+	const System::Size2D<unsigned int>& Dimensions = pWindow->GetDimensions();
+	System::Size2D<unsigned int> Internal = GetInternalSize(ac_uiWindow);
+
+	// A window with a framebuffer was drawn into its texture, at whatever scale was current then
+	const bool bOffscreen = ac_uiWindow < vTargets.size() && vTargets[ac_uiWindow].framebuffer.uiFramebuffer != 0;
+	if (bOffscreen)
+	{
+		if (!vTargets[ac_uiWindow].bDrawn)
+			return;
+		Internal = vTargets[ac_uiWindow].Drawn;
+	}
+	else if (Internal.W == Dimensions.W && Internal.H == Dimensions.H)
+		return;
+
+	PROFILE_ZONE("Upscale");
+
+	Target& target = bOffscreen ? vTargets[ac_uiWindow] : GetTarget(ac_uiWindow, Internal);
+
+	GLState::BindTexture(target.uiTexture);
+	if (bOffscreen)
+	{
+		Framebuffer::Bind(0);
+		target.bDrawn = false;
+	}
+	else
+		glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, Internal.W, Internal.H);
+
+	// Pixel art is stretched by a whole number without filtering, so every pixel stays square and sharp
+	const GLint iFilter = bInteger ? GL_NEAREST : GL_LINEAR;
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, iFilter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, iFilter);
+
+	// With integer scaling the few pixels a whole number doesn't cover are left as a border around the middle
+	const GLsizei iWidth = bInteger ? Internal.W * uiFactor : Dimensions.W;
+	const GLsizei iHeight = bInteger ? Internal.H * uiFactor : Dimensions.H;
+
+	glClear(GL_COLOR_BUFFER_BIT);
+	GLState::Viewport((Dimensions.W - iWidth) / 2, (Dimensions.H - iHeight) / 2, iWidth, iHeight);
+
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(0, 1, 0, 1, -1, 1);
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+
+	const GLState::Cache& cache = GLState::Current();
+	const bool bBlend = cache.bBlendKnown ? cache.bBlend : glIsEnabled(GL_BLEND) == GL_TRUE;
+
+	GLState::Blend(false);
+	GLState::Color(255, 255, 255, 255);
+
+	// Filtering reaches half a texel past the coordinates, so they stop at the centers of the edge texels. Past them are texels
+	// the frame never drew into, and with 'GL_CLAMP' the texture's border color
+	const GLfloat fInset = bInteger ? 0.0f : 0.5f;
+	const GLfloat fU0 = fInset / target.iWidth;
+	const GLfloat fV0 = fInset / target.iHeight;
+	const GLfloat fU1 = (Internal.W - fInset) / target.iWidth;
+	const GLfloat fV1 = (Internal.H - fInset) / target.iHeight;
+
+	glBegin(GL_QUADS);
+	glTexCoord2f(fU0, fV0); glVertex2f(0.0f, 0.0f);
+	glTexCoord2f(fU1, fV0); glVertex2f(1.0f, 0.0f);
+	glTexCoord2f(fU1, fV1); glVertex2f(1.0f, 1.0f);
+	glTexCoord2f(fU0, fV1); glVertex2f(0.0f, 1.0f);
+	glEnd();
+
+	// Put back what the next frame expects to draw with
+	GLState::Blend(bBlend);
+	ScaledViewport(0, 0, Dimensions.W, Dimensions.H);
+
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(0, pWindow->GetResolution().W, pWindow->GetResolution().H, 0, -1, 1);
+	glMatrixMode(GL_MODELVIEW);
+}
+void Graphics::EndUpscale()
+{
+	Framebuffer::Bind(0);
+
+	for (unsigned int i = 0; i < vTargets.size(); ++i)
+		vTargets[i].bDrawn = false;
+}
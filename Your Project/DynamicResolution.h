@@ -0,0 +1,72 @@
+//////////////////////////////////////////////////////////////
+// File: DynamicResolution.h
+// Author: Ben Odom
+// Brief: Draws each window at a lower internal size when a
+//		  frame takes longer than it should, and stretches it
+//		  back over the whole window with one textured quad
+//		  just before it is swapped. Each window is drawn
+//		  into a texture of its own through a framebuffer
+//		  object. Drivers without them draw into the corner of
+//		  the back buffer, which is copied into the texture
+//		  with 'glCopyTexSubImage2D' and so only holds the
+//		  frame while the window is shown. Cameras keep their
+//		  resolution, so everything is still placed in the
+//		  same units and only fewer pixels are filled
+//////////////////////////////////////////////////////////////
+
+#ifndef _DYNAMICRESOLUTION_H_
+#define _DYNAMICRESOLUTION_H_
+
+#include "Graphics.h"
+
+namespace Graphics
+{
+	// - Turns the frame time controller on or off. While it is off, the scale stays wherever 'SetResolutionScale' puts it
+	void SetDynamicResolution(const bool ac_bEnabled);
+	// - Whether the frame time controller is on
+	bool IsDynamicResolution();
+
+	// - Sets the frame time in milliseconds the controller lowers the scale to stay under. 1000 / 60 by default
+	void SetTargetFrameTime(const double ac_dMilliseconds);
+	// - Returns the frame time the controller aims for
+	double GetTargetFrameTime();
+	// - Sets the smallest and largest scale the controller may pick. 0.5 and 1 by default
+	void SetResolutionScaleRange(const float ac_fMin, const float ac_fMax);
+
+	/* - Turns integer scaling on or off, for pixel art. It is off by default
+	   The internal size is then always the window's size divided by a whole number, and is stretched without filtering
+	*/
+	void SetIntegerScaling(const bool ac_bEnabled);
+	// - Whether the internal size is kept to the window's size divided by a whole number
+	bool IsIntegerScaling();
+
+	// - Sets the scale every window is drawn at, from 0 to 1. With integer scaling on it is rounded down to 1 / n
+	void SetResolutionScale(const float ac_fScale);
+	// - Returns the scale every window is drawn at. 1 means windows are drawn straight into the whole back buffer
+	float GetResolutionScale();
+	// - Returns how many pixels wide and high a window is drawn into at the current scale
+	System::Size2D<unsigned int> GetInternalSize(const unsigned int ac_uiWindow);
+
+	// - Sets the view-port to a rectangle of the current window given in window pixels, shrunk to the current scale
+	void ScaledViewport(const GLint ac_iX, const GLint ac_iY, const GLsizei ac_iWidth, const GLsizei ac_iHeight);
+
+	/* - Gives the controller how long the last frame took to make, not counting any wait for vsync
+	   GPU time from the profiler is used too when it is available. 'GameLoop' calls it once a frame after 'Present'
+	*/
+	void UpdateResolutionScale(const double ac_dMilliseconds);
+
+	/* - Points drawing at where the window's frame goes at the current scale: a texture of its own while it is drawn smaller, or
+	   else the window. The texture is cleared the first time each frame. 'DrawCameras' calls it for the window of each camera
+	*/
+	void BindWindowTarget(const unsigned int ac_uiWindow);
+	// - 'BindWindowTarget' for whichever window is current. 'Present' calls it for the window it leaves current
+	void BindCurrentWindowTarget();
+
+	// - Stretches what was drawn at the internal size over the whole window. 'Present' calls it on each window it swaps
+	void Upscale(const unsigned int ac_uiWindow);
+	// - Points drawing back at the windows so they can be swapped, and throws away what windows that weren't stretched drew
+	//   'Present' calls it once every changed window has been through 'Upscale'
+	void EndUpscale();
+}
+
+#endif // _DYNAMICRESOLUTION_H_
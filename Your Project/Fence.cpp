@@ -0,0 +1,90 @@
+#include "Fence.h"
+
+#include <cstdio>
+
+// OpenGL 1.1 headers don't know about sync objects
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+
+namespace
+{
+	typedef Graphics::Fence::Handle (APIENTRY *FenceSyncFunc)(GLenum, GLbitfield);
+	typedef void (APIENTRY *DeleteSyncFunc)(Graphics::Fence::Handle);
+	typedef GLenum (APIENTRY *ClientWaitSyncFunc)(Graphics::Fence::Handle, GLbitfield, Uint64);
+	typedef void (APIENTRY *WaitSyncFunc)(Graphics::Fence::Handle, GLbitfield, Uint64);
+
+	const Uint64 kuiTimeoutIgnored = 0xFFFFFFFFFFFFFFFFull; // 'GL_TIMEOUT_IGNORED', for 'glWaitSync'
+	const Uint64 kuiWaitNanoseconds = 100000000;			// How long 'Wait' waits at a time. It keeps waiting until the fence is passed
+
+	int iSupported = -1; // -1 until the entry points have been loaded
+
+	struct SyncFuncs
+	{
+		FenceSyncFunc		FenceSync;
+		DeleteSyncFunc		DeleteSync;
+		ClientWaitSyncFunc	ClientWaitSync;
+		WaitSyncFunc		WaitSync;
+	};
+	SyncFuncs gl;
+}
+
+bool Graphics::Fence::IsSupported()
+{
+	if (iSupported < 0)
+	{
+		if (SDL_GL_GetCurrentContext() == NULL)
+			return false;
+
+		// The ARB extension is the same as OpenGL 3.2's, so its functions have no suffix
+		gl.FenceSync = (FenceSyncFunc)SDL_GL_GetProcAddress("glFenceSync");
+		gl.DeleteSync = (DeleteSyncFunc)SDL_GL_GetProcAddress("glDeleteSync");
+		gl.ClientWaitSync = (ClientWaitSyncFunc)SDL_GL_GetProcAddress("glClientWaitSync");
+		gl.WaitSync = (WaitSyncFunc)SDL_GL_GetProcAddress("glWaitSync");
+
+		iSupported =
+			SDL_GL_ExtensionSupported("GL_ARB_sync") &&
+			gl.FenceSync != NULL && gl.DeleteSync != NULL && gl.ClientWaitSync != NULL && gl.WaitSync != NULL;
+
+		if (!iSupported)
+			printf("Fence: GL_ARB_sync is not supported, 'glFinish' is used instead\n");
+	}
+
+	return iSupported > 0;
+}
+
+Graphics::Fence::Handle Graphics::Fence::Insert()
+{
+	if (!IsSupported())
+		return NULL;
+
+	const Handle fence = gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush(); // A fence another context waits on has to reach the GPU, or the wait never ends
+	return fence;
+}
+
+void Graphics::Fence::GpuWait(const Handle ac_Fence)
+{
+	if (ac_Fence != NULL)
+		gl.WaitSync(ac_Fence, 0, kuiTimeoutIgnored);
+}
+
+void Graphics::Fence::Wait(const Handle ac_Fence)
+{
+	if (ac_Fence == NULL)
+		return;
+
+	// 'Insert' already flushed the fence, so the wait doesn't have to
+	while (gl.ClientWaitSync(ac_Fence, 0, kuiWaitNanoseconds) == GL_TIMEOUT_EXPIRED)
+	{
+	}
+}
+
+void Graphics::Fence::Delete(const Handle ac_Fence)
+{
+	if (ac_Fence != NULL)
+		gl.DeleteSync(ac_Fence);
+}
@@ -0,0 +1,42 @@
+//////////////////////////////////////////////////////////////
+// File: Fence.h
+// Author: Ben Odom
+// Brief: Fences from the ARB_sync extension, which mark a
+//		  point in a context's commands that another context
+//		  or thread can wait for without finishing everything.
+//		  OpenGL 1.1 headers don't declare them, so the entry
+//		  points are loaded through SDL the same way the
+//		  profiler loads its timer queries. Without them
+//		  callers fall back to 'glFinish'
+//////////////////////////////////////////////////////////////
+
+#ifndef _FENCE_H_
+#define _FENCE_H_
+
+#include <SDL.h>
+#include <glut.h>
+
+namespace Graphics
+{
+	namespace Fence
+	{
+		// A fence, the same as ARB_sync's 'GLsync'. Fences are shared by every context sharing with 'glContext'
+		typedef struct Object* Handle;
+
+		/* - Whether fences can be used. The entry points are loaded the first time, from whichever context is current
+		   Every context shares with 'glContext' and so has the same driver, which lets any of them use what was loaded
+		*/
+		bool IsSupported();
+
+		// - Puts a fence after everything the current context has issued and flushes it, so other contexts can wait on it. Returns NULL without ARB_sync
+		Handle Insert();
+		// - Makes the current context's GPU commands issued after this wait for the fence, without the calling thread waiting
+		void GpuWait(const Handle ac_Fence);
+		// - Waits on the calling thread until the GPU has passed the fence
+		void Wait(const Handle ac_Fence);
+		// - Deletes a fence. Waits already issued on it still finish
+		void Delete(const Handle ac_Fence);
+	}
+}
+
+#endif // _FENCE_H_
@@ -0,0 +1,157 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'snprintf' with Visual Studio's SDL checks turned on
+
+#include "Framebuffer.h"
+
+#include <cstdio>
+
+// OpenGL 1.1 headers don't know about framebuffer objects. The ARB and EXT extensions use the same values
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#endif
+#ifndef GL_RENDERBUFFER
+#define GL_RENDERBUFFER 0x8D41
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#endif
+#ifndef GL_DEPTH_ATTACHMENT
+#define GL_DEPTH_ATTACHMENT 0x8D00
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_DEPTH_COMPONENT16
+#define GL_DEPTH_COMPONENT16 0x81A5
+#endif
+
+namespace
+{
+	typedef void (APIENTRY *GenFunc)(GLsizei, GLuint*);
+	typedef void (APIENTRY *DeleteFunc)(GLsizei, const GLuint*);
+	typedef void (APIENTRY *BindFunc)(GLenum, GLuint);
+	typedef GLenum (APIENTRY *CheckFramebufferStatusFunc)(GLenum);
+	typedef void (APIENTRY *FramebufferTexture2DFunc)(GLenum, GLenum, GLenum, GLuint, GLint);
+	typedef void (APIENTRY *FramebufferRenderbufferFunc)(GLenum, GLenum, GLenum, GLuint);
+	typedef void (APIENTRY *RenderbufferStorageFunc)(GLenum, GLenum, GLsizei, GLsizei);
+
+	int iSupported = -1; // -1 until the entry points have been loaded
+	GLuint uiBound = 0;
+
+	// Loaded once, since every window draws with the same context
+	struct FramebufferFuncs
+	{
+		GenFunc						GenFramebuffers;
+		DeleteFunc					DeleteFramebuffers;
+		BindFunc					BindFramebuffer;
+		CheckFramebufferStatusFunc	CheckFramebufferStatus;
+		FramebufferTexture2DFunc	FramebufferTexture2D;
+		GenFunc						GenRenderbuffers;
+		DeleteFunc					DeleteRenderbuffers;
+		BindFunc					BindRenderbuffer;
+		RenderbufferStorageFunc		RenderbufferStorage;
+		FramebufferRenderbufferFunc FramebufferRenderbuffer;
+	};
+	FramebufferFuncs gl;
+
+	// - Loads every entry point with 'ac_szSuffix' on the end of its name, returning whether they were all there
+	bool Load(const char* const ac_szSuffix)
+	{
+		char szName[64];
+#define LOAD_FRAMEBUFFER_FUNC(Name, Type) \
+		snprintf(szName, sizeof(szName), "gl%s%s", #Name, ac_szSuffix); \
+		gl.Name = (Type)SDL_GL_GetProcAddress(szName); \
+		if (gl.Name == NULL) \
+			return false;
+
+		LOAD_FRAMEBUFFER_FUNC(GenFramebuffers, GenFunc)
+		LOAD_FRAMEBUFFER_FUNC(DeleteFramebuffers, DeleteFunc)
+		LOAD_FRAMEBUFFER_FUNC(BindFramebuffer, BindFunc)
+		LOAD_FRAMEBUFFER_FUNC(CheckFramebufferStatus, CheckFramebufferStatusFunc)
+		LOAD_FRAMEBUFFER_FUNC(FramebufferTexture2D, FramebufferTexture2DFunc)
+		LOAD_FRAMEBUFFER_FUNC(GenRenderbuffers, GenFunc)
+		LOAD_FRAMEBUFFER_FUNC(DeleteRenderbuffers, DeleteFunc)
+		LOAD_FRAMEBUFFER_FUNC(BindRenderbuffer, BindFunc)
+		LOAD_FRAMEBUFFER_FUNC(RenderbufferStorage, RenderbufferStorageFunc)
+		LOAD_FRAMEBUFFER_FUNC(FramebufferRenderbuffer, FramebufferRenderbufferFunc)
+#undef LOAD_FRAMEBUFFER_FUNC
+
+		return true;
+	}
+}
+
+bool Graphics::Framebuffer::IsSupported()
+{
+	if (iSupported < 0)
+	{
+		if (SDL_GL_GetCurrentContext() == NULL)
+			return false;
+
+		// The ARB extension is the same as OpenGL 3.0's, so its functions have no suffix
+		iSupported =
+			(SDL_GL_ExtensionSupported("GL_ARB_framebuffer_object") && Load("")) ||
+			(SDL_GL_ExtensionSupported("GL_EXT_framebuffer_object") && Load("EXT"));
+
+		if (!iSupported)
+			printf("Framebuffer: GL_ARB_framebuffer_object and GL_EXT_framebuffer_object are not supported, drawing stays in the window\n");
+	}
+
+	return iSupported > 0;
+}
+
+bool Graphics::Framebuffer::Create(Target& a_Target, const GLuint ac_uiTexture, const GLsizei ac_iWidth, const GLsizei ac_iHeight)
+{
+	Destroy(a_Target);
+	if (!IsSupported())
+		return false;
+
+	const GLuint uiPrevious = uiBound;
+
+	gl.GenFramebuffers(1, &a_Target.uiFramebuffer);
+	gl.GenRenderbuffers(1, &a_Target.uiDepth);
+
+	gl.BindRenderbuffer(GL_RENDERBUFFER, a_Target.uiDepth);
+	gl.RenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, ac_iWidth, ac_iHeight);
+	gl.BindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	Bind(a_Target.uiFramebuffer);
+	gl.FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ac_uiTexture, 0);
+	gl.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, a_Target.uiDepth);
+	const bool bComplete = gl.CheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	Bind(uiPrevious);
+
+	if (!bComplete)
+	{
+		printf("Framebuffer: A %d x %d texture can't be drawn into, drawing stays in the window\n", ac_iWidth, ac_iHeight);
+		Destroy(a_Target);
+	}
+	return bComplete;
+}
+
+void Graphics::Framebuffer::Destroy(Target& a_Target)
+{
+	if (a_Target.uiFramebuffer == 0)
+		return;
+
+	if (uiBound == a_Target.uiFramebuffer)
+		Bind(0);
+
+	gl.DeleteFramebuffers(1, &a_Target.uiFramebuffer);
+	gl.DeleteRenderbuffers(1, &a_Target.uiDepth);
+
+	a_Target.uiFramebuffer = 0;
+	a_Target.uiDepth = 0;
+}
+
+void Graphics::Framebuffer::Bind(const GLuint ac_uiFramebuffer)
+{
+	if (ac_uiFramebuffer == uiBound || !IsSupported())
+		return;
+
+	gl.BindFramebuffer(GL_FRAMEBUFFER, ac_uiFramebuffer);
+	uiBound = ac_uiFramebuffer;
+}
+
+GLuint Graphics::Framebuffer::GetBound()
+{
+	return uiBound;
+}
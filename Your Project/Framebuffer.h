@@ -0,0 +1,49 @@
+//////////////////////////////////////////////////////////////
+// File: Framebuffer.h
+// Author: Ben Odom
+// Brief: Offscreen targets to draw into instead of a window,
+//		  made with framebuffer objects from the ARB or EXT
+//		  extension. OpenGL 1.1 headers don't declare them, so
+//		  the entry points are loaded through SDL the same way
+//		  the profiler loads its timer queries. Callers keep a
+//		  way of working without them for drivers that have
+//		  neither extension
+//////////////////////////////////////////////////////////////
+
+#ifndef _FRAMEBUFFER_H_
+#define _FRAMEBUFFER_H_
+
+#include <SDL.h>
+#include <glut.h>
+
+namespace Graphics
+{
+	namespace Framebuffer
+	{
+		// A framebuffer drawing into a texture, with a depth buffer of its own
+		struct Target
+		{
+			GLuint uiFramebuffer; // 0 if there is none
+			GLuint uiDepth;
+		};
+
+		/* - Whether framebuffer objects can be used. The entry points are loaded the first time, from whichever context is current
+		   Framebuffer objects aren't shared between contexts, so only draw into them from the one every window shares
+		*/
+		bool IsSupported();
+
+		/* - Makes 'a_Target' draw into level 0 of 'ac_uiTexture', which is 'ac_iWidth' by 'ac_iHeight', replacing whatever it drew into before
+		   Returns false and leaves 'a_Target' empty if the driver can't draw into the texture
+		*/
+		bool Create(Target& a_Target, const GLuint ac_uiTexture, const GLsizei ac_iWidth, const GLsizei ac_iHeight);
+		// - Deletes the framebuffer and depth buffer of 'a_Target', leaving it empty
+		void Destroy(Target& a_Target);
+
+		// - Points drawing and 'glReadPixels' at a framebuffer, or at the current window's back buffer with 0
+		void Bind(const GLuint ac_uiFramebuffer);
+		// - Returns the framebuffer drawing goes to, 0 for the current window's back buffer
+		GLuint GetBound();
+	}
+}
+
+#endif // _FRAMEBUFFER_H_
@@ -1,31 +1,137 @@
 #include "GameLoop.h"
+#include "CounterExport.h"
+#include "DynamicResolution.h"
+#include "Input.h"
+#include "Latency.h"
+#include "Overdraw.h"
+#include "RenderPass.h"
+#include "Replay.h"
+#include "Profiler.h"
+#include "PerfHud.h"
+#include "Present.h"
+#include "SurfaceLoader.h"
+
+#include <thread>
 
 
 
 void GameLoop::Loop()
 {
-	SDL_Event sdlEvent; // Will hold the next event to be parsed
+	if (!Input::IsThreaded())
+	{
+		while (m_bRunning)
+			Frame();
+		return;
+	}
+
+	// The windows' context can only be current on one thread at a time, so it is handed to the game thread and back afterwards
+	SDL_Window* sdlWindow = SDL_GL_GetCurrentWindow();
+	SDL_GLContext sdlContext = SDL_GL_GetCurrentContext();
+	SDL_GL_MakeCurrent(sdlWindow, NULL);
+
+	std::atomic<bool> bGameRunning(true);
+	std::thread gameThread([&]()
+	{
+		Profiler::NameThread("Game");
+		SDL_GL_MakeCurrent(sdlWindow, sdlContext);
+
+		while (m_bRunning)
+			Frame();
+
+		SDL_GL_MakeCurrent(sdlWindow, NULL);
+		bGameRunning.store(false, std::memory_order_release);
+	});
+
+	// This thread made the windows, so it is the one SDL gives their events to
+	Profiler::NameThread("Input");
+	Input::RunPump(bGameRunning);
+
+	gameThread.join();
+	SDL_GL_MakeCurrent(sdlWindow, sdlContext);
+}
+
+void GameLoop::Frame()
+{
+	// Every phase of the frame is wrapped in a 'PROFILE_ZONE' so its time shows up in the profiler's trace
+	Profiler::BeginFrame();
+	const Uint64 uiFrameStart = Profiler::Now();
+
+	// When each phase ended, for 'CounterExport'. Unlike zones these are taken whether or not the profiler is recording
+	Uint64 auiPhaseEnds[Graphics::PerfCounters::PHASE_COUNT];
 
-	while (m_bRunning)
 	{
-		// Events get called one at a time, so if multiple things happen in one frame, they get parsed individually through 'SDL_PollEvent'
-		// The next event to parse gets stored into 'sdlEvent', and then passed to the 'EventHandler' class which will call it's appropriate function here
-		// 'SDL_PollEvent' returns 0 when there are no more events to parse
-		while (SDL_PollEvent(&sdlEvent))
+		PROFILE_ZONE("Events");
+
+		Input::BeginFrame(); // Clears what was pressed and released last frame, keeping what is still held
+
+		// Every event that happened since last frame is taken at once, with runs of mouse and joystick motion merged together
+		// so a high polling rate mouse costs one 'OnMouseMove' a frame rather than hundreds
+		Input::PollEvents(m_vEvents);
+		Replay::Pump(m_vEvents); // Writes the events to the log being recorded, or swaps them for the recorded ones while a replay plays
+
+		// Events get called one at a time, so if multiple things happen in one frame, they get parsed individually
+		for (unsigned int i = 0; i < m_vEvents.size(); ++i)
 		{
+			Input::Process(m_vEvents[i]); // Kept up to date first, so the callbacks below can already ask it what is held
+
+			// Timed until the frame this 'Update' makes has been presented. Replayed events carry recorded times rather than real ones
+			if (!Replay::IsReplaying())
+				Latency::Dispatch(m_vEvents[i]);
+
 			// Calls the redefined event function for the EventHandler class
 			// Refer to its header file and cpp for more information on what each inherited function is capable of
 			// and its syntax
-			OnEvent(sdlEvent);
+			OnEvent(m_vEvents[i].sdlEvent);
 		}
-		Update();
+	}
+	auiPhaseEnds[Graphics::PerfCounters::PHASE_EVENTS] = Profiler::Now();
+	Graphics::UpdateSurfaceLoader(); // Uploads what it can of any images 'LoadSurfaceAsync' has finished decoding
+	Graphics::UpdateTextureStreaming(); // Uploads or drops mip levels of streamed textures as the cameras zoom
 
+	{
+		PROFILE_ZONE("Update");
+		Update();
+	}
+	auiPhaseEnds[Graphics::PerfCounters::PHASE_UPDATE] = Profiler::Now();
+	{
+		PROFILE_ZONE("LateUpdate");
 		LateUpdate();
-
+	}
+	auiPhaseEnds[Graphics::PerfCounters::PHASE_LATE_UPDATE] = Profiler::Now();
+	{
+		PROFILE_ZONE("Draw");
+		Graphics::WaitForPresent(); // Windows swapped from their own threads have to finish before anything is drawn into them
 		Draw();
+		PerfHud::DrawOverlay(); // Above everything 'Draw' put in the window, whenever it called 'PerfHud::Draw'
+	}
+	auiPhaseEnds[Graphics::PerfCounters::PHASE_DRAW] = Profiler::Now();
+
+	// How long the frame took to make, before 'Present' can wait on vsync
+	const double dFrameMilliseconds = Profiler::ToMilliseconds(auiPhaseEnds[Graphics::PerfCounters::PHASE_DRAW] - uiFrameStart);
+	{
+		PROFILE_ZONE("Flip");
+		Graphics::Present(); // Required to update the windows with all the newly drawn content
+	}
+	auiPhaseEnds[Graphics::PerfCounters::PHASE_PRESENT] = Profiler::Now();
+	Graphics::UpdateResolutionScale(dFrameMilliseconds); // Changes the scale the next frame is drawn at, after this one was stretched at its own
+	Graphics::GLState::InvalidateAll(); // 'Present' changes OpenGL state that 'GLState' can't see
+
+	Graphics::EndFrameStats();
 
-		Graphics::Flip(); // Required to update the window with all the newly drawn content
+	if (CounterExport::IsOpen())
+	{
+		// Each phase runs from the end of the one before, so the uploads between the events and 'Update' count towards the update
+		double adPhaseMilliseconds[Graphics::PerfCounters::PHASE_COUNT];
+		Uint64 uiPhaseStart = uiFrameStart;
+		for (unsigned int i = 0; i < Graphics::PerfCounters::PHASE_COUNT; ++i)
+		{
+			adPhaseMilliseconds[i] = Profiler::ToMilliseconds(auiPhaseEnds[i] - uiPhaseStart);
+			uiPhaseStart = auiPhaseEnds[i];
+		}
+		CounterExport::Publish(dFrameMilliseconds, adPhaseMilliseconds);
 	}
+
+	Profiler::EndFrame();
 }
 
 void GameLoop::Update()
@@ -42,6 +148,8 @@ void GameLoop::Draw()
 	// Objects are drawn in a painter's layer fashion meaning the first object drawn is on the bottom, and the last one drawn is on the top
 	// just like a painter would paint onto a canvas
 
+	Graphics::DrawCameras(); // Draws every loaded surface through each camera, underneath everything drawn below
+
 	Graphics::DrawRect({ 400, 400 }, { 450, 400 }, { 160, 65, 255, 255 });
 	Graphics::DrawRect({ 250, 500 }, { 1000, 200 }, { 0, 255, 0, 255 });
 
@@ -50,6 +158,8 @@ void GameLoop::Draw()
 
 	Graphics::DrawRing({ 140, 140 }, 50, 25, { 50, 0, 200, 255 });
 	Graphics::DrawCircle({ 800, 450 }, 200, 50, { 0, 255, 255, 150 });
+
+	PerfHud::Draw(); // Goes over everything else once 'Draw' returns
 }
 
 void GameLoop::OnKeyDown(const SDL_Keycode ac_sdlSym, const Uint16 ac_uiMod, const SDL_Scancode ac_sdlScancode)
@@ -59,6 +169,23 @@ void GameLoop::OnKeyDown(const SDL_Keycode ac_sdlSym, const Uint16 ac_uiMod, con
 	{
 	case SDLK_ESCAPE: m_bRunning = false; break; // End the loop
 
+	case SDLK_F3: PerfHud::Toggle(); break; // Show or hide the performance HUD
+
+	case SDLK_F6: Graphics::SetOverdrawMode(!Graphics::IsOverdrawMode()); break; // Show how many times each pixel is drawn
+	case SDLK_F7: Graphics::SetDepthPass(!Graphics::IsDepthPass()); break; // Draw opaque surfaces front to back with a depth buffer
+
+	case SDLK_F8: Graphics::SetDynamicResolution(!Graphics::IsDynamicResolution()); break; // Lower the resolution when frames run long
+
+	case SDLK_F9: // Start or stop recording input to replay later with 'Benchmark --replay input.rec'
+		if (Replay::IsRecording())
+			Replay::StopRecording();
+		else if (!Replay::IsReplaying())
+			Replay::StartRecording("input.rec");
+		break;
+
+	case SDLK_F11: Profiler::Enable(!Profiler::IsEnabled()); break;		// Start or stop recording profiler zones
+	case SDLK_F12: Profiler::ExportChromeTrace("profile.json"); break;	// Save what has been recorded so far
+
 	default: printf("%s\n", SDL_GetKeyName(ac_sdlSym)); break;
 	}
 }
@@ -11,6 +11,7 @@
 
 #include "Graphics.h"
 #include "EventHandler.h"
+#include "Input.h"
 
 // This is called inheritance
 // The GameLoop class inherits every member variable and function from 'EventHandler'
@@ -23,19 +24,27 @@
 class GameLoop : private EventHandler
 {
 private:
+	std::vector<Input::Event> m_vEvents; // The events of the current frame. Kept between frames so polling doesn't allocate
+
+	// Runs one frame: events, then 'Update', 'LateUpdate', 'Draw' and 'Flip'
+	void Frame();
+
+protected:
 	bool m_bRunning; // If this is true, the game loop will continue to run
 
 public:
-	// The game loop
+	// The game loop. Runs on a thread of its own while 'Input::SetThreaded' is on, returning once it ends
 	void Loop();
 
+	// The three functions below are virtual so a scene, such as a benchmark, can inherit 'GameLoop' and replace them
+
 	// An update function that gets called directly after input is parsed
-	void Update();
+	virtual void Update();
 	// An update function that gets called directly after 'Update()'
-	void LateUpdate();
+	virtual void LateUpdate();
 
 	// An update-like function that gets called directly after 'LateUpdate'
-	void Draw();
+	virtual void Draw();
 
 	// Gets called automatically by 'EventHandler' when a key is pressed
 	void OnKeyDown(const SDL_Keycode ac_sdlSym, const Uint16 ac_uiMod, const SDL_Scancode ac_sdlScancode);
@@ -47,7 +56,7 @@ public:
 	// The default constructor
 	GameLoop();
 	// The default de-constructor
-	~GameLoop();
+	virtual ~GameLoop();
 };
 
 
@@ -0,0 +1,232 @@
+#include "Profiler.h"
+
+#include <glut.h>
+
+#include <cstdio>
+
+// OpenGL 1.1 headers don't know about timer queries, so the values from the ARB_timer_query extension are defined here
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP 0x8E28
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
+namespace
+{
+	typedef void (APIENTRY *GenQueriesFunc)(GLsizei, GLuint*);
+	typedef void (APIENTRY *QueryCounterFunc)(GLuint, GLenum);
+	typedef void (APIENTRY *GetQueryObjectivFunc)(GLuint, GLenum, GLint*);
+	typedef void (APIENTRY *GetQueryObjectui64vFunc)(GLuint, GLenum, Uint64*);
+	typedef void (APIENTRY *GetInteger64vFunc)(GLenum, Sint64*);
+
+	const unsigned int kuiMaxPending = 4096; // GPU zones waiting on results past this many are not recorded
+	const unsigned int kuiQueryBatch = 64;	 // How many query objects get created at once when a pool runs dry
+
+	// Query objects can't be shared between contexts, so every context gets its own pool and function pointers
+	struct GpuContext
+	{
+		SDL_GLContext sdlContext;
+		SDL_Window*	  sdlWindow;
+
+		bool bSupported;
+
+		GenQueriesFunc			glGenQueries;
+		QueryCounterFunc		glQueryCounter;
+		GetQueryObjectivFunc	glGetQueryObjectiv;
+		GetQueryObjectui64vFunc glGetQueryObjectui64v;
+
+		std::vector<GLuint> vFreeQueries;
+
+		// A GPU timestamp and the CPU time it was read at, used to line GPU zones up with CPU zones in the trace
+		Sint64 iGpuClock;
+		Uint64 uiCpuClock;
+	};
+
+	// A zone whose begin timestamp has been issued but not its end
+	struct OpenZone
+	{
+		const char* szName;
+		int iArg;
+
+		GpuContext* pContext; // nullptr if the zone isn't being timed
+		GLuint uiBegin;
+	};
+	// A zone waiting on the GPU for its results
+	struct PendingZone
+	{
+		const char* szName;
+		int iArg;
+		int iFrame;
+
+		GpuContext* pContext;
+		GLuint uiBegin;
+		GLuint uiEnd;
+	};
+
+	std::vector<GpuContext*> vContexts;
+	std::vector<OpenZone>	 vOpen;
+	std::vector<PendingZone> vPending; // Oldest first
+
+	GpuContext* GetCurrentContext()
+	{
+		const SDL_GLContext sdlContext = SDL_GL_GetCurrentContext();
+		if (sdlContext == NULL)
+			return nullptr;
+
+		for (unsigned int i = 0; i < vContexts.size(); ++i)
+		{
+			if (vContexts[i]->sdlContext == sdlContext)
+				return vContexts[i];
+		}
+
+		GpuContext* pContext = new GpuContext;
+		pContext->sdlContext = sdlContext;
+		pContext->sdlWindow = SDL_GL_GetCurrentWindow();
+
+		pContext->glGenQueries = (GenQueriesFunc)SDL_GL_GetProcAddress("glGenQueries");
+		pContext->glQueryCounter = (QueryCounterFunc)SDL_GL_GetProcAddress("glQueryCounter");
+		pContext->glGetQueryObjectiv = (GetQueryObjectivFunc)SDL_GL_GetProcAddress("glGetQueryObjectiv");
+		pContext->glGetQueryObjectui64v = (GetQueryObjectui64vFunc)SDL_GL_GetProcAddress("glGetQueryObjectui64v");
+		GetInteger64vFunc glGetInteger64v = (GetInteger64vFunc)SDL_GL_GetProcAddress("glGetInteger64v");
+
+		pContext->bSupported =
+			SDL_GL_ExtensionSupported("GL_ARB_timer_query") &&
+			pContext->glGenQueries != NULL && pContext->glQueryCounter != NULL &&
+			pContext->glGetQueryObjectiv != NULL && pContext->glGetQueryObjectui64v != NULL &&
+			glGetInteger64v != NULL;
+
+		if (pContext->bSupported)
+		{
+			glGetInteger64v(GL_TIMESTAMP, &pContext->iGpuClock);
+			pContext->uiCpuClock = Profiler::Now();
+		}
+		else
+			printf("Profiler: GL_ARB_timer_query is not supported, GPU zones will not be recorded\n");
+
+		vContexts.push_back(pContext);
+		return pContext;
+	}
+
+	GLuint TakeQuery(GpuContext& a_Context)
+	{
+		if (a_Context.vFreeQueries.empty())
+		{
+			a_Context.vFreeQueries.resize(kuiQueryBatch);
+			a_Context.glGenQueries(kuiQueryBatch, a_Context.vFreeQueries.data());
+		}
+
+		const GLuint uiQuery = a_Context.vFreeQueries.back();
+		a_Context.vFreeQueries.pop_back();
+
+		return uiQuery;
+	}
+
+	// Converts a GPU timestamp in nanoseconds into performance counter ticks
+	Uint64 ToCpuTicks(const GpuContext& ac_Context, const Uint64 ac_uiGpuTime)
+	{
+		const double dTicksPerNanosecond = SDL_GetPerformanceFrequency() / 1000000000.0;
+
+		return ac_Context.uiCpuClock + (Sint64)(((Sint64)ac_uiGpuTime - ac_Context.iGpuClock) * dTicksPerNanosecond);
+	}
+}
+
+void Profiler::BeginGpuZone(const char* ac_szName, const int ac_iArg)
+{
+	OpenZone zone = { ac_szName, ac_iArg, nullptr, 0 };
+
+	// A zone is pushed even when it isn't timed so that every 'EndGpuZone' still has one to pop
+	if (IsEnabled() && vPending.size() < kuiMaxPending)
+	{
+		GpuContext* pContext = GetCurrentContext();
+		if (pContext != nullptr && pContext->bSupported)
+		{
+			zone.pContext = pContext;
+			zone.uiBegin = TakeQuery(*pContext);
+			pContext->glQueryCounter(zone.uiBegin, GL_TIMESTAMP);
+		}
+	}
+
+	vOpen.push_back(zone);
+}
+void Profiler::EndGpuZone()
+{
+	if (vOpen.empty())
+		return;
+
+	const OpenZone zone = vOpen.back();
+	vOpen.pop_back();
+
+	if (zone.pContext == nullptr)
+		return;
+
+	// Timestamps from two different contexts can't be compared, so a zone that switched contexts is thrown away
+	if (SDL_GL_GetCurrentContext() != zone.pContext->sdlContext)
+	{
+		zone.pContext->vFreeQueries.push_back(zone.uiBegin);
+		return;
+	}
+
+	PendingZone pending = { zone.szName, zone.iArg, GetFrameIndex(), zone.pContext, zone.uiBegin, TakeQuery(*zone.pContext) };
+	zone.pContext->glQueryCounter(pending.uiEnd, GL_TIMESTAMP);
+
+	vPending.push_back(pending);
+}
+
+void Profiler::ResolveGpuZones()
+{
+	if (vPending.empty())
+		return;
+
+	SDL_Window*	  sdlWindow = SDL_GL_GetCurrentWindow();
+	SDL_GLContext sdlContext = SDL_GL_GetCurrentContext();
+
+	unsigned int uiResolved = 0;
+	for (; uiResolved < vPending.size(); ++uiResolved)
+	{
+		const PendingZone& zone = vPending[uiResolved];
+		GpuContext& context = *zone.pContext;
+
+		if (SDL_GL_GetCurrentContext() != context.sdlContext)
+			SDL_GL_MakeCurrent(context.sdlWindow, context.sdlContext);
+
+		// Never wait on the GPU. Everything after an unfinished zone was issued later so it can't be ready either
+		GLint iAvailable = 0;
+		context.glGetQueryObjectiv(zone.uiEnd, GL_QUERY_RESULT_AVAILABLE, &iAvailable);
+		if (iAvailable == 0)
+			break;
+
+		Uint64 uiBegin = 0;
+		Uint64 uiEnd = 0;
+		context.glGetQueryObjectui64v(zone.uiBegin, GL_QUERY_RESULT, &uiBegin);
+		context.glGetQueryObjectui64v(zone.uiEnd, GL_QUERY_RESULT, &uiEnd);
+
+		RecordGpu(zone.szName, ToCpuTicks(context, uiBegin), ToCpuTicks(context, uiEnd), zone.iArg, zone.iFrame);
+
+		context.vFreeQueries.push_back(zone.uiBegin);
+		context.vFreeQueries.push_back(zone.uiEnd);
+	}
+	vPending.erase(vPending.begin(), vPending.begin() + uiResolved);
+
+	if (sdlContext != NULL && SDL_GL_GetCurrentContext() != sdlContext)
+		SDL_GL_MakeCurrent(sdlWindow, sdlContext);
+}
+
+bool Profiler::IsGpuTimingSupported()
+{
+	const GpuContext* pContext = GetCurrentContext();
+
+	return pContext != nullptr && pContext->bSupported;
+}
+
+Profiler::ScopedGpuZone::ScopedGpuZone(const char* ac_szName, const int ac_iArg)
+{
+	BeginGpuZone(ac_szName, ac_iArg);
+}
+Profiler::ScopedGpuZone::~ScopedGpuZone()
+{
+	EndGpuZone();
+}
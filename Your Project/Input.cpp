@@ -0,0 +1,330 @@
+#include "Input.h"
+
+#include <thread>
+
+namespace
+{
+	const int kiBatch = 64; // Events taken from SDL's queue per call
+
+	const unsigned int kuiRingCapacity = 1 << 12; // Events the input thread can get ahead of the game by. Must be a power of two
+	const Uint32 kuiPumpMilliseconds = 1;		   // How often the input thread pumps
+
+	bool bCoalescing = true;
+	Input::PumpStats pumpStats = {};
+
+	bool bThreaded = false; // Set before the game thread starts, so it never needs to be atomic
+
+	/* The events the input thread has pumped and the game thread hasn't taken yet. Only the input thread writes 'uiHead' and
+	   only the game thread writes 'uiTail', so neither ever waits on a lock. They sit on their own cache lines so the two threads
+	   don't slow each other down writing them
+	*/
+	struct Ring
+	{
+		Input::Event aEvents[kuiRingCapacity];
+
+		alignas(64) std::atomic<Uint32> uiHead; // How many events have ever been pushed
+		alignas(64) std::atomic<Uint32> uiTail; // How many events have ever been taken
+	};
+	Ring ring;
+
+	// - Adds an event to the ring, unless the game stops while the ring is full. Only the input thread calls it
+	void Push(const Input::Event& ac_Event, const std::atomic<bool>& ac_bRunning)
+	{
+		const Uint32 uiHead = ring.uiHead.load(std::memory_order_relaxed);
+
+		// Waiting when the game is a whole ring behind loses nothing, since SDL keeps queueing in the meantime
+		while (uiHead - ring.uiTail.load(std::memory_order_acquire) == kuiRingCapacity)
+		{
+			if (!ac_bRunning.load(std::memory_order_acquire))
+				return;
+			std::this_thread::yield();
+		}
+
+		ring.aEvents[uiHead & (kuiRingCapacity - 1)] = ac_Event;
+		ring.uiHead.store(uiHead + 1, std::memory_order_release);
+	}
+
+	/* - Adds an event to the end of 'a_vEvents', or merges it into the motion event it supersedes
+	   Returns whether it was merged
+	*/
+	bool Append(std::vector<Input::Event>& a_vEvents, const Input::Event& ac_Event)
+	{
+		const SDL_Event& sdlEvent = ac_Event.sdlEvent;
+
+		if (sdlEvent.type == SDL_MOUSEMOTION && !a_vEvents.empty())
+		{
+			SDL_MouseMotionEvent& last = a_vEvents.back().sdlEvent.motion;
+			if (last.type == SDL_MOUSEMOTION && last.windowID == sdlEvent.motion.windowID && last.which == sdlEvent.motion.which)
+			{
+				last.timestamp = sdlEvent.motion.timestamp;
+				last.state = sdlEvent.motion.state;
+				last.x = sdlEvent.motion.x;
+				last.y = sdlEvent.motion.y;
+				last.xrel += sdlEvent.motion.xrel;
+				last.yrel += sdlEvent.motion.yrel;
+				a_vEvents.back().uiTicks = ac_Event.uiTicks;
+				return true;
+			}
+		}
+		else if (sdlEvent.type == SDL_JOYAXISMOTION)
+		{
+			// Sticks move two axes at once, so their events interleave. The whole run of axis events is searched rather than just the last one
+			for (size_t i = a_vEvents.size(); i > 0 && a_vEvents[i - 1].sdlEvent.type == SDL_JOYAXISMOTION; --i)
+			{
+				SDL_JoyAxisEvent& earlier = a_vEvents[i - 1].sdlEvent.jaxis;
+				if (earlier.which == sdlEvent.jaxis.which && earlier.axis == sdlEvent.jaxis.axis)
+				{
+					earlier.timestamp = sdlEvent.jaxis.timestamp;
+					earlier.value = sdlEvent.jaxis.value;
+					a_vEvents[i - 1].uiTicks = ac_Event.uiTicks;
+					return true;
+				}
+			}
+		}
+
+		a_vEvents.push_back(ac_Event);
+		return false;
+	}
+
+	// - Returns the slot a joystick's input goes into, giving it the first free slot the first time it is seen. -1 if every slot is taken
+	int JoystickSlot(Input::State& a_State, const SDL_JoystickID ac_sdlWhich)
+	{
+		int iFree = -1;
+		for (unsigned int i = 0; i < Input::kuiJoysticks; ++i)
+		{
+			if (a_State.aiJoystickIDs[i] == ac_sdlWhich)
+				return i;
+			if (a_State.aiJoystickIDs[i] == -1 && iFree == -1)
+				iFree = i;
+		}
+
+		if (iFree != -1)
+			a_State.aiJoystickIDs[iFree] = ac_sdlWhich;
+		return iFree;
+	}
+
+	// - Records a button going down or up in one of the sets of 'Buttons'
+	template <size_t N>
+	void SetButton(std::bitset<N>& a_Held, std::bitset<N>& a_Pressed, std::bitset<N>& a_Released, const unsigned int ac_uiButton, const bool ac_bDown)
+	{
+		if (ac_uiButton >= N)
+			return;
+
+		if (ac_bDown)
+		{
+			// Key repeats arrive as more presses of a key that is already held, which isn't a new edge
+			if (!a_Held.test(ac_uiButton))
+				a_Pressed.set(ac_uiButton);
+			a_Held.set(ac_uiButton);
+		}
+		else
+		{
+			if (a_Held.test(ac_uiButton))
+				a_Released.set(ac_uiButton);
+			a_Held.reset(ac_uiButton);
+		}
+	}
+}
+
+Input::State& Input::Get()
+{
+	static State state = []()
+	{
+		State initial = {};
+		for (unsigned int i = 0; i < kuiJoysticks; ++i)
+			initial.aiJoystickIDs[i] = -1;
+		return initial;
+	}();
+
+	return state;
+}
+
+void Input::BeginFrame()
+{
+	State& state = Get();
+
+	state.Pressed = Buttons();
+	state.Released = Buttons();
+	state.MouseDelta = { 0, 0 };
+	state.Wheel = { 0, 0 };
+}
+
+void Input::Process(const Event& ac_Event)
+{
+	State& state = Get();
+	state.uiEventTicks = ac_Event.uiTicks;
+
+	const SDL_Event& sdlEvent = ac_Event.sdlEvent;
+
+	switch (sdlEvent.type)
+	{
+	case SDL_KEYDOWN:
+	case SDL_KEYUP:
+		SetButton(state.Held.Keys, state.Pressed.Keys, state.Released.Keys, sdlEvent.key.keysym.scancode, sdlEvent.type == SDL_KEYDOWN);
+		if (sdlEvent.key.repeat == 0 && sdlEvent.key.keysym.scancode < SDL_NUM_SCANCODES)
+			state.auiKeyTicks[sdlEvent.key.keysym.scancode] = ac_Event.uiTicks;
+		break;
+
+	case SDL_MOUSEMOTION:
+		state.MousePosition = { sdlEvent.motion.x, sdlEvent.motion.y };
+		state.MouseDelta.X += sdlEvent.motion.xrel;
+		state.MouseDelta.Y += sdlEvent.motion.yrel;
+		break;
+	case SDL_MOUSEBUTTONDOWN:
+	case SDL_MOUSEBUTTONUP:
+		state.MousePosition = { sdlEvent.button.x, sdlEvent.button.y };
+		SetButton(state.Held.Mouse, state.Pressed.Mouse, state.Released.Mouse, sdlEvent.button.button, sdlEvent.type == SDL_MOUSEBUTTONDOWN);
+		break;
+	case SDL_MOUSEWHEEL:
+		state.Wheel.X += sdlEvent.wheel.x;
+		state.Wheel.Y += sdlEvent.wheel.y;
+		break;
+
+	case SDL_JOYAXISMOTION:
+	{
+		const int iSlot = JoystickSlot(state, sdlEvent.jaxis.which);
+		if (iSlot != -1 && sdlEvent.jaxis.axis < kuiJoyAxes)
+			state.aiJoyAxes[iSlot][sdlEvent.jaxis.axis] = sdlEvent.jaxis.value;
+		break;
+	}
+	case SDL_JOYBUTTONDOWN:
+	case SDL_JOYBUTTONUP:
+	{
+		const int iSlot = JoystickSlot(state, sdlEvent.jbutton.which);
+		if (iSlot != -1)
+			SetButton(state.Held.aJoysticks[iSlot], state.Pressed.aJoysticks[iSlot], state.Released.aJoysticks[iSlot], sdlEvent.jbutton.button, sdlEvent.type == SDL_JOYBUTTONDOWN);
+		break;
+	}
+	case SDL_JOYDEVICEREMOVED:
+	{
+		// The slot is freed for the next joystick, letting go of anything the removed one was holding
+		for (unsigned int i = 0; i < kuiJoysticks; ++i)
+		{
+			if (state.aiJoystickIDs[i] != sdlEvent.jdevice.which)
+				continue;
+
+			state.Released.aJoysticks[i] |= state.Held.aJoysticks[i];
+			state.Held.aJoysticks[i].reset();
+			for (unsigned int uiAxis = 0; uiAxis < kuiJoyAxes; ++uiAxis)
+				state.aiJoyAxes[i][uiAxis] = 0;
+			state.aiJoystickIDs[i] = -1;
+		}
+		break;
+	}
+
+	case SDL_WINDOWEVENT:
+		// Keys let go while another window has focus never send an event here
+		if (sdlEvent.window.event == SDL_WINDOWEVENT_FOCUS_LOST)
+			ReleaseAll();
+		break;
+
+	default: break;
+	}
+}
+
+void Input::PollEvents(std::vector<Event>& a_vEvents)
+{
+	a_vEvents.clear();
+
+	unsigned int uiTaken = 0;
+	unsigned int uiCoalesced = 0;
+
+	if (bThreaded)
+	{
+		// Everything the input thread has pushed so far is taken. Slots are only handed back once they have been read
+		const Uint32 uiTail = ring.uiTail.load(std::memory_order_relaxed);
+		const Uint32 uiHead = ring.uiHead.load(std::memory_order_acquire);
+		for (Uint32 i = uiTail; i != uiHead; ++i)
+		{
+			const Event& event = ring.aEvents[i & (kuiRingCapacity - 1)];
+			if (!bCoalescing)
+				a_vEvents.push_back(event);
+			else if (Append(a_vEvents, event))
+				++uiCoalesced;
+		}
+		ring.uiTail.store(uiHead, std::memory_order_release);
+
+		uiTaken = uiHead - uiTail;
+	}
+	else
+	{
+		SDL_PumpEvents();
+		const Uint64 uiTicks = SDL_GetPerformanceCounter();
+
+		SDL_Event aBatch[kiBatch];
+		int iCount;
+		while ((iCount = SDL_PeepEvents(aBatch, kiBatch, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT)) > 0)
+		{
+			uiTaken += iCount;
+
+			for (int i = 0; i < iCount; ++i)
+			{
+				const Event event = { aBatch[i], uiTicks };
+				if (!bCoalescing)
+					a_vEvents.push_back(event);
+				else if (Append(a_vEvents, event))
+					++uiCoalesced;
+			}
+		}
+	}
+
+	pumpStats.uiFrameEvents = uiTaken;
+	pumpStats.uiFrameDispatched = (unsigned int)a_vEvents.size();
+	pumpStats.uiFrameCoalesced = uiCoalesced;
+	pumpStats.ullCoalesced += uiCoalesced;
+}
+void Input::SetCoalescing(const bool ac_bCoalescing)
+{
+	bCoalescing = ac_bCoalescing;
+}
+bool Input::IsCoalescing()
+{
+	return bCoalescing;
+}
+const Input::PumpStats& Input::GetPumpStats()
+{
+	return pumpStats;
+}
+
+void Input::SetThreaded(const bool ac_bThreaded)
+{
+	bThreaded = ac_bThreaded;
+}
+bool Input::IsThreaded()
+{
+	return bThreaded;
+}
+void Input::RunPump(const std::atomic<bool>& ac_bRunning)
+{
+	while (ac_bRunning.load(std::memory_order_acquire))
+	{
+		SDL_PumpEvents();
+
+		SDL_Event aBatch[kiBatch];
+		int iCount;
+		while ((iCount = SDL_PeepEvents(aBatch, kiBatch, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT)) > 0)
+		{
+			// Every event from one pump arrived within the last millisecond, so they share a stamp
+			const Uint64 uiTicks = SDL_GetPerformanceCounter();
+			for (int i = 0; i < iCount; ++i)
+			{
+				const Event event = { aBatch[i], uiTicks };
+				Push(event, ac_bRunning);
+			}
+		}
+
+		SDL_Delay(kuiPumpMilliseconds);
+	}
+}
+
+void Input::ReleaseAll()
+{
+	State& state = Get();
+
+	state.Released.Keys |= state.Held.Keys;
+	state.Released.Mouse |= state.Held.Mouse;
+	for (unsigned int i = 0; i < kuiJoysticks; ++i)
+		state.Released.aJoysticks[i] |= state.Held.aJoysticks[i];
+
+	state.Held = Buttons();
+}
@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////
+// File: Input.h
+// Author: Ben Odom
+// Brief: The state of the keyboard, mouse and joysticks as of
+//		  the current frame. 'GameLoop' feeds every event into
+//		  it before calling 'OnEvent', so gameplay code can
+//		  ask whether a key is held or was pressed this frame
+//		  with a bit test instead of keeping its own tables
+//		  in the 'EventHandler' callbacks. Events can instead
+//		  be pumped by the main thread at a high rate while the
+//		  game loop runs on a thread of its own, which gives
+//		  every event the time it really happened at
+//////////////////////////////////////////////////////////////
+
+#ifndef _INPUT_H_
+#define _INPUT_H_
+
+#include "System.h"
+
+#include <SDL.h>
+
+#include <atomic>
+#include <bitset>
+#include <vector>
+
+namespace Input
+{
+	const unsigned int kuiMouseButtons = 8;	  // Enough for every 'SDL_BUTTON_...' up to 'SDL_BUTTON_X2'
+	const unsigned int kuiJoysticks = 4;	  // Joysticks past this many are ignored
+	const unsigned int kuiJoyButtons = 32;	  // Per joystick
+	const unsigned int kuiJoyAxes = 8;		  // Per joystick
+
+	// One set of bits for every button input knows about
+	struct Buttons
+	{
+		std::bitset<SDL_NUM_SCANCODES> Keys;
+		std::bitset<kuiMouseButtons> Mouse;
+		std::bitset<kuiJoyButtons> aJoysticks[kuiJoysticks];
+	};
+
+	// An event and when it was taken from SDL's queue
+	struct Event
+	{
+		SDL_Event sdlEvent;
+		Uint64 uiTicks; // 'SDL_GetPerformanceCounter' when it was pumped
+	};
+
+	// Everything input knows, as of the last event it was given
+	struct State
+	{
+		Buttons Held;
+		Buttons Pressed;  // Went down at least once this frame, even if it was let go again within the same frame
+		Buttons Released; // Went up at least once this frame
+
+		Sint16 aiJoyAxes[kuiJoysticks][kuiJoyAxes];
+		SDL_JoystickID aiJoystickIDs[kuiJoysticks]; // Which joystick each slot belongs to, or -1 if it is free
+
+		System::Point2D<int> MousePosition;
+		System::Point2D<int> MouseDelta; // How far the mouse moved this frame, summed over every motion event
+		System::Point2D<int> Wheel;		 // How far the wheel scrolled this frame
+
+		Uint64 auiKeyTicks[SDL_NUM_SCANCODES]; // When each key last went down or up
+		Uint64 uiEventTicks;				   // When the event last given to 'Process' was pumped
+	};
+
+	// How much the event pump merged, as returned by 'GetPumpStats'
+	struct PumpStats
+	{
+		unsigned int uiFrameEvents;		// Taken from SDL's queue in the last frame
+		unsigned int uiFrameDispatched; // Of those, how many were left after merging and passed on to 'OnEvent'
+		unsigned int uiFrameCoalesced;	// How many were merged into another event
+
+		unsigned long long ullCoalesced; // Since the program started
+	};
+
+	// - Returns the state shared by everything that includes this file. Only use it from the thread that runs the game loop
+	State& Get();
+
+	// - Starts a new frame, clearing the edges and the mouse and wheel movement of the last one. 'GameLoop' calls it before pumping events
+	void BeginFrame();
+	// - Updates the state with one event. 'GameLoop' calls it for every event before 'OnEvent'
+	void Process(const Event& ac_Event);
+	/* - Takes every event waiting in SDL's queue, or passed on by the input thread while it runs, and puts them in 'a_vEvents' in order, replacing what was there
+	   While coalescing is on, a run of mouse motion events becomes one with the latest position and their motion summed,
+	   and a run of joystick axis events keeps only the latest value of each axis. Any other event ends the run,
+	   so a click is always seen at the position the mouse had when it happened
+	*/
+	void PollEvents(std::vector<Event>& a_vEvents);
+	// - Turns merging motion events on or off. It is on by default
+	void SetCoalescing(const bool ac_bCoalescing);
+	// - Whether motion events are currently merged
+	bool IsCoalescing();
+	// - Returns how much the event pump merged
+	const PumpStats& GetPumpStats();
+
+	/* - Has 'GameLoop::Loop' run frames on a thread of its own, keeping the calling thread to pump events every millisecond
+	   SDL only gets a window's events on the thread that made it, so this is the thread that pumps and the game moves instead
+	   Set it before 'Loop'. The game thread draws with the window's context and must not make or change windows
+	*/
+	void SetThreaded(const bool ac_bThreaded);
+	// - Whether 'GameLoop::Loop' runs the game on a thread of its own
+	bool IsThreaded();
+	/* - Pumps SDL's events into a queue 'PollEvents' takes them from, stamping each with when it arrived, until 'ac_bRunning' turns false
+	   Run it on the thread that made the windows. 'GameLoop::Loop' does this while the input thread is on
+	*/
+	void RunPump(const std::atomic<bool>& ac_bRunning);
+
+	// - Lets go of every held button, as if each one had been released. Called when the window loses focus so nothing stays stuck down
+	void ReleaseAll();
+
+	// - Whether a key is down
+	inline bool IsKeyHeld(const SDL_Scancode ac_sdlScancode) { return Get().Held.Keys.test(ac_sdlScancode); }
+	// - Whether a key went down this frame
+	inline bool IsKeyPressed(const SDL_Scancode ac_sdlScancode) { return Get().Pressed.Keys.test(ac_sdlScancode); }
+	// - Whether a key went up this frame
+	inline bool IsKeyReleased(const SDL_Scancode ac_sdlScancode) { return Get().Released.Keys.test(ac_sdlScancode); }
+
+	// - The same as the keys, for a mouse button such as 'SDL_BUTTON_LEFT'
+	inline bool IsMouseHeld(const Uint8 ac_uiButton) { return ac_uiButton < kuiMouseButtons && Get().Held.Mouse.test(ac_uiButton); }
+	inline bool IsMousePressed(const Uint8 ac_uiButton) { return ac_uiButton < kuiMouseButtons && Get().Pressed.Mouse.test(ac_uiButton); }
+	inline bool IsMouseReleased(const Uint8 ac_uiButton) { return ac_uiButton < kuiMouseButtons && Get().Released.Mouse.test(ac_uiButton); }
+
+	/* - The same as the keys, for a button of a joystick
+	   'ac_uiJoystick' is the order joysticks first sent an event in, starting at 0, not their 'SDL_JoystickID'
+	*/
+	inline bool IsJoyButtonHeld(const unsigned int ac_uiJoystick, const Uint8 ac_uiButton) { return ac_uiJoystick < kuiJoysticks && ac_uiButton < kuiJoyButtons && Get().Held.aJoysticks[ac_uiJoystick].test(ac_uiButton); }
+	inline bool IsJoyButtonPressed(const unsigned int ac_uiJoystick, const Uint8 ac_uiButton) { return ac_uiJoystick < kuiJoysticks && ac_uiButton < kuiJoyButtons && Get().Pressed.aJoysticks[ac_uiJoystick].test(ac_uiButton); }
+	inline bool IsJoyButtonReleased(const unsigned int ac_uiJoystick, const Uint8 ac_uiButton) { return ac_uiJoystick < kuiJoysticks && ac_uiButton < kuiJoyButtons && Get().Released.aJoysticks[ac_uiJoystick].test(ac_uiButton); }
+	// - The latest value of a joystick axis, from -32768 to 32767
+	inline Sint16 GetJoyAxis(const unsigned int ac_uiJoystick, const Uint8 ac_uiAxis) { return ac_uiJoystick < kuiJoysticks && ac_uiAxis < kuiJoyAxes ? Get().aiJoyAxes[ac_uiJoystick][ac_uiAxis] : 0; }
+
+	// - Where the mouse is in the window
+	inline const System::Point2D<int>& GetMousePosition() { return Get().MousePosition; }
+	// - How far the mouse moved this frame
+	inline const System::Point2D<int>& GetMouseDelta() { return Get().MouseDelta; }
+	// - How far the wheel scrolled this frame. Positive 'Y' is away from the user
+	inline const System::Point2D<int>& GetWheel() { return Get().Wheel; }
+
+	// - When a key last went down or up, in 'SDL_GetPerformanceCounter' ticks. With the input thread on this is within a millisecond of the key really moving
+	inline Uint64 GetKeyTicks(const SDL_Scancode ac_sdlScancode) { return Get().auiKeyTicks[ac_sdlScancode]; }
+	// - When the event being dispatched was pumped. Call it from a callback, such as 'OnKeyDown', to time that event
+	inline Uint64 GetEventTicks() { return Get().uiEventTicks; }
+}
+
+#endif // _INPUT_H_
@@ -0,0 +1,228 @@
+#include "Latency.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <deque>
+
+namespace
+{
+	// An event that hasn't been shown yet
+	struct Waiting
+	{
+		Uint64 uiTicks; // When it was pumped
+		Latency::EventKind eKind;
+	};
+
+	// The latest times of one kind of event up to one stage, the oldest being overwritten first once there are 'kuiSamples'
+	struct Samples
+	{
+		std::vector<double> vMilliseconds;
+		unsigned int uiNext;
+		unsigned long long ullTotal;
+	};
+
+	const char* const aszKindNames[Latency::KIND_COUNT] = { "key", "mouse_button", "mouse_motion", "mouse_wheel", "joystick", "touch" };
+
+	bool bEnabled = true;
+	bool bGpuWait = false;
+
+	std::vector<Waiting> vDispatched; // Seen by the 'Update' of the frame being made
+	std::vector<Waiting> vPresented;  // Belonging to the frame being swapped
+	std::deque<std::vector<Waiting> > dqGpuPending; // Belonging to frames swapped that the GPU may not have finished, oldest first
+
+	Samples aaSamples[Latency::KIND_COUNT][Latency::STAGE_COUNT];
+	std::vector<double> vSorted; // Scratch space for 'GetStats'
+
+	// - Returns which kind an event is timed as, or 'KIND_COUNT' if it isn't input
+	Latency::EventKind GetKind(const Uint32 ac_uiType)
+	{
+		switch (ac_uiType)
+		{
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+		case SDL_TEXTINPUT:
+		case SDL_TEXTEDITING:
+			return Latency::KIND_KEY;
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP:
+			return Latency::KIND_MOUSE_BUTTON;
+		case SDL_MOUSEMOTION:
+			return Latency::KIND_MOUSE_MOTION;
+		case SDL_MOUSEWHEEL:
+			return Latency::KIND_MOUSE_WHEEL;
+		case SDL_JOYAXISMOTION:
+		case SDL_JOYBALLMOTION:
+		case SDL_JOYHATMOTION:
+		case SDL_JOYBUTTONDOWN:
+		case SDL_JOYBUTTONUP:
+		case SDL_CONTROLLERAXISMOTION:
+		case SDL_CONTROLLERBUTTONDOWN:
+		case SDL_CONTROLLERBUTTONUP:
+			return Latency::KIND_JOYSTICK;
+		case SDL_FINGERDOWN:
+		case SDL_FINGERUP:
+		case SDL_FINGERMOTION:
+		case SDL_MULTIGESTURE:
+		case SDL_DOLLARGESTURE:
+			return Latency::KIND_TOUCH;
+		default:
+			return Latency::KIND_COUNT;
+		}
+	}
+
+	void AddSample(Samples& a_Samples, const double ac_dMilliseconds)
+	{
+		if (a_Samples.vMilliseconds.size() < Latency::kuiSamples)
+			a_Samples.vMilliseconds.push_back(ac_dMilliseconds);
+		else
+			a_Samples.vMilliseconds[a_Samples.uiNext] = ac_dMilliseconds;
+
+		a_Samples.uiNext = (a_Samples.uiNext + 1) % Latency::kuiSamples;
+		++a_Samples.ullTotal;
+	}
+
+	// - Takes a percentile of 'vSorted' by partly sorting it, which is all 'GetStats' needs and cheap enough to do every frame
+	double Percentile(const double ac_dFraction)
+	{
+		const size_t uiIndex = std::min((size_t)(ac_dFraction * vSorted.size()), vSorted.size() - 1);
+		std::nth_element(vSorted.begin(), vSorted.begin() + uiIndex, vSorted.end());
+		return vSorted[uiIndex];
+	}
+
+	Latency::Stats Describe(const unsigned long long ac_ullTotal)
+	{
+		Latency::Stats stats = { (unsigned int)vSorted.size(), ac_ullTotal, 0.0, 0.0, 0.0, 0.0 };
+		if (vSorted.empty())
+			return stats;
+
+		stats.dMax = *std::max_element(vSorted.begin(), vSorted.end());
+		stats.dP50 = Percentile(0.5);
+		stats.dP95 = Percentile(0.95);
+		stats.dP99 = Percentile(0.99);
+		return stats;
+	}
+}
+
+void Latency::SetEnabled(const bool ac_bEnabled)
+{
+	bEnabled = ac_bEnabled;
+	if (!bEnabled)
+	{
+		vDispatched.clear();
+		vPresented.clear();
+	}
+}
+bool Latency::IsEnabled()
+{
+	return bEnabled;
+}
+
+void Latency::SetGpuWait(const bool ac_bWait)
+{
+	bGpuWait = ac_bWait;
+}
+bool Latency::IsGpuWait()
+{
+	return bGpuWait;
+}
+
+const char* Latency::GetKindName(const EventKind ac_eKind)
+{
+	return ac_eKind < KIND_COUNT ? aszKindNames[ac_eKind] : "unknown";
+}
+
+Latency::Stats Latency::GetStats(const EventKind ac_eKind, const Stage ac_eStage)
+{
+	const Samples& samples = aaSamples[ac_eKind][ac_eStage];
+	vSorted.assign(samples.vMilliseconds.begin(), samples.vMilliseconds.end());
+	return Describe(samples.ullTotal);
+}
+
+Latency::Stats Latency::GetStats(const Stage ac_eStage)
+{
+	unsigned long long ullTotal = 0;
+	vSorted.clear();
+	for (unsigned int i = 0; i < KIND_COUNT; ++i)
+	{
+		const Samples& samples = aaSamples[i][ac_eStage];
+		vSorted.insert(vSorted.end(), samples.vMilliseconds.begin(), samples.vMilliseconds.end());
+		ullTotal += samples.ullTotal;
+	}
+	return Describe(ullTotal);
+}
+
+void Latency::Reset()
+{
+	vDispatched.clear();
+	vPresented.clear();
+
+	// The frames stay, since the GPU times for them are still coming
+	for (unsigned int i = 0; i < dqGpuPending.size(); ++i)
+		dqGpuPending[i].clear();
+
+	for (unsigned int i = 0; i < KIND_COUNT; ++i)
+	{
+		for (unsigned int j = 0; j < STAGE_COUNT; ++j)
+		{
+			aaSamples[i][j].vMilliseconds.clear();
+			aaSamples[i][j].uiNext = 0;
+			aaSamples[i][j].ullTotal = 0;
+		}
+	}
+}
+
+void Latency::Dispatch(const Input::Event& ac_Event)
+{
+	if (!bEnabled)
+		return;
+
+	const EventKind eKind = GetKind(ac_Event.sdlEvent.type);
+	if (eKind == KIND_COUNT)
+		return;
+
+	// A game that never presents would otherwise keep every event it was ever given
+	if (vDispatched.size() >= kuiSamples)
+		vDispatched.erase(vDispatched.begin(), vDispatched.begin() + vDispatched.size() / 2);
+
+	const Waiting waiting = { ac_Event.uiTicks, eKind };
+	vDispatched.push_back(waiting);
+}
+
+void Latency::BeginPresent()
+{
+	// A frame whose swaps never finished, such as one presented right before a mode change, is folded into this one
+	vPresented.insert(vPresented.end(), vDispatched.begin(), vDispatched.end());
+	vDispatched.clear();
+}
+
+void Latency::EndPresent(const Uint64 ac_uiFlipTicks, const bool ac_bGpuTimed)
+{
+	for (unsigned int i = 0; i < vPresented.size(); ++i)
+	{
+		const Waiting& waiting = vPresented[i];
+
+		// A thread pumping events can stamp one after the frame it ends up in started, but never after its swap
+		if (ac_uiFlipTicks >= waiting.uiTicks)
+			AddSample(aaSamples[waiting.eKind][STAGE_FLIP], Profiler::ToMilliseconds(ac_uiFlipTicks - waiting.uiTicks));
+	}
+
+	// Every frame kept gets an 'EndGpu', even one with no events, so the times and frames stay in step
+	if (ac_bGpuTimed)
+		dqGpuPending.push_back(vPresented);
+	vPresented.clear();
+}
+
+void Latency::EndGpu(const Uint64 ac_uiGpuTicks)
+{
+	if (dqGpuPending.empty())
+		return;
+
+	const std::vector<Waiting>& vFrame = dqGpuPending.front();
+	for (unsigned int i = 0; i < vFrame.size(); ++i)
+	{
+		const Waiting& waiting = vFrame[i];
+		if (ac_uiGpuTicks >= waiting.uiTicks)
+			AddSample(aaSamples[waiting.eKind][STAGE_GPU], Profiler::ToMilliseconds(ac_uiGpuTicks - waiting.uiTicks));
+	}
+	dqGpuPending.pop_front();
+}
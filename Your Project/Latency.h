@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////
+// File: Latency.h
+// Author: Ben Odom
+// Brief: Times how long an input takes to reach the screen.
+//		  Every event 'GameLoop' hands to 'OnEvent' is timed
+//		  from when it was pumped, belongs to the frame whose
+//		  'Update' sees it first, and is timed again once
+//		  'Present' has swapped that frame, and optionally
+//		  once the GPU has finished it. The last few thousand
+//		  times of each kind of event are kept, so percentiles
+//		  can be taken at any point while the game runs
+//////////////////////////////////////////////////////////////
+
+#ifndef _LATENCY_H_
+#define _LATENCY_H_
+
+#include "Input.h"
+
+namespace Latency
+{
+	const unsigned int kuiSamples = 4096; // How many of the latest times are kept for each kind of event and stage
+
+	// The kinds of events timed separately. Window and quit events aren't input and aren't timed
+	enum EventKind
+	{
+		KIND_KEY,			// Key presses and releases, and text input
+		KIND_MOUSE_BUTTON,
+		KIND_MOUSE_MOTION,	// Motion merged by the event pump is timed from the latest event merged in
+		KIND_MOUSE_WHEEL,
+		KIND_JOYSTICK,		// Joysticks and game controllers
+		KIND_TOUCH,
+		KIND_COUNT
+	};
+
+	// Where a time runs up to
+	enum Stage
+	{
+		STAGE_FLIP, // Every window the frame swapped has returned from 'Window::Flip'
+		STAGE_GPU,	// The GPU has finished the frame. See 'SetGpuWait'
+		STAGE_COUNT
+	};
+
+	// The times kept for one kind of event up to one stage, as returned by 'GetStats'
+	struct Stats
+	{
+		unsigned int uiSamples;		 // How many times the percentiles are taken over, up to 'kuiSamples'
+		unsigned long long ullTotal; // Events timed since the program started or 'Reset'
+
+		// In milliseconds
+		double dP50;
+		double dP95;
+		double dP99;
+		double dMax;
+	};
+
+	// - Turns timing on or off. It is on by default, and costs a few bytes per event
+	void SetEnabled(const bool ac_bEnabled);
+	// - Whether events are being timed
+	bool IsEnabled();
+	/* - Turns timing 'STAGE_GPU' after every 'Present' on or off. It is off by default
+	   With ARB_sync 'Present' puts a fence after the swaps that a thread of its own waits on, so the game isn't held up and the
+	   times arrive a frame or so later. Without it a 'glFinish' after the swaps stalls the game until the GPU is done
+	*/
+	void SetGpuWait(const bool ac_bWait);
+	// - Whether 'Present' times 'STAGE_GPU'
+	bool IsGpuWait();
+
+	// - Returns the name a kind of event is reported under
+	const char* GetKindName(const EventKind ac_eKind);
+	// - Returns the percentiles of the times kept for one kind of event up to one stage
+	Stats GetStats(const EventKind ac_eKind, const Stage ac_eStage);
+	// - Returns the percentiles of the times kept for every kind of event up to one stage
+	Stats GetStats(const Stage ac_eStage);
+	// - Throws away every time kept and every event still waiting to be shown
+	void Reset();
+
+	// - Starts timing an event. 'GameLoop' calls it for every event it hands to 'OnEvent', except replayed ones
+	void Dispatch(const Input::Event& ac_Event);
+	// - Marks the events dispatched since the last frame as shown by the frame being presented. 'Present' calls it before swapping
+	void BeginPresent();
+	/* - Times the events of the frame 'BeginPresent' was last called for up to 'STAGE_FLIP'. 'Present' calls it once the swaps have returned,
+	   or 'WaitForPresent' once the present threads have finished them. With 'ac_bGpuTimed' the events are kept for 'EndGpu'
+	*/
+	void EndPresent(const Uint64 ac_uiFlipTicks, const bool ac_bGpuTimed);
+	// - Times the events of the oldest frame kept by 'EndPresent' up to 'STAGE_GPU', once the GPU has finished it
+	void EndGpu(const Uint64 ac_uiGpuTicks);
+}
+
+#endif // _LATENCY_H_
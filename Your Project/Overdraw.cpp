@@ -0,0 +1,304 @@
+#include "Overdraw.h"
+#include "Framebuffer.h"
+#include "GLState.h"
+#include "Present.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	const GLfloat kfCount = 1.25f / 255.0f; // What one draw adds. Between 1 and 1.5 of 255, so it lands on 1 whether the driver rounds or truncates
+	const unsigned int kuiHeatmapSteps = 8; // Counts from here up are all shown as white
+
+	// The heatmap color of each count up to 'kuiHeatmapSteps', as RGBA bytes
+	const GLubyte aaHeatmap[kuiHeatmapSteps + 1][4] =
+	{
+		{ 0, 0, 0, 255 },	// Never drawn
+		{ 0, 0, 255, 255 },	// Drawn once, which is the least a covered pixel can cost
+		{ 0, 255, 255, 255 },
+		{ 0, 255, 0, 255 },
+		{ 255, 255, 0, 255 },
+		{ 255, 128, 0, 255 },
+		{ 255, 0, 0, 255 },
+		{ 255, 0, 255, 255 },
+		{ 255, 255, 255, 255 }
+	};
+
+	bool bOverdraw = false;
+
+	GLint aViewport[4]; // The camera's view-port
+	GLint aRead[2];		// Where the camera's counts start in what is drawn into, which is the bottom left offscreen
+	int iLayer = -1;	// The layer of the run being drawn, or -1 before the first surface
+
+	std::vector<Uint8> vCounts; // What the view-port held at the last read back
+	std::vector<Uint8> vLast;	// What it held at the read back before that
+	std::vector<Uint8> avLayers[Graphics::kuiStatsLayers]; // What each layer added to each pixel of the camera being drawn
+	bool abLayers[Graphics::kuiStatsLayers];			   // Which layers the camera drew any surface of
+
+	// What counting changes and 'EndCamera' puts back
+	bool bBlend;
+	GLint iBlendSource;
+	GLint iBlendDest;
+	bool bTexture;
+	GLuint uiPrevious; // The framebuffer the camera was being drawn into
+
+	// The counts are drawn into the corner of a texture big enough for the largest camera
+	GLuint uiCounts = 0;
+	GLsizei iCountsWidth = 0;
+	GLsizei iCountsHeight = 0;
+	Graphics::Framebuffer::Target countTarget = {};
+
+	// The heatmap fills the corner of a texture big enough for the largest camera, since OpenGL 1.1 needs power of two sizes
+	GLuint uiHeatmap = 0;
+	GLsizei iHeatmapWidth = 0;
+	GLsizei iHeatmapHeight = 0;
+	std::vector<GLubyte> vHeatmap;
+
+	GLsizei PowerOfTwo(const GLsizei ac_iSize)
+	{
+		GLsizei iPower = 1;
+		while (iPower < ac_iSize)
+			iPower <<= 1;
+		return iPower;
+	}
+
+	// - Makes sure the counts texture covers the camera's view-port and points drawing at it. Returns false without framebuffer objects
+	bool BindCounts()
+	{
+		if (!Graphics::Framebuffer::IsSupported())
+			return false;
+
+		const GLsizei iWidth = aViewport[2];
+		const GLsizei iHeight = aViewport[3];
+		if (countTarget.uiFramebuffer == 0 || iWidth > iCountsWidth || iHeight > iCountsHeight)
+		{
+			iCountsWidth = std::max(PowerOfTwo(iWidth), iCountsWidth);
+			iCountsHeight = std::max(PowerOfTwo(iHeight), iCountsHeight);
+
+			if (uiCounts == 0)
+				glGenTextures(1, &uiCounts);
+			Graphics::GLState::BindTexture(uiCounts);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, iCountsWidth, iCountsHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+			if (!Graphics::Framebuffer::Create(countTarget, uiCounts, iCountsWidth, iCountsHeight))
+				return false;
+		}
+
+		Graphics::Framebuffer::Bind(countTarget.uiFramebuffer);
+		return true;
+	}
+
+	void ReadCounts()
+	{
+		vCounts.resize((size_t)aViewport[2] * aViewport[3]);
+
+		// Rows of single bytes aren't padded out to 4 the way OpenGL expects by default
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(aRead[0], aRead[1], aViewport[2], aViewport[3], GL_RED, GL_UNSIGNED_BYTE, vCounts.data());
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	}
+
+	// - Reads the view-port back and adds what changed since the last read back to the layer of the run that just ended
+	void EndRun()
+	{
+		if (iLayer < 0)
+			return;
+
+		vLast.swap(vCounts);
+		ReadCounts();
+
+		// Counts stop at 255 rather than wrapping, so no pixel ever goes down
+		std::vector<Uint8>& vLayer = avLayers[iLayer];
+		if (!abLayers[iLayer])
+		{
+			vLayer.assign(vCounts.size(), 0);
+			abLayers[iLayer] = true;
+		}
+		for (size_t i = 0; i < vCounts.size(); ++i)
+			vLayer[i] = (Uint8)(vLayer[i] + vCounts[i] - vLast[i]);
+	}
+
+	Graphics::OverdrawStats Measure(const std::vector<Uint8>& ac_vCounts)
+	{
+		Graphics::OverdrawStats overdraw = { (unsigned int)ac_vCounts.size(), 0, 0 };
+		for (size_t i = 0; i < ac_vCounts.size(); ++i)
+		{
+			overdraw.uiFragments += ac_vCounts[i];
+			overdraw.uiMax = std::max(overdraw.uiMax, (unsigned int)ac_vCounts[i]);
+		}
+		return overdraw;
+	}
+
+	// - Colors the counts of the last read back and draws them over the camera's view-port
+	void DrawHeatmap()
+	{
+		const GLsizei iWidth = aViewport[2];
+		const GLsizei iHeight = aViewport[3];
+		if (iWidth <= 0 || iHeight <= 0)
+			return;
+
+		vHeatmap.resize(vCounts.size() * 4);
+		for (size_t i = 0; i < vCounts.size(); ++i)
+			memcpy(&vHeatmap[i * 4], aaHeatmap[std::min((unsigned int)vCounts[i], kuiHeatmapSteps)], 4);
+
+		if (uiHeatmap == 0)
+			glGenTextures(1, &uiHeatmap);
+		Graphics::GLState::BindTexture(uiHeatmap);
+
+		if (iWidth > iHeatmapWidth || iHeight > iHeatmapHeight)
+		{
+			iHeatmapWidth = std::max(PowerOfTwo(iWidth), iHeatmapWidth);
+			iHeatmapHeight = std::max(PowerOfTwo(iHeight), iHeatmapHeight);
+
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, iHeatmapWidth, iHeatmapHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+		}
+
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, iWidth, iHeight, GL_RGBA, GL_UNSIGNED_BYTE, vHeatmap.data());
+		Graphics::Stats::AddTextureUpload(iWidth * iHeight * 4);
+		Graphics::GLState::TextureUploaded();
+
+		// The first row read back is the bottom one, so the quad runs bottom up to put every texel on the pixel it came from
+		glMatrixMode(GL_PROJECTION);
+		glPushMatrix();
+		glLoadIdentity();
+		glOrtho(0, 1, 0, 1, -1, 1);
+		glMatrixMode(GL_MODELVIEW);
+		glPushMatrix();
+		glLoadIdentity();
+
+		glEnable(GL_TEXTURE_2D);
+		Graphics::GLState::Blend(false);
+		Graphics::GLState::Color(255, 255, 255, 255);
+
+		const GLfloat fU = (GLfloat)iWidth / iHeatmapWidth;
+		const GLfloat fV = (GLfloat)iHeight / iHeatmapHeight;
+
+		glBegin(GL_QUADS);
+		glTexCoord2f(0.0f, 0.0f); glVertex2f(0.0f, 0.0f);
+		glTexCoord2f(fU, 0.0f);	  glVertex2f(1.0f, 0.0f);
+		glTexCoord2f(fU, fV);	  glVertex2f(1.0f, 1.0f);
+		glTexCoord2f(0.0f, fV);	  glVertex2f(0.0f, 1.0f);
+		glEnd();
+
+		glMatrixMode(GL_PROJECTION);
+		glPopMatrix();
+		glMatrixMode(GL_MODELVIEW);
+		glPopMatrix();
+	}
+}
+
+void Graphics::SetOverdrawMode(const bool ac_bEnabled)
+{
+	if (ac_bEnabled == bOverdraw)
+		return;
+
+	bOverdraw = ac_bEnabled;
+
+	// The surfaces didn't change, but what they show as did
+	for (unsigned int i = 0; i < voWindows.size(); ++i)
+		MarkWindowChanged(i);
+}
+bool Graphics::IsOverdrawMode()
+{
+	return bOverdraw;
+}
+
+void Graphics::Overdraw::BeginCamera()
+{
+	const GLState::Cache& cache = GLState::Current();
+	memcpy(aViewport, cache.aViewport, sizeof(aViewport));
+
+	vCounts.assign((size_t)aViewport[2] * aViewport[3], 0);
+	iLayer = -1;
+	for (unsigned int i = 0; i < kuiStatsLayers; ++i)
+		abLayers[i] = false;
+
+	bBlend = cache.bBlendKnown ? cache.bBlend : glIsEnabled(GL_BLEND) == GL_TRUE;
+	iBlendSource = (GLint)cache.eBlendSource;
+	iBlendDest = (GLint)cache.eBlendDest;
+	if (!cache.bBlendFuncKnown)
+	{
+		glGetIntegerv(GL_BLEND_SRC, &iBlendSource);
+		glGetIntegerv(GL_BLEND_DST, &iBlendDest);
+	}
+	bTexture = glIsEnabled(GL_TEXTURE_2D) == GL_TRUE;
+
+	// Offscreen the camera is drawn into the bottom left corner, and the projection still maps it to the whole view-port
+	uiPrevious = Framebuffer::GetBound();
+	const bool bOffscreen = BindCounts();
+	aRead[0] = bOffscreen ? 0 : aViewport[0];
+	aRead[1] = bOffscreen ? 0 : aViewport[1];
+	if (bOffscreen)
+		GLState::Viewport(0, 0, aViewport[2], aViewport[3]);
+
+	// Only the camera's part starts at 0, so cameras drawn before it into the same window keep their heatmaps
+	GLfloat afClear[4];
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, afClear);
+	GLState::ScissorBox(aRead[0], aRead[1], aViewport[2], aViewport[3]);
+	GLState::Scissor(true);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glClearColor(afClear[0], afClear[1], afClear[2], afClear[3]);
+	GLState::Scissor(false);
+
+	GLState::Blend(true);
+	GLState::BlendFunc(GL_ONE, GL_ONE);
+
+	// With texturing off and lighting on without any lights, every pixel gets the material's emission whatever color
+	// 'DrawSurface' sets. Every pixel of the quad is counted, including ones its texture would have left see-through,
+	// since blending them still costs a fill
+	const GLfloat afCount[4] = { kfCount, kfCount, kfCount, 1.0f };
+	const GLfloat afNone[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	glDisable(GL_TEXTURE_2D);
+	glEnable(GL_LIGHTING);
+	glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, afCount);
+	glLightModelfv(GL_LIGHT_MODEL_AMBIENT, afNone);
+}
+
+void Graphics::Overdraw::Count(const int ac_iLayer)
+{
+	if (ac_iLayer == iLayer)
+		return;
+
+	EndRun();
+	iLayer = ac_iLayer;
+}
+
+void Graphics::Overdraw::EndCamera(const unsigned int ac_uiCamera)
+{
+	EndRun();
+	iLayer = -1;
+
+	Stats::AddCameraOverdraw(ac_uiCamera, Measure(vCounts));
+	for (unsigned int i = 0; i < kuiStatsLayers; ++i)
+	{
+		const OverdrawStats none = { (unsigned int)vCounts.size(), 0, 0 };
+		Stats::AddLayerOverdraw(i, abLayers[i] ? Measure(avLayers[i]) : none);
+	}
+
+	// OpenGL's own defaults, which nothing else in the engine changes
+	const GLfloat afEmission[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	const GLfloat afAmbient[4] = { 0.2f, 0.2f, 0.2f, 1.0f };
+	glDisable(GL_LIGHTING);
+	glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, afEmission);
+	glLightModelfv(GL_LIGHT_MODEL_AMBIENT, afAmbient);
+
+	// The heatmap goes where the camera would have drawn
+	Framebuffer::Bind(uiPrevious);
+	GLState::Viewport(aViewport[0], aViewport[1], aViewport[2], aViewport[3]);
+
+	DrawHeatmap();
+
+	if (bTexture)
+		glEnable(GL_TEXTURE_2D);
+	else
+		glDisable(GL_TEXTURE_2D);
+	GLState::BlendFunc((GLenum)iBlendSource, (GLenum)iBlendDest);
+	GLState::Blend(bBlend);
+}
@@ -0,0 +1,47 @@
+//////////////////////////////////////////////////////////////
+// File: Overdraw.h
+// Author: Ben Odom
+// Brief: A debug mode of 'DrawCameras' that counts how many
+//		  times every pixel is drawn. Each surface is drawn
+//		  as a flat value of 1 with additive blending into an
+//		  offscreen framebuffer the size of the camera, which
+//		  ends up holding a count for each pixel. The counts
+//		  are read back after each run of one 'LayerType',
+//		  added to the frame stats, and shown over the camera
+//		  as a heatmap, so they work with the window hidden.
+//		  Without framebuffer objects the counts go into the
+//		  camera's part of the window instead, and are only
+//		  reliable while it is shown and nothing covers it
+//////////////////////////////////////////////////////////////
+
+#ifndef _OVERDRAW_H_
+#define _OVERDRAW_H_
+
+#include "Graphics.h"
+
+namespace Graphics
+{
+	/* - Turns the overdraw mode on or off. It is off by default
+	   While it is on, cameras show a heatmap instead of what they see: black for pixels nothing was drawn into, then blue, cyan,
+	   green, yellow, orange, red and magenta for 1 to 7 draws, and white for 8 or more. 'GetFrameStats' has the averages and maximums
+	   per camera in 'CameraOverdraw' and per 'LayerType' in 'LayerOverdraw'. Reading the counts back stalls the GPU, so
+	   frame times in this mode say nothing about normal frames
+	*/
+	void SetOverdrawMode(const bool ac_bEnabled);
+	// - Whether the overdraw mode is on
+	bool IsOverdrawMode();
+
+	// The steps 'DrawCameras' takes through each camera while the overdraw mode is on
+	namespace Overdraw
+	{
+		// - Points drawing at a count of 0 for every pixel of the camera's view-port and sets it up to add 1 to every pixel a surface
+		//   covers. Call once the view-port is the camera's
+		void BeginCamera();
+		// - Call before drawing each surface. Whenever the layer changes, what the last layer added is read back and kept
+		void Count(const int ac_iLayer);
+		// - Adds the camera's counts to the frame stats, puts drawing back where and how it was and draws the heatmap over the camera
+		void EndCamera(const unsigned int ac_uiCamera);
+	}
+}
+
+#endif // _OVERDRAW_H_
@@ -0,0 +1,136 @@
+#include "PackFile.h"
+#include "Profiler.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// One mapped pack and what is needed to unmap it
+	struct MappedPack
+	{
+		std::string sFilename;
+
+		const void* pData;
+		Uint64 ullSize;
+
+#ifdef _WIN32
+		HANDLE hFile;
+		HANDLE hMapping;
+#else
+		int iFile;
+#endif
+	};
+
+	std::vector<MappedPack> vPacks;
+
+	bool Map(const char* ac_szFilename, MappedPack& a_Pack)
+	{
+		a_Pack.sFilename = ac_szFilename;
+		a_Pack.pData = nullptr;
+
+#ifdef _WIN32
+		a_Pack.hFile = CreateFileA(ac_szFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+		if (a_Pack.hFile == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER iSize;
+		GetFileSizeEx(a_Pack.hFile, &iSize);
+		a_Pack.ullSize = (Uint64)iSize.QuadPart;
+
+		a_Pack.hMapping = CreateFileMappingA(a_Pack.hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (a_Pack.hMapping != NULL)
+			a_Pack.pData = MapViewOfFile(a_Pack.hMapping, FILE_MAP_READ, 0, 0, 0);
+
+		if (a_Pack.pData == nullptr)
+		{
+			if (a_Pack.hMapping != NULL)
+				CloseHandle(a_Pack.hMapping);
+			CloseHandle(a_Pack.hFile);
+			return false;
+		}
+#else
+		a_Pack.iFile = open(ac_szFilename, O_RDONLY);
+		if (a_Pack.iFile < 0)
+			return false;
+
+		struct stat fileStat;
+		fstat(a_Pack.iFile, &fileStat);
+		a_Pack.ullSize = (Uint64)fileStat.st_size;
+
+		void* pData = mmap(nullptr, (size_t)a_Pack.ullSize, PROT_READ, MAP_PRIVATE, a_Pack.iFile, 0);
+		if (pData == MAP_FAILED)
+		{
+			close(a_Pack.iFile);
+			return false;
+		}
+		a_Pack.pData = pData;
+#endif
+
+		return true;
+	}
+	void Unmap(MappedPack& a_Pack)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(a_Pack.pData);
+		CloseHandle(a_Pack.hMapping);
+		CloseHandle(a_Pack.hFile);
+#else
+		munmap((void*)a_Pack.pData, (size_t)a_Pack.ullSize);
+		close(a_Pack.iFile);
+#endif
+		a_Pack.pData = nullptr;
+	}
+}
+
+bool Graphics::OpenAssetPack(const char* ac_szFilename)
+{
+	PROFILE_ZONE("Open Asset Pack");
+
+	MappedPack pack;
+	if (!Map(ac_szFilename, pack))
+	{
+		printf("AssetPack: Could not map '%s'\n", ac_szFilename);
+		return false;
+	}
+
+	if (!AssetPack::Register(pack.pData, pack.ullSize))
+	{
+		printf("AssetPack: '%s' was not opened\n", ac_szFilename);
+		Unmap(pack);
+		return false;
+	}
+
+	vPacks.push_back(pack);
+	return true;
+}
+void Graphics::CloseAssetPack(const char* ac_szFilename)
+{
+	for (unsigned int i = 0; i < vPacks.size(); ++i)
+	{
+		if (vPacks[i].sFilename == ac_szFilename)
+		{
+			AssetPack::Unregister(vPacks[i].pData);
+			Unmap(vPacks[i]);
+			vPacks.erase(vPacks.begin() + i);
+			return;
+		}
+	}
+}
+void Graphics::CloseAssetPacks()
+{
+	for (unsigned int i = 0; i < vPacks.size(); ++i)
+	{
+		AssetPack::Unregister(vPacks[i].pData);
+		Unmap(vPacks[i]);
+	}
+	vPacks.clear();
+}
@@ -0,0 +1,27 @@
+//////////////////////////////////////////////////////////////
+// File: PackFile.h
+// Author: Ben Odom
+// Brief: Opens asset packs made by the 'AssetPacker' tool.
+//		  Each pack is mapped into memory rather than read,
+//		  so opening one costs almost nothing and only the
+//		  images that get loaded are ever paged in
+//////////////////////////////////////////////////////////////
+
+#ifndef _PACKFILE_H_
+#define _PACKFILE_H_
+
+#include "Graphics.h"
+
+namespace Graphics
+{
+	// - Maps an asset pack so 'LoadSurface' and 'LoadSurfaceAsync' find its images before looking on disk
+	//   Returns false if the file can't be opened or isn't an asset pack
+	bool OpenAssetPack(const char* ac_szFilename);
+	// - Unmaps one asset pack. Textures already loaded from it stay loaded, but nothing may still be loading from it
+	//   With a texture budget set, surfaces loaded from it read it again after eviction, so release them first
+	void CloseAssetPack(const char* ac_szFilename);
+	// - Unmaps every asset pack. Call before 'Quit'
+	void CloseAssetPacks();
+}
+
+#endif // _PACKFILE_H_
@@ -0,0 +1,331 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'snprintf' with Visual Studio's SDL checks turned on
+
+#include "PerfHud.h"
+#include "Profiler.h"
+#include "DynamicResolution.h"
+#include "Input.h"
+#include "Latency.h"
+#include "Overdraw.h"
+#include "Present.h"
+#include "Graphics.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	const unsigned int kuiHistory = 240;	// Frames shown in the graph and used for percentiles
+	const float kfPixel = 2.0f;				// Size of one font pixel
+	const float kfLineHeight = 6 * kfPixel + 4;
+	const float kfGraphHeight = 60.0f;
+	const float kfGraphMilliseconds = 33.3f; // Frame time at the top of the graph
+	const unsigned int kuiMaxPhases = 10;	// Most zones listed under the graph
+
+	// A 3x5 pixel font. Each row is 3 bits, with the left-most pixel in the highest bit
+	struct Glyph
+	{
+		char cCharacter;
+		unsigned char aRows[5];
+	};
+	const Glyph aGlyphs[] =
+	{
+		{ '0', { 7, 5, 5, 5, 7 } }, { '1', { 2, 6, 2, 2, 7 } }, { '2', { 7, 1, 7, 4, 7 } }, { '3', { 7, 1, 7, 1, 7 } },
+		{ '4', { 5, 5, 7, 1, 1 } }, { '5', { 7, 4, 7, 1, 7 } }, { '6', { 7, 4, 7, 5, 7 } }, { '7', { 7, 1, 1, 1, 1 } },
+		{ '8', { 7, 5, 7, 5, 7 } }, { '9', { 7, 5, 7, 1, 7 } },
+		{ 'A', { 2, 5, 7, 5, 5 } }, { 'B', { 6, 5, 6, 5, 6 } }, { 'C', { 3, 4, 4, 4, 3 } }, { 'D', { 6, 5, 5, 5, 6 } },
+		{ 'E', { 7, 4, 6, 4, 7 } }, { 'F', { 7, 4, 6, 4, 4 } }, { 'G', { 3, 4, 5, 5, 3 } }, { 'H', { 5, 5, 7, 5, 5 } },
+		{ 'I', { 7, 2, 2, 2, 7 } }, { 'J', { 1, 1, 1, 5, 2 } }, { 'K', { 5, 5, 6, 5, 5 } }, { 'L', { 4, 4, 4, 4, 7 } },
+		{ 'M', { 5, 7, 7, 5, 5 } }, { 'N', { 6, 5, 5, 5, 5 } }, { 'O', { 2, 5, 5, 5, 2 } }, { 'P', { 6, 5, 6, 4, 4 } },
+		{ 'Q', { 2, 5, 5, 6, 3 } }, { 'R', { 6, 5, 6, 5, 5 } }, { 'S', { 3, 4, 2, 1, 6 } }, { 'T', { 7, 2, 2, 2, 2 } },
+		{ 'U', { 5, 5, 5, 5, 7 } }, { 'V', { 5, 5, 5, 5, 2 } }, { 'W', { 5, 5, 7, 7, 5 } }, { 'X', { 5, 5, 2, 5, 5 } },
+		{ 'Y', { 5, 5, 2, 2, 2 } }, { 'Z', { 7, 1, 2, 4, 7 } },
+		{ '.', { 0, 0, 0, 0, 2 } }, { ':', { 0, 2, 0, 2, 0 } }, { '%', { 5, 1, 2, 4, 5 } }, { '/', { 1, 1, 2, 4, 4 } },
+		{ '-', { 0, 0, 7, 0, 0 } }, { '_', { 0, 0, 0, 0, 7 } }, { '(', { 1, 2, 2, 2, 1 } }, { ')', { 4, 2, 2, 2, 4 } }
+	};
+
+	struct Vertex
+	{
+		GLfloat fX, fY;
+		GLubyte aColor[4];
+	};
+
+	bool bVisible = false;
+	SDL_Window* sdlHudWindow = NULL; // The window the HUD waiting for 'DrawOverlay' goes over, or NULL if there is none
+
+	float afFrameTimes[kuiHistory] = {}; // Milliseconds, as a ring buffer
+	unsigned int uiFrames = 0;
+	Uint64 uiLastFrame = 0;
+
+	// Reused every frame so drawing the HUD doesn't allocate
+	std::vector<Vertex> vVertices;
+	std::vector<float>	vSorted;
+
+	void PushQuad(const float ac_fX, const float ac_fY, const float ac_fW, const float ac_fH, const GLubyte ac_aColor[4])
+	{
+		const Vertex aCorners[4] =
+		{
+			{ ac_fX,		ac_fY,		  { ac_aColor[0], ac_aColor[1], ac_aColor[2], ac_aColor[3] } },
+			{ ac_fX + ac_fW, ac_fY,		  { ac_aColor[0], ac_aColor[1], ac_aColor[2], ac_aColor[3] } },
+			{ ac_fX + ac_fW, ac_fY + ac_fH, { ac_aColor[0], ac_aColor[1], ac_aColor[2], ac_aColor[3] } },
+			{ ac_fX,		ac_fY + ac_fH, { ac_aColor[0], ac_aColor[1], ac_aColor[2], ac_aColor[3] } }
+		};
+		vVertices.insert(vVertices.end(), aCorners, aCorners + 4);
+	}
+
+	void PushText(const float ac_fX, const float ac_fY, const char* ac_szText, const GLubyte ac_aColor[4])
+	{
+		float fX = ac_fX;
+		for (const char* pChar = ac_szText; *pChar != '\0'; ++pChar, fX += 4 * kfPixel)
+		{
+			const char cCharacter = (char)toupper((unsigned char)*pChar);
+
+			for (unsigned int i = 0; i < sizeof(aGlyphs) / sizeof(aGlyphs[0]); ++i)
+			{
+				if (aGlyphs[i].cCharacter != cCharacter)
+					continue;
+
+				for (unsigned int uiRow = 0; uiRow < 5; ++uiRow)
+				{
+					for (unsigned int uiColumn = 0; uiColumn < 3; ++uiColumn)
+					{
+						if (aGlyphs[i].aRows[uiRow] & (4 >> uiColumn))
+							PushQuad(fX + uiColumn * kfPixel, ac_fY + uiRow * kfPixel, kfPixel, kfPixel, ac_aColor);
+					}
+				}
+				break;
+			}
+		}
+	}
+
+	// Returns the frame time that 'ac_fPercent' of recorded frames were faster than
+	float Percentile(const std::vector<float>& ac_vSorted, const float ac_fPercent)
+	{
+		if (ac_vSorted.empty())
+			return 0.0f;
+
+		return ac_vSorted[std::min((unsigned int)(ac_vSorted.size() * ac_fPercent / 100.0f), (unsigned int)ac_vSorted.size() - 1)];
+	}
+}
+
+void PerfHud::Toggle()
+{
+	SetVisible(!bVisible);
+}
+void PerfHud::SetVisible(const bool ac_bVisible)
+{
+	bVisible = ac_bVisible;
+
+	// The phase times come from the profiler, so it has to be recording while the HUD is up
+	if (bVisible)
+		Profiler::Enable(true);
+}
+bool PerfHud::IsVisible()
+{
+	return bVisible;
+}
+
+void PerfHud::Draw()
+{
+	const Uint64 uiNow = Profiler::Now();
+	if (uiLastFrame != 0)
+	{
+		afFrameTimes[uiFrames % kuiHistory] = (float)Profiler::ToMilliseconds(uiNow - uiLastFrame);
+		++uiFrames;
+	}
+	uiLastFrame = uiNow;
+
+	if (!bVisible)
+		return;
+
+	Graphics::MarkCurrentWindowChanged(); // The timings change every frame even when nothing else in the window does
+
+	// The HUD draws with plain OpenGL calls rather than through 'GLState', so it never shows up in the counters it displays
+	const Graphics::FrameStats& frameStats = Graphics::GetFrameStats();
+	const Profiler::FrameTimings& frameTimings = Profiler::GetFrameTimings();
+
+	const unsigned int uiCount = std::min(uiFrames, kuiHistory);
+	vSorted.assign(afFrameTimes, afFrameTimes + uiCount);
+	std::sort(vSorted.begin(), vSorted.end());
+
+	float fAverage = 0.0f;
+	for (unsigned int i = 0; i < uiCount; ++i)
+		fAverage += vSorted[i];
+	fAverage = uiCount > 0 ? fAverage / uiCount : 0.0f;
+
+	const GLubyte aBackground[4] = { 0, 0, 0, 180 };
+	const GLubyte aText[4] = { 255, 255, 255, 255 };
+	const GLubyte aGpuText[4] = { 255, 200, 80, 255 };
+	const GLubyte aBar[4] = { 80, 220, 80, 255 };
+	const GLubyte aSlowBar[4] = { 230, 60, 60, 255 };
+	const GLubyte aTarget[4] = { 255, 255, 255, 90 };
+
+	const float fX = 8.0f;
+	const float fWidth = 320.0f;
+	float fY = 8.0f;
+
+	unsigned int uiLines = 7 + std::min((unsigned int)frameTimings.vCpu.size(), kuiMaxPhases) + std::min((unsigned int)frameTimings.vGpu.size(), kuiMaxPhases);
+#ifdef _DEBUG
+	++uiLines; // The redundant OpenGL call count
+#endif
+	if (Latency::IsEnabled())
+		++uiLines;
+	if (Graphics::IsOverdrawMode())
+		++uiLines;
+
+	vVertices.clear();
+	PushQuad(fX, fY, fWidth, kfGraphHeight + 16 + uiLines * kfLineHeight, aBackground);
+
+	// The frame time graph, newest frame on the right. Bars slower than 60 Hz are drawn red
+	const float fGraphBottom = fY + 8 + kfGraphHeight;
+	for (unsigned int i = 0; i < uiCount; ++i)
+	{
+		const float fMilliseconds = afFrameTimes[(uiFrames - uiCount + i) % kuiHistory];
+		const float fHeight = std::min(fMilliseconds / kfGraphMilliseconds, 1.0f) * kfGraphHeight;
+
+		PushQuad(fX + 8 + (kuiHistory - uiCount) + i, fGraphBottom - fHeight, 1.0f, fHeight, fMilliseconds > 1000.0f / 60.0f ? aSlowBar : aBar);
+	}
+	PushQuad(fX + 8, fGraphBottom - (1000.0f / 60.0f) / kfGraphMilliseconds * kfGraphHeight, kuiHistory, 1.0f, aTarget);
+
+	fY = fGraphBottom + 8;
+
+	char szLine[128];
+	snprintf(szLine, sizeof(szLine), "FPS %.1f  MS %.2f", fAverage > 0.0f ? 1000.0f / fAverage : 0.0f, fAverage);
+	PushText(fX + 8, fY, szLine, aText);
+	fY += kfLineHeight;
+
+	// Percentiles of frame time turned into frame rates, so 'P99' is the rate of the slowest 1% of frames
+	const float fP50 = Percentile(vSorted, 50.0f);
+	const float fP95 = Percentile(vSorted, 95.0f);
+	const float fP99 = Percentile(vSorted, 99.0f);
+	snprintf(szLine, sizeof(szLine), "P50 %.0f  P95 %.0f  P99 %.0f",
+		fP50 > 0.0f ? 1000.0f / fP50 : 0.0f, fP95 > 0.0f ? 1000.0f / fP95 : 0.0f, fP99 > 0.0f ? 1000.0f / fP99 : 0.0f);
+	PushText(fX + 8, fY, szLine, aText);
+	fY += kfLineHeight;
+
+	unsigned int uiVertices = 0;
+	for (unsigned int i = 0; i < Graphics::PRIMITIVE_COUNT; ++i)
+		uiVertices += frameStats.uiVertices[i];
+
+	snprintf(szLine, sizeof(szLine), "DRAWS %u  VERTS %u  BINDS %u", frameStats.uiDrawCalls, uiVertices, frameStats.uiTextureBinds);
+	PushText(fX + 8, fY, szLine, aText);
+	fY += kfLineHeight;
+
+	unsigned int uiSubmitted = 0;
+	for (unsigned int i = 0; i < Graphics::kuiStatsCameras; ++i)
+		uiSubmitted += frameStats.uiSurfacesSubmitted[i];
+
+#ifdef _DEBUG
+	snprintf(szLine, sizeof(szLine), "REDUNDANT GL CALLS SKIPPED %u", frameStats.uiRedundantStateCalls);
+	PushText(fX + 8, fY, szLine, aText);
+	fY += kfLineHeight;
+#endif
+
+	snprintf(szLine, sizeof(szLine), "SURFACES %u / %u", uiSubmitted, (unsigned int)Graphics::vglSurfaces.size());
+	PushText(fX + 8, fY, szLine, aText);
+	fY += kfLineHeight;
+
+	const Input::PumpStats& pumpStats = Input::GetPumpStats();
+	snprintf(szLine, sizeof(szLine), "EVENTS %u  DISPATCHED %u  COALESCED %u", pumpStats.uiFrameEvents, pumpStats.uiFrameDispatched, pumpStats.uiFrameCoalesced);
+	PushText(fX + 8, fY, szLine, aText);
+	fY += kfLineHeight;
+
+	// Input to swap over every kind of event, in milliseconds
+	if (Latency::IsEnabled())
+	{
+		const Latency::Stats latency = Latency::GetStats(Latency::STAGE_FLIP);
+		snprintf(szLine, sizeof(szLine), "LATENCY P50 %.1f  P95 %.1f  P99 %.1f", latency.dP50, latency.dP95, latency.dP99);
+		PushText(fX + 8, fY, szLine, aText);
+		fY += kfLineHeight;
+	}
+
+	const System::Size2D<unsigned int> Internal = Graphics::GetInternalSize(0);
+	snprintf(szLine, sizeof(szLine), "RES %ux%u  %.0f%%%s", Internal.W, Internal.H, Graphics::GetResolutionScale() * 100.0f, Graphics::IsDynamicResolution() ? "  DYNAMIC" : "");
+	PushText(fX + 8, fY, szLine, aText);
+	fY += kfLineHeight;
+
+	if (Graphics::IsOverdrawMode())
+	{
+		Graphics::OverdrawStats overdraw = { 0, 0, 0 };
+		for (unsigned int i = 0; i < Graphics::kuiStatsCameras; ++i)
+			overdraw.Add(frameStats.CameraOverdraw[i]);
+
+		snprintf(szLine, sizeof(szLine), "OVERDRAW AVG %.2f  MAX %u", overdraw.Average(), overdraw.uiMax);
+		PushText(fX + 8, fY, szLine, aText);
+		fY += kfLineHeight;
+	}
+
+	const Graphics::TextureCacheStats& textureStats = Graphics::GetTextureCacheStats();
+	const Graphics::ResidencyStats& residencyStats = Graphics::GetResidencyStats();
+	if (residencyStats.uiBudgetBytes != 0)
+	{
+		snprintf(szLine, sizeof(szLine), "TEXTURES %u  %.1fMB  HITS %.0f%%  RESIDENT %u/%u  EVICT %u%s", textureStats.uiTextures, textureStats.uiResidentBytes / (1024.0f * 1024.0f),
+			textureStats.HitRate() * 100.0f, residencyStats.uiResident, residencyStats.uiManaged, residencyStats.uiFrameEvictions, residencyStats.bOverBudget ? "  OVER" : "");
+	}
+	else
+	{
+		snprintf(szLine, sizeof(szLine), "TEXTURES %u  %.1fMB  HITS %.0f%%", textureStats.uiTextures, textureStats.uiResidentBytes / (1024.0f * 1024.0f), textureStats.HitRate() * 100.0f);
+	}
+	PushText(fX + 8, fY, szLine, aText);
+	fY += kfLineHeight;
+
+	for (unsigned int i = 0; i < frameTimings.vCpu.size() && i < kuiMaxPhases; ++i, fY += kfLineHeight)
+	{
+		const Profiler::ZoneTime& zone = frameTimings.vCpu[i];
+		if (zone.iArg >= 0)
+			snprintf(szLine, sizeof(szLine), "%s %d  %.2f", zone.szName, zone.iArg, zone.dMilliseconds);
+		else
+			snprintf(szLine, sizeof(szLine), "%s  %.2f", zone.szName, zone.dMilliseconds);
+		PushText(fX + 8, fY, szLine, aText);
+	}
+	for (unsigned int i = 0; i < frameTimings.vGpu.size() && i < kuiMaxPhases; ++i, fY += kfLineHeight)
+	{
+		const Profiler::ZoneTime& zone = frameTimings.vGpu[i];
+		if (zone.iArg >= 0)
+			snprintf(szLine, sizeof(szLine), "GPU %s %d  %.2f", zone.szName, zone.iArg, zone.dMilliseconds);
+		else
+			snprintf(szLine, sizeof(szLine), "GPU %s  %.2f", zone.szName, zone.dMilliseconds);
+		PushText(fX + 8, fY, szLine, aGpuText);
+	}
+
+	sdlHudWindow = SDL_GL_GetCurrentWindow();
+}
+
+void PerfHud::DrawOverlay()
+{
+	if (sdlHudWindow == NULL)
+		return;
+
+	// The game may have left another window current since 'Draw'
+	SDL_Window* sdlWindow = SDL_GL_GetCurrentWindow();
+	SDL_GLContext sdlContext = SDL_GL_GetCurrentContext();
+	if (sdlWindow != sdlHudWindow)
+	{
+		SDL_GL_MakeCurrent(sdlHudWindow, sdlContext);
+		Graphics::BindCurrentWindowTarget();
+	}
+
+	// Everything 'Draw' pushed goes out in one draw call
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vVertices[0].fX);
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &vVertices[0].aColor);
+
+	glDrawArrays(GL_QUADS, 0, (GLsizei)vVertices.size());
+
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	// The texture was bound behind the cache's back, and the current color is undefined after drawing with a color array
+	Graphics::GLState::InvalidateDraw();
+
+	if (sdlWindow != sdlHudWindow)
+	{
+		SDL_GL_MakeCurrent(sdlWindow, sdlContext);
+		Graphics::BindCurrentWindowTarget();
+	}
+	sdlHudWindow = NULL;
+}
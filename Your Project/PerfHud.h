@@ -0,0 +1,32 @@
+//////////////////////////////////////////////////////////////
+// File: PerfHud.h
+// Author: Ben Odom
+// Brief: An on-screen overlay showing how long frames take
+//		  and how much the renderer drew. Everything in it is
+//		  put into one vertex array and drawn with a single
+//		  call once 'GameLoop::Draw()' returns, so it always
+//		  sits above the 'ALWAYS_TOP' layer and everything
+//		  else, and barely changes what it measures
+//////////////////////////////////////////////////////////////
+
+#ifndef _PERFHUD_H_
+#define _PERFHUD_H_
+
+namespace PerfHud
+{
+	// - Shows the HUD if it is hidden, or hides it if it is showing
+	void Toggle();
+	// - Shows or hides the HUD
+	void SetVisible(const bool ac_bVisible);
+	// - Whether or not the HUD is currently showing
+	bool IsVisible();
+
+	/* - Records the frame and gets the HUD ready to go over the current window. Call it anywhere in 'GameLoop::Draw()'
+	   The HUD is drawn once 'Draw' returns, so nothing drawn after the call covers it. Frames are still recorded while it is hidden
+	*/
+	void Draw();
+	// - Draws what the last 'Draw' got ready into its window, then forgets it. 'GameLoop' calls it right after 'Draw'
+	void DrawOverlay();
+}
+
+#endif // _PERFHUD_H_
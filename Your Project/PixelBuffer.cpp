@@ -0,0 +1,125 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'snprintf' with Visual Studio's SDL checks turned on
+
+#include "PixelBuffer.h"
+
+#include <cstdio>
+#include <cstring>
+
+// OpenGL 1.1 headers don't know about buffer objects. OpenGL 1.5 and the ARB extensions use the same values
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_WRITE_ONLY
+#define GL_WRITE_ONLY 0x88B9
+#endif
+
+namespace
+{
+	typedef void (APIENTRY *GenBuffersFunc)(GLsizei, GLuint*);
+	typedef void (APIENTRY *DeleteBuffersFunc)(GLsizei, const GLuint*);
+	typedef void (APIENTRY *BindBufferFunc)(GLenum, GLuint);
+	typedef void (APIENTRY *BufferDataFunc)(GLenum, ptrdiff_t, const void*, GLenum);
+	typedef void* (APIENTRY *MapBufferFunc)(GLenum, GLenum);
+	typedef GLboolean (APIENTRY *UnmapBufferFunc)(GLenum);
+
+	int iSupported = -1; // -1 until the entry points have been loaded
+	GLuint uiBuffer = 0;
+
+	struct BufferFuncs
+	{
+		GenBuffersFunc		GenBuffers;
+		DeleteBuffersFunc	DeleteBuffers;
+		BindBufferFunc		BindBuffer;
+		BufferDataFunc		BufferData;
+		MapBufferFunc		MapBuffer;
+		UnmapBufferFunc		UnmapBuffer;
+	};
+	BufferFuncs gl;
+
+	// - Loads every entry point with 'ac_szSuffix' on the end of its name, returning whether they were all there
+	bool Load(const char* const ac_szSuffix)
+	{
+		char szName[64];
+#define LOAD_BUFFER_FUNC(Name, Type) \
+		snprintf(szName, sizeof(szName), "gl%s%s", #Name, ac_szSuffix); \
+		gl.Name = (Type)SDL_GL_GetProcAddress(szName); \
+		if (gl.Name == NULL) \
+			return false;
+
+		LOAD_BUFFER_FUNC(GenBuffers, GenBuffersFunc)
+		LOAD_BUFFER_FUNC(DeleteBuffers, DeleteBuffersFunc)
+		LOAD_BUFFER_FUNC(BindBuffer, BindBufferFunc)
+		LOAD_BUFFER_FUNC(BufferData, BufferDataFunc)
+		LOAD_BUFFER_FUNC(MapBuffer, MapBufferFunc)
+		LOAD_BUFFER_FUNC(UnmapBuffer, UnmapBufferFunc)
+#undef LOAD_BUFFER_FUNC
+
+		return true;
+	}
+}
+
+bool Graphics::PixelBuffer::IsSupported()
+{
+	if (iSupported < 0)
+	{
+		if (SDL_GL_GetCurrentContext() == NULL)
+			return false;
+
+		// Buffer objects are core in OpenGL 1.5, and otherwise come from ARB_vertex_buffer_object with an 'ARB' suffix
+		iSupported =
+			SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object") &&
+			(Load("") || Load("ARB"));
+
+		if (!iSupported)
+			printf("PixelBuffer: GL_ARB_pixel_buffer_object is not supported, textures are uploaded from client memory\n");
+	}
+
+	return iSupported > 0;
+}
+
+bool Graphics::PixelBuffer::TexSubImage(const GLint ac_iY, const GLsizei ac_iWidth, const GLsizei ac_iRows, const void* ac_pPixels, const int ac_iPitch)
+{
+	if (!IsSupported())
+		return false;
+
+	if (uiBuffer == 0)
+		gl.GenBuffers(1, &uiBuffer);
+
+	const size_t uiRowBytes = (size_t)ac_iWidth * 4;
+	gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, uiBuffer);
+
+	// Giving the buffer new storage every time lets the driver keep the last strip's until the GPU is done with it, rather than waiting
+	gl.BufferData(GL_PIXEL_UNPACK_BUFFER, (ptrdiff_t)(uiRowBytes * ac_iRows), NULL, GL_STREAM_DRAW);
+	Uint8* pMapped = (Uint8*)gl.MapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+
+	bool bUploaded = false;
+	if (pMapped != NULL)
+	{
+		for (GLsizei i = 0; i < ac_iRows; ++i)
+			memcpy(pMapped + i * uiRowBytes, (const Uint8*)ac_pPixels + i * ac_iPitch, uiRowBytes);
+
+		// The contents are lost if the driver had to give the memory up while it was mapped, such as on a mode change
+		if (gl.UnmapBuffer(GL_PIXEL_UNPACK_BUFFER))
+		{
+			// With a buffer bound the pointer is an offset into it
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, ac_iY, ac_iWidth, ac_iRows, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+			bUploaded = true;
+		}
+	}
+
+	// Nothing else expects a buffer to be bound, since every other upload reads from client memory
+	gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	return bUploaded;
+}
+
+void Graphics::PixelBuffer::Destroy()
+{
+	if (uiBuffer == 0)
+		return;
+
+	gl.DeleteBuffers(1, &uiBuffer);
+	uiBuffer = 0;
+}
@@ -0,0 +1,37 @@
+//////////////////////////////////////////////////////////////
+// File: PixelBuffer.h
+// Author: Ben Odom
+// Brief: Streams pixels into textures through a pixel buffer
+//		  object from the ARB_pixel_buffer_object extension.
+//		  The pixels are copied into memory the driver owns,
+//		  so 'glTexSubImage2D' returns without copying them
+//		  itself and the transfer happens while the GPU gets
+//		  on with other work. OpenGL 1.1 headers don't declare
+//		  buffer objects, so the entry points are loaded
+//		  through SDL the same way the profiler loads its
+//		  timer queries
+//////////////////////////////////////////////////////////////
+
+#ifndef _PIXELBUFFER_H_
+#define _PIXELBUFFER_H_
+
+#include <SDL.h>
+#include <glut.h>
+
+namespace Graphics
+{
+	namespace PixelBuffer
+	{
+		// - Whether pixel buffer objects can be used. The entry points are loaded the first time, from whichever context is current
+		bool IsSupported();
+
+		/* - Uploads 'ac_iRows' rows of RGBA pixels 'ac_iPitch' bytes apart into the bound texture's level 0, starting at row 'ac_iY'
+		   Returns false without uploading anything if there is no pixel buffer object to go through, leaving the upload to the caller
+		*/
+		bool TexSubImage(const GLint ac_iY, const GLsizei ac_iWidth, const GLsizei ac_iRows, const void* ac_pPixels, const int ac_iPitch);
+		// - Deletes the buffer 'TexSubImage' streams through. The next upload makes a new one
+		void Destroy();
+	}
+}
+
+#endif // _PIXELBUFFER_H_
@@ -0,0 +1,523 @@
+#include "Present.h"
+#include "DynamicResolution.h"
+#include "Fence.h"
+#include "Latency.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+	const Uint64 kuiHashBasis = 14695981039346656037ull; // FNV-1a, which the content of each window is mixed with
+	const Uint64 kuiHashPrime = 1099511628211ull;
+	const int kiUnknownInterval = -2;					 // 'SDL_GL_GetSwapInterval' hasn't been asked yet
+
+	// What 'Present' knows about one window
+	struct WindowState
+	{
+		Uint64 uiContent;	  // What was drawn into it this frame
+		Uint64 uiLastContent; // 'Signature' the last time it was swapped
+		bool bMarked;
+	};
+
+	// A thread that swaps one window in 'PRESENT_THREADED' with a context of its own
+	struct PresentThread
+	{
+		std::thread Thread;
+		std::mutex Mutex;
+		std::condition_variable Signal; // Signalled when there is a swap to do or the thread should stop
+		std::condition_variable Done;	// Signalled when the swap is done
+
+		Graphics::Window* pWindow;
+		SDL_GLContext sdlContext;
+
+		int iInterval;	 // The swap interval to use
+		bool bPending;	 // A swap has been handed over and hasn't finished
+		bool bStop;
+
+		Graphics::Fence::Handle fenceDrawn;	  // What the GPU waits on before the swap, so it shows everything drawn
+		Graphics::Fence::Handle fenceSwapped; // Passed once the last swap and its clear are done, until 'WaitForPresent' takes it
+
+		Uint64 uiFlipTicks;	  // When the last swap returned
+		Uint64 uiFinishTicks; // When the GPU finished the last swap, without ARB_sync
+	};
+
+	// A thread that waits on the fences of frames whose 'STAGE_GPU' is timed, so the game thread doesn't have to
+	struct GpuWaitThread
+	{
+		std::thread Thread;
+		std::mutex Mutex;
+		std::condition_variable Signal; // Signalled when there is a frame to wait on or the thread should stop
+
+		SDL_Window* sdlWindow;
+		SDL_GLContext sdlContext;
+
+		std::vector<std::vector<Graphics::Fence::Handle> > vFrames; // The fences of every frame handed over, oldest first
+		std::vector<Uint64> vFinished;								 // When the GPU finished each frame waited on, until 'WaitForPresent' takes them
+		bool bStop;
+	};
+
+	Graphics::PresentMode ePresentMode = Graphics::PRESENT_SEQUENTIAL;
+	unsigned int uiVsyncWindow = 0;
+	bool bSkipUnchanged = false;
+	int iVsyncInterval = kiUnknownInterval; // The interval windows had before 'Present' started changing it
+	bool bLatencyPending = false;			// The present threads have swaps whose input latency hasn't been timed
+
+	std::vector<WindowState> vWindowStates;
+	std::vector<PresentThread*> vThreads;
+	GpuWaitThread* pGpuWait = NULL;
+	Graphics::Fence::Handle fenceDrawn = NULL; // Handed to the present threads with their swaps
+
+	WindowState& GetWindowState(const unsigned int ac_uiWindow)
+	{
+		while (vWindowStates.size() <= ac_uiWindow)
+		{
+			// The last content starts out as something no frame hashes to, so every window is swapped the first time
+			const WindowState state = { kuiHashBasis, 0, false };
+			vWindowStates.push_back(state);
+		}
+		return vWindowStates[ac_uiWindow];
+	}
+
+	// - What a window shows once its content this frame is swapped. The size goes in too, so a resized window is always swapped
+	Uint64 Signature(const unsigned int ac_uiWindow)
+	{
+		const System::Size2D<unsigned int>& Dimensions = Graphics::voWindows[ac_uiWindow]->GetDimensions();
+		return (GetWindowState(ac_uiWindow).uiContent ^ Dimensions.W ^ ((Uint64)Dimensions.H << 32)) * kuiHashPrime;
+	}
+
+	// - Whether a window has to be swapped this frame
+	bool HasChanged(const unsigned int ac_uiWindow)
+	{
+		if (!bSkipUnchanged)
+			return true;
+
+		const WindowState& state = GetWindowState(ac_uiWindow);
+		return state.bMarked || Signature(ac_uiWindow) != state.uiLastContent;
+	}
+
+	// - Starts the next frame's content of a window, once it has been swapped or skipped
+	void EndWindow(const unsigned int ac_uiWindow, const bool ac_bSwapped)
+	{
+		if (ac_bSwapped)
+			GetWindowState(ac_uiWindow).uiLastContent = Signature(ac_uiWindow);
+
+		WindowState& state = GetWindowState(ac_uiWindow);
+		state.uiContent = kuiHashBasis;
+		state.bMarked = false;
+	}
+
+	void SetInterval(const int ac_iInterval)
+	{
+		// Swap intervals belong to the context or the window depending on the driver, so it is set before every swap rather than tracked
+		SDL_GL_SetSwapInterval(ac_iInterval);
+	}
+
+	void RunPresentThread(PresentThread* a_pThread)
+	{
+		Profiler::NameThread("Present");
+
+		SDL_GL_MakeCurrent(a_pThread->pWindow->GetWindow(), a_pThread->sdlContext);
+
+		std::unique_lock<std::mutex> Lock(a_pThread->Mutex);
+		for (;;)
+		{
+			a_pThread->Signal.wait(Lock, [a_pThread]() { return a_pThread->bPending || a_pThread->bStop; });
+			if (a_pThread->bStop)
+				break;
+
+			Lock.unlock();
+			{
+				PROFILE_ZONE("Present Window");
+
+				SetInterval(a_pThread->iInterval);
+				Graphics::Fence::GpuWait(a_pThread->fenceDrawn);
+				{
+					Graphics::GLState::Untracked untracked;
+					a_pThread->pWindow->Flip(); // Swaps and then clears the back buffer for the next frame
+				}
+				a_pThread->uiFlipTicks = SDL_GetPerformanceCounter();
+
+				// The clear has to be done before the game thread draws the next frame into the same buffer from its own context.
+				// With a fence only the game thread's GPU commands wait for it, otherwise this thread finishes it first
+				a_pThread->fenceSwapped = Graphics::Fence::Insert();
+				if (a_pThread->fenceSwapped == NULL)
+				{
+					glFinish();
+					a_pThread->uiFinishTicks = SDL_GetPerformanceCounter();
+				}
+				Graphics::Stats::AddWindowFlip();
+			}
+			Lock.lock();
+
+			a_pThread->bPending = false;
+			a_pThread->Done.notify_all();
+		}
+
+		SDL_GL_MakeCurrent(a_pThread->pWindow->GetWindow(), NULL);
+	}
+
+	// - Starts a present thread for every window that doesn't have one yet
+	void StartPresentThreads()
+	{
+		for (unsigned int i = (unsigned int)vThreads.size(); i < Graphics::voWindows.size(); ++i)
+		{
+			PresentThread* pThread = new PresentThread;
+			pThread->pWindow = Graphics::voWindows[i];
+			pThread->iInterval = 0;
+			pThread->bPending = false;
+			pThread->bStop = false;
+			pThread->fenceDrawn = NULL;
+			pThread->fenceSwapped = NULL;
+			pThread->uiFlipTicks = 0;
+			pThread->uiFinishTicks = 0;
+
+			pThread->sdlContext = Graphics::CreateSharedContext(pThread->pWindow->GetWindow());
+
+			pThread->Thread = std::thread(RunPresentThread, pThread);
+			vThreads.push_back(pThread);
+		}
+	}
+
+	void RunGpuWaitThread(GpuWaitThread* a_pThread)
+	{
+		Profiler::NameThread("GPU Wait");
+
+		SDL_GL_MakeCurrent(a_pThread->sdlWindow, a_pThread->sdlContext);
+
+		std::unique_lock<std::mutex> Lock(a_pThread->Mutex);
+		for (;;)
+		{
+			// Frames handed over before the thread is stopped are still waited on, so none of their fences are left behind
+			a_pThread->Signal.wait(Lock, [a_pThread]() { return !a_pThread->vFrames.empty() || a_pThread->bStop; });
+			if (a_pThread->vFrames.empty())
+				break;
+
+			const std::vector<Graphics::Fence::Handle> vFences = a_pThread->vFrames.front();
+			a_pThread->vFrames.erase(a_pThread->vFrames.begin());
+
+			Lock.unlock();
+			{
+				PROFILE_ZONE("Latency GPU Wait");
+
+				for (unsigned int i = 0; i < vFences.size(); ++i)
+					Graphics::Fence::Wait(vFences[i]);
+				const Uint64 uiGpuTicks = SDL_GetPerformanceCounter();
+
+				for (unsigned int i = 0; i < vFences.size(); ++i)
+					Graphics::Fence::Delete(vFences[i]);
+
+				Lock.lock();
+				a_pThread->vFinished.push_back(uiGpuTicks);
+			}
+		}
+
+		SDL_GL_MakeCurrent(a_pThread->sdlWindow, NULL);
+	}
+
+	// - Hands the fences put after a frame's swaps to the GPU wait thread, which deletes them. It is started the first time
+	void WaitForGpu(const std::vector<Graphics::Fence::Handle>& ac_vFences)
+	{
+		if (pGpuWait == NULL)
+		{
+			pGpuWait = new GpuWaitThread;
+			pGpuWait->sdlWindow = Graphics::voWindows[0]->GetWindow();
+			pGpuWait->sdlContext = Graphics::CreateSharedContext(pGpuWait->sdlWindow);
+			pGpuWait->bStop = false;
+
+			pGpuWait->Thread = std::thread(RunGpuWaitThread, pGpuWait);
+		}
+
+		std::lock_guard<std::mutex> Lock(pGpuWait->Mutex);
+		pGpuWait->vFrames.push_back(ac_vFences);
+		pGpuWait->Signal.notify_one();
+	}
+
+	// - Hands the times the GPU wait thread has found so far to 'Latency'
+	void TakeGpuTimes()
+	{
+		if (pGpuWait == NULL)
+			return;
+
+		std::lock_guard<std::mutex> Lock(pGpuWait->Mutex);
+		for (unsigned int i = 0; i < pGpuWait->vFinished.size(); ++i)
+			Latency::EndGpu(pGpuWait->vFinished[i]);
+		pGpuWait->vFinished.clear();
+	}
+
+	void StopGpuWaitThread()
+	{
+		if (pGpuWait == NULL)
+			return;
+
+		{
+			std::lock_guard<std::mutex> Lock(pGpuWait->Mutex);
+			pGpuWait->bStop = true;
+			pGpuWait->Signal.notify_one();
+		}
+		pGpuWait->Thread.join();
+		TakeGpuTimes();
+
+		SDL_GL_DeleteContext(pGpuWait->sdlContext);
+		delete pGpuWait;
+		pGpuWait = NULL;
+	}
+}
+
+void Graphics::SetPresentMode(const PresentMode ac_eMode)
+{
+	if (ac_eMode == ePresentMode)
+		return;
+
+	WaitForPresent();
+	if (ePresentMode == PRESENT_THREADED)
+		StopPresentThreads();
+
+	// Every window waits for vsync again, the way it did before 'Present' changed any of them
+	if (ac_eMode == PRESENT_SEQUENTIAL && iVsyncInterval != kiUnknownInterval)
+	{
+		SDL_Window* sdlWindow = SDL_GL_GetCurrentWindow();
+		SDL_GLContext sdlContext = SDL_GL_GetCurrentContext();
+
+		for (unsigned int i = 0; i < voWindows.size(); ++i)
+		{
+			SDL_GL_MakeCurrent(voWindows[i]->GetWindow(), sdlContext);
+			SetInterval(iVsyncInterval);
+		}
+		SDL_GL_MakeCurrent(sdlWindow, sdlContext);
+	}
+
+	ePresentMode = ac_eMode;
+}
+Graphics::PresentMode Graphics::GetPresentMode()
+{
+	return ePresentMode;
+}
+void Graphics::SetVsyncWindow(const unsigned int ac_uiWindow)
+{
+	uiVsyncWindow = ac_uiWindow;
+}
+unsigned int Graphics::GetVsyncWindow()
+{
+	return uiVsyncWindow;
+}
+
+void Graphics::SetSkipUnchangedWindows(const bool ac_bSkip)
+{
+	bSkipUnchanged = ac_bSkip;
+}
+bool Graphics::IsSkippingUnchangedWindows()
+{
+	return bSkipUnchanged;
+}
+void Graphics::MarkWindowChanged(const unsigned int ac_uiWindow)
+{
+	GetWindowState(ac_uiWindow).bMarked = true;
+}
+void Graphics::MarkCurrentWindowChanged()
+{
+	SDL_Window* sdlWindow = SDL_GL_GetCurrentWindow();
+	for (unsigned int i = 0; i < voWindows.size(); ++i)
+	{
+		if (voWindows[i]->GetWindow() == sdlWindow)
+			MarkWindowChanged(i);
+	}
+}
+void Graphics::AddWindowContent(const unsigned int ac_uiWindow, const Uint64 ac_uiHash)
+{
+	WindowState& state = GetWindowState(ac_uiWindow);
+	state.uiContent = (state.uiContent ^ ac_uiHash) * kuiHashPrime;
+}
+
+void Graphics::Present()
+{
+	PROFILE_ZONE("Graphics::Present");
+
+	WaitForPresent();
+
+	// A texture uploaded this frame may be one a window draws, since a texture can change without any surface changing
+	if (GLState::TakeTextureUploads())
+	{
+		for (unsigned int i = 0; i < voWindows.size(); ++i)
+			MarkWindowChanged(i);
+	}
+
+	SDL_Window* sdlWindow = SDL_GL_GetCurrentWindow();
+	SDL_GLContext sdlContext = SDL_GL_GetCurrentContext();
+
+	if (iVsyncInterval == kiUnknownInterval)
+		iVsyncInterval = SDL_GL_GetSwapInterval();
+
+	// Windows drawn at a lower resolution are stretched over the whole window before they can be swapped
+	for (unsigned int i = 0; i < voWindows.size(); ++i)
+	{
+		if (HasChanged(i))
+		{
+			SDL_GL_MakeCurrent(voWindows[i]->GetWindow(), sdlContext);
+			Upscale(i);
+		}
+	}
+	EndUpscale();
+
+	if (ePresentMode == PRESENT_THREADED)
+	{
+		StartPresentThreads();
+
+		// Drawing has to be done before another thread swaps it. With a fence only the present threads' GPU commands wait for it
+		fenceDrawn = Fence::Insert();
+		if (fenceDrawn == NULL)
+			glFinish();
+	}
+
+	Latency::BeginPresent();
+	bool bHandedOver = false;
+
+	// The vsync window goes last, so the others aren't held up behind its wait
+	const unsigned int uiLast = uiVsyncWindow < voWindows.size() ? uiVsyncWindow : 0;
+	for (unsigned int n = 0; n < voWindows.size(); ++n)
+	{
+		const unsigned int i = ePresentMode == PRESENT_SEQUENTIAL ? n : (n + uiLast + 1) % voWindows.size();
+		Window* pWindow = voWindows[i];
+
+		const bool bChanged = HasChanged(i);
+		const int iInterval = i == uiLast ? iVsyncInterval : 0;
+
+		if (bChanged && ePresentMode == PRESENT_THREADED)
+		{
+			PresentThread* pThread = vThreads[i];
+
+			std::lock_guard<std::mutex> Lock(pThread->Mutex);
+			pThread->iInterval = iInterval;
+			pThread->fenceDrawn = fenceDrawn;
+			pThread->bPending = true;
+			pThread->Signal.notify_one();
+
+			bHandedOver = true;
+		}
+		else
+		{
+			SDL_GL_MakeCurrent(pWindow->GetWindow(), sdlContext);
+
+			if (bChanged)
+			{
+				if (ePresentMode == PRESENT_ONE_VSYNC)
+					SetInterval(iInterval);
+
+				{
+					GLState::Untracked untracked;
+					pWindow->Flip();
+				}
+				Stats::AddWindowFlip();
+			}
+			else
+			{
+				// What is showing is already what was drawn, so the new frame is thrown away instead of swapped
+				glClear(GL_COLOR_BUFFER_BIT);
+			}
+		}
+
+		EndWindow(i, bChanged);
+	}
+
+	SDL_GL_MakeCurrent(sdlWindow, sdlContext);
+	BindCurrentWindowTarget(); // So the next frame is drawn at the internal size from its start
+
+	// The input this frame showed reached the screen when the last swap returned, which for the present threads is up to 'WaitForPresent'
+	if (bHandedOver)
+		bLatencyPending = true;
+	else
+	{
+		const bool bGpuTimed = Latency::IsGpuWait();
+		Latency::EndPresent(SDL_GetPerformanceCounter(), bGpuTimed);
+
+		if (bGpuTimed)
+		{
+			// With a fence the GPU is waited for on a thread of its own, otherwise the game stalls until it is done
+			const Fence::Handle fence = Fence::Insert();
+			if (fence != NULL)
+				WaitForGpu(std::vector<Fence::Handle>(1, fence));
+			else
+			{
+				PROFILE_ZONE("Latency GPU Wait");
+				glFinish();
+				Latency::EndGpu(SDL_GetPerformanceCounter());
+			}
+		}
+	}
+}
+
+void Graphics::WaitForPresent()
+{
+	std::vector<Fence::Handle> vSwapped;
+	for (unsigned int i = 0; i < vThreads.size(); ++i)
+	{
+		PresentThread* pThread = vThreads[i];
+
+		std::unique_lock<std::mutex> Lock(pThread->Mutex);
+		pThread->Done.wait(Lock, [pThread]() { return !pThread->bPending; });
+
+		// Whatever is drawn next into the window is drawn after its clear
+		if (pThread->fenceSwapped != NULL)
+		{
+			Fence::GpuWait(pThread->fenceSwapped);
+			vSwapped.push_back(pThread->fenceSwapped);
+			pThread->fenceSwapped = NULL;
+		}
+	}
+
+	// Every present thread has made its GPU wait on the drawing by now
+	Fence::Delete(fenceDrawn);
+	fenceDrawn = NULL;
+
+	if (bLatencyPending)
+	{
+		// Windows that weren't handed over keep the times of the swaps before, which are never the latest
+		Uint64 uiFlipTicks = 0;
+		Uint64 uiFinishTicks = 0;
+		for (unsigned int i = 0; i < vThreads.size(); ++i)
+		{
+			uiFlipTicks = std::max(uiFlipTicks, vThreads[i]->uiFlipTicks);
+			uiFinishTicks = std::max(uiFinishTicks, vThreads[i]->uiFinishTicks);
+		}
+
+		const bool bGpuTimed = Latency::IsGpuWait();
+		Latency::EndPresent(uiFlipTicks, bGpuTimed);
+
+		if (bGpuTimed && !vSwapped.empty())
+		{
+			WaitForGpu(vSwapped);
+			vSwapped.clear();
+		}
+		else if (bGpuTimed)
+			Latency::EndGpu(uiFinishTicks); // Without ARB_sync the present threads finished their swaps themselves
+		bLatencyPending = false;
+	}
+
+	for (unsigned int i = 0; i < vSwapped.size(); ++i)
+		Fence::Delete(vSwapped[i]);
+
+	TakeGpuTimes();
+}
+
+void Graphics::StopPresentThreads()
+{
+	for (unsigned int i = 0; i < vThreads.size(); ++i)
+	{
+		PresentThread* pThread = vThreads[i];
+		{
+			std::lock_guard<std::mutex> Lock(pThread->Mutex);
+			pThread->bStop = true;
+			pThread->Signal.notify_one();
+		}
+		pThread->Thread.join();
+
+		SDL_GL_DeleteContext(pThread->sdlContext);
+		delete pThread;
+	}
+	vThreads.clear();
+
+	StopGpuWaitThread();
+}
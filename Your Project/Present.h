@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////
+// File: Present.h
+// Author: Ben Odom
+// Brief: Shows what was drawn into every window. 'Flip'
+//		  swaps the windows one after another, and with vsync
+//		  on each swap waits for the display on its own, so
+//		  two windows run at half the refresh rate. 'Present'
+//		  can have only one window wait, or swap every window
+//		  at once from threads of their own, and can leave
+//		  windows nothing new was drawn into as they are
+//////////////////////////////////////////////////////////////
+
+#ifndef _PRESENT_H_
+#define _PRESENT_H_
+
+#include "Graphics.h"
+
+namespace Graphics
+{
+	// How 'Present' swaps the windows
+	enum PresentMode
+	{
+		PRESENT_SEQUENTIAL, // One after another, each waiting for vsync, the same as 'Flip'
+		PRESENT_ONE_VSYNC,	// Only the vsync window waits. The rest swap straight away, which may tear
+		PRESENT_THREADED	// Every window swaps at the same time from a thread of its own, and only the vsync window waits
+	};
+
+	// - Sets how 'Present' swaps the windows. 'PRESENT_SEQUENTIAL' is the default
+	void SetPresentMode(const PresentMode ac_eMode);
+	// - Returns how 'Present' swaps the windows
+	PresentMode GetPresentMode();
+	// - Sets which window in 'voWindows' waits for vsync when only one does. 0 by default
+	void SetVsyncWindow(const unsigned int ac_uiWindow);
+	// - Returns which window waits for vsync when only one does
+	unsigned int GetVsyncWindow();
+
+	/* - Turns skipping windows whose content didn't change on or off. It is off by default
+	   'DrawCameras' works out whether what each camera drew changed. Anything drawn another way, such as with 'DrawRect',
+	   only shows up once its window is passed to 'MarkWindowChanged' in the frames it changes in
+	*/
+	void SetSkipUnchangedWindows(const bool ac_bSkip);
+	// - Whether windows whose content didn't change are skipped
+	bool IsSkippingUnchangedWindows();
+	// - Makes 'Present' swap a window this frame even if nothing 'DrawCameras' drew into it changed
+	void MarkWindowChanged(const unsigned int ac_uiWindow);
+	// - The same as 'MarkWindowChanged' for whichever window is current
+	void MarkCurrentWindowChanged();
+	// - Adds a hash of what a camera drew to its window's content this frame. 'DrawCameras' calls it for each camera
+	void AddWindowContent(const unsigned int ac_uiWindow, const Uint64 ac_uiHash);
+
+	// - Swaps every window that changed and gets them ready for the next frame. Use it in place of 'Flip'
+	void Present();
+	/* - Waits for the windows 'Present' handed to their threads to finish swapping. Does nothing in the other modes
+	   Call it before drawing, so nothing is drawn into a window still being swapped. 'GameLoop' calls it before 'Draw'
+	*/
+	void WaitForPresent();
+	// - Ends the threads of 'PRESENT_THREADED' and the one timing 'Latency::STAGE_GPU', and deletes their contexts. Call before 'Quit'
+	void StopPresentThreads();
+}
+
+#endif // _PRESENT_H_
@@ -0,0 +1,293 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'fopen' with Visual Studio's SDL checks turned on
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+	const unsigned int kuiZoneCapacity = 1 << 14; // Zones kept per thread. Must be a power of two
+	const unsigned int kuiMaxThreads = 64;		  // Threads past this many are simply not recorded
+
+	// Every thread that records a zone gets one of these. Only the owning thread ever writes to it
+	struct ThreadBuffer
+	{
+		Profiler::Zone aZones[kuiZoneCapacity];
+		std::atomic<Uint32> uiHead; // How many zones have ever been written. The newest is at 'uiHead - 1'
+
+		unsigned int uiIndex;
+		std::atomic<const char*> szName;
+	};
+
+	std::atomic<bool> bEnabled(false);
+
+	// Buffers are never freed so that zones from finished threads can still be exported
+	std::atomic<ThreadBuffer*> apBuffers[kuiMaxThreads];
+	std::atomic<unsigned int>  uiBufferCount(0);
+
+	thread_local ThreadBuffer* pThreadBuffer = nullptr;
+	ThreadBuffer*			   pGpuBuffer = nullptr;	// The "GPU" track. Only written from the thread that calls 'EndFrame'
+	ThreadBuffer*			   pFrameBuffer = nullptr;	// The buffer of the thread that calls 'BeginFrame'
+
+	const Uint64 uiStartTicks = SDL_GetPerformanceCounter(); // Traces are written relative to program start
+	const double dTicksPerMicrosecond = SDL_GetPerformanceFrequency() / 1000000.0;
+
+	Uint64 uiFrameBegin = 0;
+	int	   iFrameIndex = 0;
+
+	Profiler::FrameTimings frameTimings = {};
+	std::vector<Profiler::ZoneTime> vCurrentCpu; // Totals for the frame in progress
+	std::vector<Profiler::ZoneTime> vCurrentGpu; // Totals for the GPU frame being resolved
+	int iCurrentGpuFrame = -1;
+
+	std::string sExitFilename;
+
+	ThreadBuffer* NewBuffer(const char* ac_szName)
+	{
+		const unsigned int uiIndex = uiBufferCount.fetch_add(1, std::memory_order_relaxed);
+		if (uiIndex >= kuiMaxThreads)
+			return nullptr;
+
+		ThreadBuffer* pBuffer = new ThreadBuffer;
+		pBuffer->uiHead.store(0, std::memory_order_relaxed);
+		pBuffer->uiIndex = uiIndex;
+		pBuffer->szName.store(ac_szName, std::memory_order_relaxed);
+
+		apBuffers[uiIndex].store(pBuffer, std::memory_order_release);
+		return pBuffer;
+	}
+	ThreadBuffer* GetThreadBuffer()
+	{
+		if (pThreadBuffer == nullptr)
+			pThreadBuffer = NewBuffer(nullptr);
+
+		return pThreadBuffer;
+	}
+
+	void Write(ThreadBuffer* a_pBuffer, const char* ac_szName, const Uint64 ac_uiBegin, const Uint64 ac_uiEnd, const int ac_iArg)
+	{
+		// Only the owner writes 'uiHead', so a relaxed load is enough. The release store publishes the zone to 'ExportChromeTrace'
+		const Uint32 uiHead = a_pBuffer->uiHead.load(std::memory_order_relaxed);
+
+		Profiler::Zone& zone = a_pBuffer->aZones[uiHead & (kuiZoneCapacity - 1)];
+		zone.szName = ac_szName;
+		zone.uiBegin = ac_uiBegin;
+		zone.uiEnd = ac_uiEnd;
+		zone.iArg = ac_iArg;
+
+		a_pBuffer->uiHead.store(uiHead + 1, std::memory_order_release);
+	}
+
+	// Adds a zone's time to the frame totals. Zones are matched by name pointer, which is fine since names are literals
+	void Accumulate(std::vector<Profiler::ZoneTime>& a_vTotals, const char* ac_szName, const int ac_iArg, const double ac_dMilliseconds)
+	{
+		for (unsigned int i = 0; i < a_vTotals.size(); ++i)
+		{
+			if (a_vTotals[i].szName == ac_szName && a_vTotals[i].iArg == ac_iArg)
+			{
+				a_vTotals[i].dMilliseconds += ac_dMilliseconds;
+				return;
+			}
+		}
+
+		const Profiler::ZoneTime zoneTime = { ac_szName, ac_iArg, ac_dMilliseconds };
+		a_vTotals.push_back(zoneTime);
+	}
+
+	// Writes 'ac_szText' as a JSON string, escaping anything that would break the file
+	void WriteJSONString(FILE* a_pFile, const char* ac_szText)
+	{
+		fputc('"', a_pFile);
+		for (const char* pChar = ac_szText; *pChar != '\0'; ++pChar)
+		{
+			if (*pChar == '"' || *pChar == '\\')
+				fputc('\\', a_pFile);
+			if ((unsigned char)*pChar >= 0x20)
+				fputc(*pChar, a_pFile);
+		}
+		fputc('"', a_pFile);
+	}
+
+	void ExportOnExit()
+	{
+		Profiler::ExportChromeTrace(sExitFilename.c_str());
+	}
+}
+
+void Profiler::Enable(const bool ac_bEnabled)
+{
+	bEnabled.store(ac_bEnabled, std::memory_order_relaxed);
+}
+bool Profiler::IsEnabled()
+{
+	return bEnabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::BeginFrame()
+{
+	pFrameBuffer = GetThreadBuffer();
+	uiFrameBegin = IsEnabled() ? Now() : 0;
+}
+void Profiler::EndFrame()
+{
+	ResolveGpuZones();
+
+	if (uiFrameBegin != 0)
+	{
+		const Uint64 uiFrameEnd = Now();
+		Record("Frame", uiFrameBegin, uiFrameEnd, iFrameIndex);
+
+		frameTimings.dFrameMilliseconds = ToMilliseconds(uiFrameEnd - uiFrameBegin);
+	}
+
+	frameTimings.vCpu.swap(vCurrentCpu);
+	vCurrentCpu.clear();
+
+	++iFrameIndex;
+}
+
+void Profiler::Record(const char* ac_szName, const Uint64 ac_uiBegin, const Uint64 ac_uiEnd, const int ac_iArg)
+{
+	ThreadBuffer* pBuffer = GetThreadBuffer();
+	if (pBuffer == nullptr)
+		return;
+
+	Write(pBuffer, ac_szName, ac_uiBegin, ac_uiEnd, ac_iArg);
+
+	if (pBuffer == pFrameBuffer)
+		Accumulate(vCurrentCpu, ac_szName, ac_iArg, ToMilliseconds(ac_uiEnd - ac_uiBegin));
+}
+void Profiler::RecordGpu(const char* ac_szName, const Uint64 ac_uiBegin, const Uint64 ac_uiEnd, const int ac_iArg, const int ac_iFrame)
+{
+	if (pGpuBuffer == nullptr)
+		pGpuBuffer = NewBuffer("GPU");
+	if (pGpuBuffer != nullptr)
+		Write(pGpuBuffer, ac_szName, ac_uiBegin, ac_uiEnd, ac_iArg);
+
+	// Zones come back in the order they were issued, so a zone from a newer frame means the older one is complete
+	if (ac_iFrame != iCurrentGpuFrame)
+	{
+		if (iCurrentGpuFrame >= 0)
+		{
+			frameTimings.vGpu.swap(vCurrentGpu);
+			frameTimings.iGpuLatency = iFrameIndex - iCurrentGpuFrame;
+		}
+
+		vCurrentGpu.clear();
+		iCurrentGpuFrame = ac_iFrame;
+	}
+	Accumulate(vCurrentGpu, ac_szName, ac_iArg, ToMilliseconds(ac_uiEnd - ac_uiBegin));
+}
+
+const Profiler::FrameTimings& Profiler::GetFrameTimings()
+{
+	return frameTimings;
+}
+int Profiler::GetFrameIndex()
+{
+	return iFrameIndex;
+}
+
+void Profiler::NameThread(const char* ac_szName)
+{
+	ThreadBuffer* pBuffer = GetThreadBuffer();
+	if (pBuffer != nullptr)
+		pBuffer->szName.store(ac_szName, std::memory_order_relaxed);
+}
+
+Uint64 Profiler::Now()
+{
+	return SDL_GetPerformanceCounter();
+}
+double Profiler::ToMilliseconds(const Uint64 ac_uiTicks)
+{
+	return ac_uiTicks / (dTicksPerMicrosecond * 1000.0);
+}
+
+bool Profiler::ExportChromeTrace(const char* ac_szFilename)
+{
+	FILE* pFile = fopen(ac_szFilename, "w");
+	if (pFile == NULL)
+	{
+		printf("Profiler: Could not open '%s' for writing\n", ac_szFilename);
+		return false;
+	}
+
+	fprintf(pFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	bool bFirst = true;
+	std::vector<Zone> vZones;
+
+	const unsigned int uiThreads = std::min(uiBufferCount.load(std::memory_order_relaxed), kuiMaxThreads);
+	for (unsigned int i = 0; i < uiThreads; ++i)
+	{
+		ThreadBuffer* pBuffer = apBuffers[i].load(std::memory_order_acquire);
+		if (pBuffer == nullptr)
+			continue; // The thread is still registering itself
+
+		// Copy the zones out first, then throw away any the owning thread overwrote while we were copying
+		const Uint32 uiHead = pBuffer->uiHead.load(std::memory_order_acquire);
+		const Uint32 uiCount = std::min(uiHead, kuiZoneCapacity);
+
+		vZones.resize(uiCount);
+		for (Uint32 j = 0; j < uiCount; ++j)
+			vZones[j] = pBuffer->aZones[(uiHead - uiCount + j) & (kuiZoneCapacity - 1)];
+
+		// Once the ring is full the slot at 'uiHeadAfter' is the oldest copied, and the owner may be halfway through writing it
+		// without having moved 'uiHead' yet, so it goes too
+		const Uint32 uiHeadAfter = pBuffer->uiHead.load(std::memory_order_acquire);
+		const Uint32 uiOverwritten = uiCount == kuiZoneCapacity ? std::min(uiHeadAfter - uiHead + 1, uiCount) : std::min(uiHeadAfter - uiHead, uiCount);
+
+		const char* szThreadName = pBuffer->szName.load(std::memory_order_relaxed);
+		fprintf(pFile, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", bFirst ? "" : ",\n", pBuffer->uiIndex);
+		WriteJSONString(pFile, szThreadName != nullptr ? szThreadName : "Thread");
+		fprintf(pFile, "}}");
+		bFirst = false;
+
+		for (Uint32 j = uiOverwritten; j < uiCount; ++j)
+		{
+			const Zone& zone = vZones[j];
+
+			fprintf(pFile, ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+				pBuffer->uiIndex,
+				(zone.uiBegin - uiStartTicks) / dTicksPerMicrosecond,
+				(zone.uiEnd - zone.uiBegin) / dTicksPerMicrosecond);
+			WriteJSONString(pFile, zone.szName);
+
+			if (zone.iArg >= 0)
+				fprintf(pFile, ",\"args\":{\"index\":%d}", zone.iArg);
+
+			fputc('}', pFile);
+		}
+	}
+
+	fprintf(pFile, "\n]}\n");
+	fclose(pFile);
+
+	return true;
+}
+void Profiler::ExportAtExit(const char* ac_szFilename)
+{
+	const bool bRegistered = !sExitFilename.empty();
+
+	sExitFilename = ac_szFilename;
+	if (!bRegistered)
+		atexit(ExportOnExit);
+}
+
+Profiler::ScopedZone::ScopedZone(const char* ac_szName, const int ac_iArg)
+{
+	m_szName = ac_szName;
+	m_iArg = ac_iArg;
+	m_uiBegin = IsEnabled() ? Now() : 0;
+}
+Profiler::ScopedZone::~ScopedZone()
+{
+	if (m_uiBegin != 0)
+		Record(m_szName, m_uiBegin, Now(), m_iArg);
+}
@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////
+// File: Profiler.h
+// Author: Ben Odom
+// Brief: Scoped timing zones for finding out where a frame's
+//		  time goes. Each thread records into its own ring
+//		  buffer without locking, and the recorded zones can
+//		  be written out as a Chrome/Perfetto trace file
+//		  (open it in chrome://tracing or ui.perfetto.dev)
+//		  GPU zones are timed with OpenGL timestamp queries
+//		  and read back a few frames later
+//////////////////////////////////////////////////////////////
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <SDL.h>
+
+#include <vector>
+
+namespace Profiler
+{
+	// A single timed zone. 'szName' must be a string literal since only the pointer is stored
+	struct Zone
+	{
+		const char* szName;
+
+		Uint64 uiBegin; // Performance counter ticks
+		Uint64 uiEnd;
+
+		int iArg; // An optional number shown alongside the zone, such as a camera index. -1 if unused
+	};
+
+	// How long every zone with the same name and number took in total during one frame
+	struct ZoneTime
+	{
+		const char* szName;
+		int iArg;
+
+		double dMilliseconds;
+	};
+
+	// CPU and GPU times for the most recent frames, as returned by 'GetFrameTimings'
+	struct FrameTimings
+	{
+		double dFrameMilliseconds;	 // Time between 'BeginFrame' and 'EndFrame' of the last finished frame
+		std::vector<ZoneTime> vCpu;	 // Zones recorded on the thread that calls 'BeginFrame' during the last finished frame
+		std::vector<ZoneTime> vGpu;	 // GPU zones of the newest frame whose query results have come back
+
+		int iGpuLatency; // How many frames older the GPU times are than the CPU times
+	};
+
+	// - Turns recording on or off. Zones cost a single branch while recording is off
+	void Enable(const bool ac_bEnabled);
+	// - Whether or not zones are currently being recorded
+	bool IsEnabled();
+
+	// - Marks the start of a new frame. Call once at the top of the game loop
+	void BeginFrame();
+	// - Marks the end of the current frame. Call once after 'Graphics::Flip()'
+	void EndFrame();
+
+	// - Stores a finished zone into the calling thread's ring buffer
+	void Record(const char* ac_szName, const Uint64 ac_uiBegin, const Uint64 ac_uiEnd, const int ac_iArg = -1);
+	// - Stores a finished GPU zone on the trace's "GPU" track. 'ac_iFrame' is the frame the zone was issued in
+	void RecordGpu(const char* ac_szName, const Uint64 ac_uiBegin, const Uint64 ac_uiEnd, const int ac_iArg, const int ac_iFrame);
+
+	// - Returns the times of the last finished frame. Only valid on the thread that calls 'BeginFrame'
+	const FrameTimings& GetFrameTimings();
+	// - Returns how many frames have been finished with 'EndFrame'
+	int GetFrameIndex();
+
+	// - Starts timing GPU work issued to the current OpenGL context. Zones may be nested
+	void BeginGpuZone(const char* ac_szName, const int ac_iArg = -1);
+	// - Stops timing the most recently started GPU zone
+	void EndGpuZone();
+	// - Reads back any GPU zones whose results are ready without waiting on the GPU. Called by 'EndFrame'
+	void ResolveGpuZones();
+	// - Whether or not the current OpenGL context supports timestamp queries
+	bool IsGpuTimingSupported();
+
+	// - Names the calling thread in exported traces. 'ac_szName' must be a string literal
+	void NameThread(const char* ac_szName);
+
+	// - Returns the current time in performance counter ticks
+	Uint64 Now();
+	// - Converts performance counter ticks into milliseconds
+	double ToMilliseconds(const Uint64 ac_uiTicks);
+
+	// - Writes every zone still held in the ring buffers to a Chrome trace JSON file
+	bool ExportChromeTrace(const char* ac_szFilename);
+	// - Writes a Chrome trace JSON file automatically when the program exits
+	void ExportAtExit(const char* ac_szFilename);
+
+	// Records the time between its construction and destruction as one zone
+	// Use the 'PROFILE_ZONE' macro rather than creating these directly
+	class ScopedZone
+	{
+	private:
+		const char* m_szName;
+		Uint64 m_uiBegin;
+		int m_iArg;
+
+	public:
+		ScopedZone(const char* ac_szName, const int ac_iArg = -1);
+		~ScopedZone();
+
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+	};
+
+	// Times the GPU work issued between its construction and destruction
+	// Use the 'PROFILE_GPU_ZONE' macro rather than creating these directly
+	class ScopedGpuZone
+	{
+	public:
+		ScopedGpuZone(const char* ac_szName, const int ac_iArg = -1);
+		~ScopedGpuZone();
+
+		ScopedGpuZone(const ScopedGpuZone&) = delete;
+		ScopedGpuZone& operator=(const ScopedGpuZone&) = delete;
+	};
+}
+
+// Define 'PROFILER_DISABLED' in the project settings to compile every zone out entirely
+#ifndef PROFILER_DISABLED
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// - Times the rest of the enclosing scope. ex: "PROFILE_ZONE("Physics");"
+#define PROFILE_ZONE(name) Profiler::ScopedZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+// - Times the rest of the enclosing scope and tags it with a number. ex: "PROFILE_ZONE_ARG("Camera", i);"
+#define PROFILE_ZONE_ARG(name, arg) Profiler::ScopedZone PROFILE_CONCAT(profileZone_, __LINE__)(name, arg)
+
+// - Times the GPU work issued in the rest of the enclosing scope
+#define PROFILE_GPU_ZONE(name) Profiler::ScopedGpuZone PROFILE_CONCAT(profileGpuZone_, __LINE__)(name)
+// - Times the GPU work issued in the rest of the enclosing scope and tags it with a number
+#define PROFILE_GPU_ZONE_ARG(name, arg) Profiler::ScopedGpuZone PROFILE_CONCAT(profileGpuZone_, __LINE__)(name, arg)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_ZONE_ARG(name, arg)
+#define PROFILE_GPU_ZONE(name)
+#define PROFILE_GPU_ZONE_ARG(name, arg)
+#endif // PROFILER_DISABLED
+
+#endif // _PROFILER_H_
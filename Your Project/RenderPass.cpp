@@ -0,0 +1,672 @@
+#include "RenderPass.h"
+#include "DynamicResolution.h"
+#include "GLState.h"
+#include "Overdraw.h"
+#include "Present.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+	// Names for each 'LayerType' as they show up in the profiler
+	const char* const aszLayerNames[] =
+	{
+		"BACKGROUND",
+		"INLINEFORE",
+		"MIDGROUND",
+		"FOREGROUND",
+
+		"FOUNDATION",
+		"STRUCTURE",
+		"OVERLAY",
+
+		"ALWAYS_TOP"
+	};
+
+	const float kfCullMargin = 1.0f; // World units a surface may sit outside a camera and still be drawn, for 'DrawSurface' rounding ints
+	const unsigned int kuiMaxDepthBits = 24; // More bits than this can't be told apart through the float the depth is given as
+
+	const Uint64 kuiHashBasis = 14695981039346656037ull; // FNV-1a
+	const Uint64 kuiHashPrime = 1099511628211ull;
+
+	// - Mixes raw bytes into a hash of what a camera drew
+	Uint64 HashBytes(Uint64 a_uiHash, const void* ac_pData, const size_t ac_uiSize)
+	{
+		const Uint8* pBytes = (const Uint8*)ac_pData;
+		for (size_t i = 0; i < ac_uiSize; ++i)
+			a_uiHash = (a_uiHash ^ pBytes[i]) * kuiHashPrime;
+		return a_uiHash;
+	}
+
+	// - Mixes everything 'DrawSurface' reads from a surface into a hash. Every field before 'bIsActive' is 4 bytes, so none of it is padding
+	template <typename T>
+	Uint64 HashSurface(const Uint64 ac_uiHash, const Graphics::GLSurface<T>& ac_Surface)
+	{
+		return HashBytes(ac_uiHash, &ac_Surface, offsetof(Graphics::GLSurface<T>, bIsActive));
+	}
+
+	// - Mixes where a camera looks and where on its window it draws into a hash
+	template <typename T>
+	Uint64 HashCamera(Graphics::Camera<T>& a_Camera)
+	{
+		const System::Point2D<T> WorldPos = a_Camera.GetWorldPos(); // Copied straight away, as it is worked out rather than stored
+		const T Rotation = a_Camera.GetRotation();
+
+		Uint64 uiHash = kuiHashBasis;
+		uiHash = HashBytes(uiHash, &a_Camera.GetScreenPos(), sizeof(System::Point2D<T>));
+		uiHash = HashBytes(uiHash, &WorldPos, sizeof(WorldPos));
+		uiHash = HashBytes(uiHash, &a_Camera.GetDimensions(), sizeof(System::Size2D<T>));
+		uiHash = HashBytes(uiHash, &a_Camera.GetResolution(), sizeof(System::Size2D<T>));
+		uiHash = HashBytes(uiHash, &a_Camera.GetZoom(), sizeof(System::Size2D<T>));
+		return HashBytes(uiHash, &Rotation, sizeof(Rotation));
+	}
+
+	// A surface in a world space some camera looks at, with what culling needs already worked out
+	struct VisibleSurface
+	{
+		const Graphics::SurfaceUnion* pSurface;
+		GLuint uiTexture;
+		int iLayer;
+
+		float fLeft, fTop, fRight, fBottom; // The quad 'DrawSurface' draws, in world units
+		float fPivotX, fPivotY;				// What the surface is scaled and rotated around once the camera has moved it
+		float fScaleW, fScaleH;
+		bool bRotated;
+		bool bOpaque; // Nothing under it shows through, so it may be drawn before what it covers
+	};
+
+	// Every active surface of one world space, in the layer order of 'vglSurfaces'
+	struct WorldList
+	{
+		unsigned int uiWorldSpace;
+		std::vector<VisibleSurface> vSurfaces;
+	};
+
+	// How a camera moves world units onto its resolution. Cameras with the same view draw the same thing wherever they sit
+	// Every field is 4 bytes, so two views can be compared with 'memcmp'
+	struct View
+	{
+		unsigned int uiWorldSpace;
+		float fWorldX, fWorldY;
+		float fZoomW, fZoomH;
+		float fRotation;
+		float fResolutionW, fResolutionH;
+	};
+
+	// What the first camera with a view submitted, so the cameras after it that share the view can call it again
+	struct SharedView
+	{
+		View view;
+		unsigned int uiCameras; // How many cameras this frame have the view
+
+		GLuint uiList;	// The display list the first camera compiled, or 0 if no other camera needs it
+		bool bDrawn;
+		bool bDepth;	// Drawn with the depth pass, so every camera with the view needs the depth buffer ready
+
+		unsigned int uiSubmitted;
+		unsigned int uiInWorld; // Surfaces of its world space, drawn or culled
+		unsigned int uiBinds;
+		Uint64 uiHash; // What was drawn, for 'AddWindowContent'
+	};
+
+	std::vector<WorldList> vWorlds;
+	std::vector<SharedView> vViews;
+	std::vector<unsigned int> vCameraViews; // Which of 'vViews' each camera has
+	std::vector<const VisibleSurface*> vVisible;
+
+	bool bDepthPass = false;
+	bool bCulling = true;
+	bool bDepthFrame = false; // Whether this frame can use the depth pass, worked out once in 'DrawCameras'
+	bool bBlending = false;	  // Whether blending was on when the frame started. Without it every surface hides what is under it
+	bool bCounting = false;	  // Whether this frame is drawn in the overdraw mode
+
+	WorldList* FindWorld(const unsigned int ac_uiWorldSpace, const unsigned int ac_uiWorlds)
+	{
+		for (unsigned int i = 0; i < ac_uiWorlds; ++i)
+		{
+			if (vWorlds[i].uiWorldSpace == ac_uiWorldSpace)
+				return &vWorlds[i];
+		}
+		return nullptr;
+	}
+
+	template <typename T>
+	View GetView(Graphics::Camera<T>& a_Camera)
+	{
+		const System::Point2D<T> WorldPos = a_Camera.GetWorldPos(); // Copied straight away, as it is worked out rather than stored
+
+		const View view = { a_Camera.GetWorldSpace(), (float)WorldPos.X, (float)WorldPos.Y, (float)a_Camera.GetZoom().W, (float)a_Camera.GetZoom().H,
+			(float)a_Camera.GetRotation(), (float)a_Camera.GetResolution().W, (float)a_Camera.GetResolution().H };
+		return view;
+	}
+
+	// - Works out what culling and the depth pass need to know about a surface
+	template <typename T>
+	VisibleSurface Describe(const Graphics::SurfaceUnion& ac_Union, const Graphics::GLSurface<T>& ac_Surface)
+	{
+		const float fHalfW = (float)ac_Surface.OffsetD.W / 2;
+		const float fHalfH = (float)ac_Surface.OffsetD.H / 2;
+
+		VisibleSurface surface;
+		surface.pSurface = &ac_Union;
+		surface.uiTexture = ac_Surface.Surface;
+		surface.iLayer = ac_Surface.Layer;
+
+		surface.fLeft = (float)ac_Surface.Pos.X - fHalfW;
+		surface.fTop = (float)ac_Surface.Pos.Y - fHalfH;
+		surface.fRight = (float)ac_Surface.Pos.X + fHalfW;
+		surface.fBottom = (float)ac_Surface.Pos.Y + fHalfH;
+
+		surface.fPivotX = (float)ac_Surface.Pos.X + (float)ac_Surface.Center.X - fHalfW;
+		surface.fPivotY = (float)ac_Surface.Pos.Y + (float)ac_Surface.Center.Y - fHalfH;
+		surface.fScaleW = (float)ac_Surface.Scale.W;
+		surface.fScaleH = (float)ac_Surface.Scale.H;
+		surface.bRotated = ac_Surface.Rotation != 0;
+
+		// 'DrawSurface' hands the color to 'glColor4ub', so the alpha that counts is the one that byte ends up with
+		surface.bOpaque = (GLubyte)ac_Surface.Color.Alpha == 255 && Graphics::TextureCache::IsOpaque(ac_Surface.Surface);
+
+		return surface;
+	}
+
+	// - Adds a surface to the list of its world space, if it is active and a camera looks at that world space
+	template <typename T>
+	void AddVisible(const Graphics::SurfaceUnion& ac_Union, const Graphics::GLSurface<T>& ac_Surface, const unsigned int ac_uiWorlds)
+	{
+		if (!ac_Surface.bIsActive)
+			return;
+
+		WorldList* pWorld = FindWorld(ac_Surface.uiWorldSpace, ac_uiWorlds);
+		if (pWorld != nullptr)
+			pWorld->vSurfaces.push_back(Describe(ac_Union, ac_Surface));
+	}
+
+	/* - Sorts every active surface into the world space it belongs to, once a frame for all cameras
+	   Works out which view each camera has and how many cameras share it
+	*/
+	void BuildWorldLists()
+	{
+		unsigned int uiWorlds = 0;
+		vViews.clear();
+		vCameraViews.resize(Graphics::voCameras.size());
+
+		for (unsigned int i = 0; i < Graphics::voCameras.size(); ++i)
+		{
+			const View view = Graphics::voCameras[i]->Tag == Graphics::CameraUnion::INT ? GetView(*Graphics::voCameras[i]->iCamera) : GetView(*Graphics::voCameras[i]->fCamera);
+
+			// The lists are kept between frames so their memory is reused
+			if (FindWorld(view.uiWorldSpace, uiWorlds) == nullptr)
+			{
+				if (vWorlds.size() <= uiWorlds)
+					vWorlds.resize(uiWorlds + 1);
+				vWorlds[uiWorlds].uiWorldSpace = view.uiWorldSpace;
+				vWorlds[uiWorlds].vSurfaces.clear();
+				++uiWorlds;
+			}
+
+			unsigned int uiView = 0;
+			while (uiView < vViews.size() && memcmp(&vViews[uiView].view, &view, sizeof(view)) != 0)
+				++uiView;
+			if (uiView == vViews.size())
+			{
+				const SharedView shared = { view, 0, 0, false, false, 0, 0, 0, kuiHashBasis };
+				vViews.push_back(shared);
+			}
+
+			++vViews[uiView].uiCameras;
+			vCameraViews[i] = uiView;
+		}
+
+		for (unsigned int i = 0; i < Graphics::vglSurfaces.size(); ++i)
+		{
+			const Graphics::SurfaceUnion& surface = *Graphics::vglSurfaces[i];
+			if (surface.Tag == Graphics::SurfaceUnion::INT)
+				AddVisible(surface, *surface.iGLSurface, uiWorlds);
+			else
+				AddVisible(surface, *surface.fGLSurface, uiWorlds);
+		}
+	}
+
+	/* - Whether any of a surface lands inside a camera's resolution. It follows 'DrawSurface', which moves the quad by the
+	   camera's world position, rotation and zoom, and only then scales and rotates it around its pivot
+	   A rotated surface is bounded by the circle its corners turn through, so it is never culled when any of it shows
+	*/
+	bool IsVisible(const VisibleSurface& ac_Surface, const View& ac_View, const float ac_fCos, const float ac_fSin)
+	{
+		const float afX[4] = { ac_Surface.fLeft, ac_Surface.fRight, ac_Surface.fRight, ac_Surface.fLeft };
+		const float afY[4] = { ac_Surface.fTop, ac_Surface.fTop, ac_Surface.fBottom, ac_Surface.fBottom };
+
+		float fMinX = 0.0f, fMaxX = 0.0f, fMinY = 0.0f, fMaxY = 0.0f;
+		float fRadius = 0.0f;
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			const float fX = afX[i] - ac_View.fWorldX;
+			const float fY = afY[i] - ac_View.fWorldY;
+
+			// Relative to the pivot, where the surface's own scale and rotation happen
+			const float fPivotX = ac_View.fResolutionW / 2 + ac_View.fZoomW * (fX * ac_fCos - fY * ac_fSin) - ac_Surface.fPivotX;
+			const float fPivotY = ac_View.fResolutionH / 2 + ac_View.fZoomH * (fX * ac_fSin + fY * ac_fCos) - ac_Surface.fPivotY;
+
+			if (ac_Surface.bRotated)
+			{
+				fRadius = std::max(fRadius, sqrtf(fPivotX * fPivotX + fPivotY * fPivotY));
+				continue;
+			}
+
+			const float fScreenX = ac_Surface.fPivotX + ac_Surface.fScaleW * fPivotX;
+			const float fScreenY = ac_Surface.fPivotY + ac_Surface.fScaleH * fPivotY;
+			fMinX = i == 0 ? fScreenX : std::min(fMinX, fScreenX);
+			fMaxX = i == 0 ? fScreenX : std::max(fMaxX, fScreenX);
+			fMinY = i == 0 ? fScreenY : std::min(fMinY, fScreenY);
+			fMaxY = i == 0 ? fScreenY : std::max(fMaxY, fScreenY);
+		}
+
+		if (ac_Surface.bRotated)
+		{
+			fRadius *= std::max(fabsf(ac_Surface.fScaleW), fabsf(ac_Surface.fScaleH));
+			fMinX = ac_Surface.fPivotX - fRadius;
+			fMaxX = ac_Surface.fPivotX + fRadius;
+			fMinY = ac_Surface.fPivotY - fRadius;
+			fMaxY = ac_Surface.fPivotY + fRadius;
+		}
+
+		return fMaxX >= -kfCullMargin && fMinX <= ac_View.fResolutionW + kfCullMargin &&
+			   fMaxY >= -kfCullMargin && fMinY <= ac_View.fResolutionH + kfCullMargin;
+	}
+
+	// - Returns how many surfaces the depth buffer can give depths of their own, or 0 if the windows don't have one
+	unsigned int DepthLevels()
+	{
+		static GLint iDepthBits = -1;
+		if (iDepthBits < 0)
+			glGetIntegerv(GL_DEPTH_BITS, &iDepthBits);
+
+		// Half the values the buffer holds, so neighbouring depths never round to the same one
+		const unsigned int uiBits = (unsigned int)iDepthBits < kuiMaxDepthBits ? (unsigned int)iDepthBits : kuiMaxDepthBits;
+		return uiBits > 1 ? 1u << (uiBits - 1) : 0;
+	}
+
+	/* - Whether surfaces can be drawn out of painter's order this frame. It needs a depth buffer, and an opaque surface drawn
+	   over anything has to leave just its own color. That holds with blending off and with either "over" blend function
+	   Anything else, such as adding, depends on everything under the surface, which then has to be drawn first
+	*/
+	bool CanDrawDepthPass()
+	{
+		if (DepthLevels() == 0)
+			return false;
+
+		const Graphics::GLState::Cache& cache = Graphics::GLState::Current();
+		bBlending = cache.bBlendKnown ? cache.bBlend : glIsEnabled(GL_BLEND) == GL_TRUE;
+		if (!bBlending)
+			return true;
+
+		GLint iSource = (GLint)cache.eBlendSource;
+		GLint iDest = (GLint)cache.eBlendDest;
+		if (!cache.bBlendFuncKnown)
+		{
+			glGetIntegerv(GL_BLEND_SRC, &iSource);
+			glGetIntegerv(GL_BLEND_DST, &iDest);
+		}
+		return (iSource == GL_SRC_ALPHA || iSource == GL_ONE) && iDest == GL_ONE_MINUS_SRC_ALPHA;
+	}
+
+	/* - Clears the depth of the camera's part of the window and turns the depth test on
+	   Only the view-port is cleared, so cameras drawn before it into the same window keep what they drew. Nothing else in the
+	   engine scissors, so scissoring is left off afterwards
+	*/
+	void BeginDepthPass()
+	{
+		const Graphics::GLState::Cache& cache = Graphics::GLState::Current();
+		Graphics::GLState::ScissorBox(cache.aViewport[0], cache.aViewport[1], cache.aViewport[2], cache.aViewport[3]);
+		Graphics::GLState::Scissor(true);
+
+		glDepthMask(GL_TRUE); // 'glClear' leaves the depth buffer alone while writing to it is off
+		glClear(GL_DEPTH_BUFFER_BIT);
+		Graphics::GLState::Scissor(false);
+
+		glEnable(GL_DEPTH_TEST);
+		glDepthFunc(GL_LESS);
+	}
+
+	// - Puts back what the depth pass changed, so anything drawn afterwards is drawn the way it always was
+	void EndDepthPass()
+	{
+		glDisable(GL_DEPTH_TEST);
+		glDepthMask(GL_TRUE);
+		glLoadIdentity(); // The depth of the last surface is still in the model-view matrix
+	}
+
+	// - Draws one visible surface, counting texture changes and mixing it into the hash of what the camera drew
+	template <typename T>
+	void DrawVisible(const VisibleSurface& ac_Visible, Graphics::Camera<T>& a_Camera, SharedView& a_Shared, const bool ac_bHashing, GLuint& a_uiTexture)
+	{
+		if (ac_Visible.uiTexture != a_uiTexture)
+		{
+			a_uiTexture = ac_Visible.uiTexture;
+			++a_Shared.uiBinds;
+		}
+
+		if (bCounting)
+			Graphics::Overdraw::Count(ac_Visible.iLayer);
+
+		const Graphics::SurfaceUnion& surface = *ac_Visible.pSurface;
+		{
+			Graphics::GLState::Untracked untracked;
+			if (surface.Tag == Graphics::SurfaceUnion::INT)
+				Graphics::DrawSurface(*surface.iGLSurface, a_Camera);
+			else
+				Graphics::DrawSurface(*surface.fGLSurface, a_Camera);
+		}
+
+		if (ac_bHashing)
+			a_Shared.uiHash = surface.Tag == Graphics::SurfaceUnion::INT ? HashSurface(a_Shared.uiHash, *surface.iGLSurface) : HashSurface(a_Shared.uiHash, *surface.fGLSurface);
+	}
+
+	/* - Draws 'vVisible' with the depth buffer deciding what shows instead of the order surfaces are drawn in
+	   Each surface gets a depth from where it sits in painter's order, which is 'LayerType' and then the order within the layer,
+	   so later surfaces are nearer. It depends on 'DrawSurface' pushing the model-view matrix without resetting it and scaling
+	   z to 0, so a translation along z put there first is all that carries the depth through. The library is prebuilt, so that
+	   is checked rather than known: the Benchmark project's '--check' run reads back the depths and colors it leaves
+	*/
+	template <typename T>
+	void DrawDepthPass(Graphics::Camera<T>& a_Camera, const unsigned int ac_uiIndex, SharedView& a_Shared, const bool ac_bTimed, const bool ac_bHashing)
+	{
+		// Depths run from just behind the near plane of 'glOrtho' to just in front of the far one, never touching either
+		const float fStep = 2.0f / (vVisible.size() + 1);
+		GLuint uiTexture = 0;
+
+		// Opaque surfaces go nearest first, so the depth test skips every pixel a nearer one already covers
+		// The overdraw mode counts with additive blending, so it is left on
+		if (ac_bTimed)
+			Profiler::BeginGpuZone("OPAQUE", ac_uiIndex);
+		if (!bCounting)
+			Graphics::GLState::Blend(false);
+		glDepthMask(GL_TRUE);
+		for (unsigned int i = (unsigned int)vVisible.size(); i-- > 0;)
+		{
+			if (!vVisible[i]->bOpaque && bBlending)
+				continue;
+
+			glLoadIdentity();
+			glTranslatef(0.0f, 0.0f, -1.0f + fStep * (i + 1));
+			DrawVisible(*vVisible[i], a_Camera, a_Shared, ac_bHashing, uiTexture);
+		}
+		if (ac_bTimed)
+			Profiler::EndGpuZone();
+
+		// Translucent surfaces go farthest first, as before. They are hidden by nearer opaque ones but don't write depth,
+		// so each still blends over everything painter's order would have drawn before it
+		if (!bBlending)
+			return;
+
+		if (ac_bTimed)
+			Profiler::BeginGpuZone("TRANSLUCENT", ac_uiIndex);
+		if (!bCounting)
+			Graphics::GLState::Blend(true);
+		glDepthMask(GL_FALSE);
+		for (unsigned int i = 0; i < vVisible.size(); ++i)
+		{
+			if (vVisible[i]->bOpaque)
+				continue;
+
+			glLoadIdentity();
+			glTranslatef(0.0f, 0.0f, -1.0f + fStep * (i + 1));
+			DrawVisible(*vVisible[i], a_Camera, a_Shared, ac_bHashing, uiTexture);
+		}
+		if (ac_bTimed)
+			Profiler::EndGpuZone();
+	}
+
+	// Makes the camera's window current, drawing into its target at the internal size, and points the view-port and projection at the camera
+	// Where the surface sits relative to the camera (world position, zoom and rotation) is left to 'DrawSurface'
+	template <typename T>
+	void BeginCamera(Graphics::Camera<T>& a_Camera)
+	{
+		Graphics::Window* pWindow = Graphics::voWindows[a_Camera.GetWindowIndex()];
+		// Every window shares one context, so it is the window that has to be checked
+		if (SDL_GL_GetCurrentWindow() != pWindow->GetWindow())
+			SDL_GL_MakeCurrent(pWindow->GetWindow(), Graphics::glContext);
+		Graphics::BindWindowTarget(a_Camera.GetWindowIndex());
+
+		const System::Point2D<T>& ScreenPos = a_Camera.GetScreenPos();
+		const System::Size2D<T>& Dimensions = a_Camera.GetDimensions();
+		const System::Size2D<T>& Resolution = a_Camera.GetResolution();
+
+		// The view-port shrinks with the resolution scale while the projection doesn't, so cameras keep their units
+		Graphics::ScaledViewport((GLint)ScreenPos.X, (GLint)ScreenPos.Y, (GLsizei)Dimensions.W, (GLsizei)Dimensions.H);
+
+		glMatrixMode(GL_PROJECTION);
+		glLoadIdentity();
+		glOrtho(0, Resolution.W, Resolution.H, 0, -1, 1);
+		glMatrixMode(GL_MODELVIEW);
+		glLoadIdentity();
+	}
+
+	// Puts the view-port back to the whole window so anything drawn afterwards isn't clipped to the last camera
+	// The view-port and projection belong to the context every window shares, so only the window left current needs them
+	void EndCameras(SDL_Window* a_sdlWindow, SDL_GLContext a_sdlContext)
+	{
+		// Leave whichever window was current before the camera passes current again
+		unsigned int uiWindow = 0;
+		for (unsigned int i = 0; i < Graphics::voWindows.size(); ++i)
+		{
+			if (Graphics::voWindows[i]->GetWindow() == a_sdlWindow)
+				uiWindow = i;
+		}
+		Graphics::Window* pWindow = Graphics::voWindows[uiWindow];
+		SDL_GL_MakeCurrent(pWindow->GetWindow(), a_sdlContext != NULL ? a_sdlContext : Graphics::glContext);
+		Graphics::BindWindowTarget(uiWindow);
+
+		Graphics::ScaledViewport(0, 0, pWindow->GetDimensions().W, pWindow->GetDimensions().H);
+
+		glMatrixMode(GL_PROJECTION);
+		glLoadIdentity();
+		glOrtho(0, pWindow->GetResolution().W, pWindow->GetResolution().H, 0, -1, 1);
+		glMatrixMode(GL_MODELVIEW);
+		glLoadIdentity();
+	}
+
+	/* Draws the surfaces of the camera's world space that land inside it. Surfaces are kept in the layer order of 'vglSurfaces',
+	   so each run sharing a 'LayerType' is timed as one GPU zone
+	   When other cameras share the camera's view, what it submits is compiled into a display list the others call instead
+	*/
+	template <typename T>
+	void DrawCameraPass(Graphics::Camera<T>& a_Camera, const unsigned int ac_uiIndex)
+	{
+		BeginCamera(a_Camera); // The GPU zone has to start after this so it is issued to the camera's window
+
+		PROFILE_GPU_ZONE_ARG("Camera Pass", ac_uiIndex);
+
+		SharedView& shared = vViews[vCameraViews[ac_uiIndex]];
+
+		// What the camera drew is only worked out when 'Present' can use it to skip the window
+		const bool bHashing = Graphics::IsSkippingUnchangedWindows();
+
+		// The overdraw mode reads back between layers, which a display list can't do, so every camera draws for itself
+		const bool bDrawing = !shared.bDrawn || bCounting;
+
+		if (bDrawing)
+		{
+			shared.uiBinds = 0;
+			shared.uiHash = kuiHashBasis;
+
+			const float fRadians = shared.view.fRotation * 3.14159265f / 180.0f;
+			const float fCos = cosf(fRadians);
+			const float fSin = sinf(fRadians);
+
+			vVisible.clear();
+			const WorldList* pWorld = FindWorld(shared.view.uiWorldSpace, (unsigned int)vWorlds.size());
+			for (unsigned int i = 0; pWorld != nullptr && i < pWorld->vSurfaces.size(); ++i)
+			{
+				if (!bCulling || IsVisible(pWorld->vSurfaces[i], shared.view, fCos, fSin))
+					vVisible.push_back(&pWorld->vSurfaces[i]);
+			}
+			shared.uiInWorld = pWorld != nullptr ? (unsigned int)pWorld->vSurfaces.size() : 0;
+
+			// Textures the budget left out are uploaded before a display list starts, or the upload would be compiled into it
+			GLuint uiTexture = 0;
+			for (unsigned int i = 0; i < vVisible.size(); ++i)
+			{
+				if (vVisible[i]->uiTexture != uiTexture)
+				{
+					uiTexture = vVisible[i]->uiTexture;
+					Graphics::Residency::Touch(uiTexture); // Also keeps it from being evicted this frame
+				}
+			}
+
+			// Too many surfaces for the depth buffer to tell apart are drawn in painter's order
+			shared.bDepth = bDepthFrame && vVisible.size() < DepthLevels();
+		}
+
+		if (bCounting)
+			Graphics::Overdraw::BeginCamera();
+
+		// Every camera clears its own depth, including those that call another's display list
+		if (shared.bDepth)
+			BeginDepthPass();
+
+		if (bDrawing)
+		{
+			// GPU zones can't be compiled, so the layers of a shared view are only timed as part of the camera pass
+			const bool bCompiling = shared.uiCameras > 1 && !bCounting;
+			if (bCompiling)
+			{
+				shared.uiList = glGenLists(1);
+				glNewList(shared.uiList, GL_COMPILE_AND_EXECUTE);
+			}
+
+			if (shared.bDepth)
+			{
+				DrawDepthPass(a_Camera, ac_uiIndex, shared, !bCompiling, bHashing);
+			}
+			else
+			{
+				int iLayer = -1;
+				GLuint uiTexture = 0;
+				for (unsigned int i = 0; i < vVisible.size(); ++i)
+				{
+					const VisibleSurface& visible = *vVisible[i];
+					if (visible.iLayer != iLayer && !bCompiling)
+					{
+						if (iLayer >= 0)
+							Profiler::EndGpuZone();
+
+						iLayer = visible.iLayer;
+						Profiler::BeginGpuZone(aszLayerNames[iLayer], ac_uiIndex);
+					}
+
+					DrawVisible(visible, a_Camera, shared, bHashing, uiTexture);
+				}
+
+				if (iLayer >= 0)
+					Profiler::EndGpuZone();
+			}
+
+			if (bCompiling)
+				glEndList();
+
+			shared.uiSubmitted = (unsigned int)vVisible.size();
+			shared.bDrawn = true;
+		}
+		else
+		{
+			// The list holds the calls 'DrawSurface' made
+			Graphics::GLState::Untracked untracked;
+			glCallList(shared.uiList);
+		}
+
+		if (shared.bDepth)
+			EndDepthPass();
+		if (bCounting)
+			Graphics::Overdraw::EndCamera(ac_uiIndex);
+
+		// Counted for every camera, since a display list still draws everything it holds
+		for (unsigned int i = 0; i < shared.uiBinds; ++i)
+			Graphics::Stats::AddTextureBind();
+		for (unsigned int i = 0; i < shared.uiSubmitted; ++i)
+			Graphics::Stats::AddDraw(Graphics::PRIMITIVE_SURFACE, 4);
+
+		// Surfaces of other world spaces were never the camera's to draw, so they aren't counted as culled
+		Graphics::Stats::AddSurfaces(ac_uiIndex, shared.uiSubmitted, shared.uiInWorld - shared.uiSubmitted);
+
+		if (bHashing)
+			Graphics::AddWindowContent(a_Camera.GetWindowIndex(), (HashCamera(a_Camera) ^ shared.uiHash) * kuiHashPrime);
+	}
+}
+
+void Graphics::DrawCameras()
+{
+	PROFILE_ZONE("Graphics::Draw");
+
+	if (voWindows.empty())
+		return;
+
+	SDL_Window*	  sdlWindow = SDL_GL_GetCurrentWindow();
+	SDL_GLContext sdlContext = SDL_GL_GetCurrentContext();
+
+	{
+		PROFILE_ZONE("Build World Lists");
+		BuildWorldLists();
+	}
+
+	bDepthFrame = bDepthPass && CanDrawDepthPass();
+	bCounting = IsOverdrawMode();
+
+	for (unsigned int i = 0; i < voCameras.size(); ++i)
+	{
+		PROFILE_ZONE_ARG("Camera Pass", i);
+
+		if (voCameras[i]->Tag == CameraUnion::INT)
+			DrawCameraPass(*voCameras[i]->iCamera, i);
+		else
+			DrawCameraPass(*voCameras[i]->fCamera, i);
+	}
+
+	// Display lists only hold this frame's surfaces, so none are kept
+	for (unsigned int i = 0; i < vViews.size(); ++i)
+	{
+		if (vViews[i].uiList != 0)
+			glDeleteLists(vViews[i].uiList, 1);
+	}
+
+	EndCameras(sdlWindow, sdlContext);
+
+	Graphics::Residency::EndFrame();
+}
+
+void Graphics::SetDepthPass(const bool ac_bEnabled)
+{
+	bDepthPass = ac_bEnabled;
+}
+bool Graphics::IsDepthPass()
+{
+	return bDepthPass;
+}
+
+void Graphics::SetCulling(const bool ac_bEnabled)
+{
+	bCulling = ac_bEnabled;
+}
+bool Graphics::IsCulling()
+{
+	return bCulling;
+}
+
+bool Graphics::IsSurfaceInCamera(const SurfaceUnion& ac_Surface, const unsigned int ac_uiCamera)
+{
+	const CameraUnion& camera = *voCameras[ac_uiCamera];
+	const View view = camera.Tag == CameraUnion::INT ? GetView(*camera.iCamera) : GetView(*camera.fCamera);
+
+	const bool bActive = ac_Surface.Tag == SurfaceUnion::INT ? ac_Surface.iGLSurface->bIsActive : ac_Surface.fGLSurface->bIsActive;
+	const unsigned int uiWorldSpace = ac_Surface.Tag == SurfaceUnion::INT ? ac_Surface.iGLSurface->uiWorldSpace : ac_Surface.fGLSurface->uiWorldSpace;
+	if (!bActive || uiWorldSpace != view.uiWorldSpace)
+		return false;
+
+	const float fRadians = view.fRotation * 3.14159265f / 180.0f;
+	const VisibleSurface surface = ac_Surface.Tag == SurfaceUnion::INT ? Describe(ac_Surface, *ac_Surface.iGLSurface) : Describe(ac_Surface, *ac_Surface.fGLSurface);
+	return IsVisible(surface, view, cosf(fRadians), sinf(fRadians));
+}
@@ -0,0 +1,45 @@
+//////////////////////////////////////////////////////////////
+// File: RenderPass.h
+// Author: Ben Odom
+// Brief: Draws every surface through every camera, the same
+//		  way 'Graphics::Draw' does, but one camera pass and
+//		  one layer at a time so each can be measured on its
+//		  own, on the CPU and on the GPU. Surfaces are sorted
+//		  into their world spaces once a frame, each camera
+//		  culls only its own world's list, and cameras with
+//		  the same view share one display list. The depth pass
+//		  draws opaque surfaces front to back so what they
+//		  cover is never filled, then the rest back to front
+//////////////////////////////////////////////////////////////
+
+#ifndef _RENDERPASS_H_
+#define _RENDERPASS_H_
+
+#include "Graphics.h"
+
+namespace Graphics
+{
+	// - Draws all surfaces currently in the 'vglSurfaces' vector through each 'Camera' in 'voCameras' that can see them
+	void DrawCameras();
+
+	/* - Turns the depth pass on or off. It is off by default, and only takes effect when the windows have a depth buffer
+	   A surface is opaque when every pixel of its texture and its color have an alpha of 255. Opaque surfaces are drawn nearest
+	   first with depth writes, and the rest farthest first over them, which looks the same as drawing everything in order
+	   Frames blending with anything but 'GL_SRC_ALPHA' or 'GL_ONE' over 'GL_ONE_MINUS_SRC_ALPHA' are drawn in order regardless
+	   Depths reach the surfaces through the model-view matrix 'DrawSurface' is given, which the Benchmark project's '--check' verifies
+	*/
+	void SetDepthPass(const bool ac_bEnabled);
+	// - Whether the depth pass is on
+	bool IsDepthPass();
+
+	// - Turns culling surfaces outside each camera on or off. It is on by default. Off, every surface of a camera's world space is drawn
+	void SetCulling(const bool ac_bEnabled);
+	// - Whether surfaces outside each camera are culled
+	bool IsCulling();
+	/* - Whether 'DrawCameras' draws a surface through the camera at 'ac_uiCamera' in 'voCameras'. It has to be active, in the camera's
+	   world space and land inside the camera. The Benchmark project's '--check' run compares this with what 'DrawSurface' draws
+	*/
+	bool IsSurfaceInCamera(const SurfaceUnion& ac_Surface, const unsigned int ac_uiCamera);
+}
+
+#endif // _RENDERPASS_H_
@@ -0,0 +1,285 @@
+#define _CRT_SECURE_NO_WARNINGS // Allows 'fopen' with Visual Studio's SDL checks turned on
+
+#include "Replay.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	const Uint16 kuiEnd = SDL_FIRSTEVENT; // The type of the record that ends a log
+
+	// Every event begins with its type and timestamp, which the record already holds
+	const size_t kuiEventStart = sizeof(Uint32) * 2;
+
+	FILE* pRecording = nullptr;
+	Uint64 uiRecordStart = 0; // 'SDL_GetPerformanceCounter' when recording started
+
+	std::vector<Uint8> vReplay; // The whole log being played back
+	size_t uiCursor = 0;		// The next record to play back
+	unsigned int uiReplayFrames = 0;
+	Uint64 uiReplayStart = 0; // 'SDL_GetPerformanceCounter' when playback started
+	Uint32 uiReplayStartMilliseconds = 0; // 'SDL_GetTicks' when playback started
+	bool bReplaying = false;
+	bool bReplayFinished = false;
+
+	unsigned int uiFrame = 0;
+
+	/* - Returns how many bytes of an event type are worth keeping, counting its type and timestamp
+	   0 means the type can't be recorded, because it holds a pointer or only means something to the process that got it
+	*/
+	size_t EventSize(const Uint32 ac_uiType)
+	{
+		switch (ac_uiType)
+		{
+		case SDL_QUIT: return sizeof(SDL_QuitEvent);
+		case SDL_WINDOWEVENT: return sizeof(SDL_WindowEvent);
+
+		case SDL_KEYDOWN:
+		case SDL_KEYUP: return sizeof(SDL_KeyboardEvent);
+		case SDL_TEXTEDITING: return sizeof(SDL_TextEditingEvent);
+		case SDL_TEXTINPUT: return sizeof(SDL_TextInputEvent);
+
+		case SDL_MOUSEMOTION: return sizeof(SDL_MouseMotionEvent);
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP: return sizeof(SDL_MouseButtonEvent);
+		case SDL_MOUSEWHEEL: return sizeof(SDL_MouseWheelEvent);
+
+		case SDL_JOYAXISMOTION: return sizeof(SDL_JoyAxisEvent);
+		case SDL_JOYBALLMOTION: return sizeof(SDL_JoyBallEvent);
+		case SDL_JOYHATMOTION: return sizeof(SDL_JoyHatEvent);
+		case SDL_JOYBUTTONDOWN:
+		case SDL_JOYBUTTONUP: return sizeof(SDL_JoyButtonEvent);
+		case SDL_JOYDEVICEADDED:
+		case SDL_JOYDEVICEREMOVED: return sizeof(SDL_JoyDeviceEvent);
+
+		case SDL_CONTROLLERAXISMOTION: return sizeof(SDL_ControllerAxisEvent);
+		case SDL_CONTROLLERBUTTONDOWN:
+		case SDL_CONTROLLERBUTTONUP: return sizeof(SDL_ControllerButtonEvent);
+		case SDL_CONTROLLERDEVICEADDED:
+		case SDL_CONTROLLERDEVICEREMOVED:
+		case SDL_CONTROLLERDEVICEREMAPPED: return sizeof(SDL_ControllerDeviceEvent);
+
+		case SDL_FINGERDOWN:
+		case SDL_FINGERUP:
+		case SDL_FINGERMOTION: return sizeof(SDL_TouchFingerEvent);
+		case SDL_DOLLARGESTURE:
+		case SDL_DOLLARRECORD: return sizeof(SDL_DollarGestureEvent);
+		case SDL_MULTIGESTURE: return sizeof(SDL_MultiGestureEvent);
+
+		default: return 0;
+		}
+	}
+
+	Uint32 Milliseconds(const Uint64 ac_uiTicks)
+	{
+		return (Uint32)(ac_uiTicks * 1000 / SDL_GetPerformanceFrequency());
+	}
+
+	void Write(const Uint32 ac_uiTime, const Uint16 ac_uiType, const void* ac_pData, const Uint16 ac_uiSize)
+	{
+		const Replay::LogRecord record = { uiFrame, ac_uiTime, ac_uiType, ac_uiSize };
+		fwrite(&record, sizeof(record), 1, pRecording);
+		fwrite(ac_pData, 1, ac_uiSize, pRecording);
+	}
+
+	void Record(const Input::Event& ac_Event)
+	{
+		const size_t uiSize = EventSize(ac_Event.sdlEvent.type);
+		if (uiSize == 0)
+			return;
+
+		// Events queued before recording started are stamped as happening at the start
+		const Uint32 uiTime = ac_Event.uiTicks > uiRecordStart ? Milliseconds(ac_Event.uiTicks - uiRecordStart) : 0;
+
+		Write(uiTime, (Uint16)ac_Event.sdlEvent.type, (const Uint8*)&ac_Event.sdlEvent + kuiEventStart, (Uint16)(uiSize - kuiEventStart));
+	}
+
+	// - Adds every recorded event of the current frame to 'a_vEvents'
+	void Play(std::vector<Input::Event>& a_vEvents)
+	{
+		while (uiCursor + sizeof(Replay::LogRecord) <= vReplay.size())
+		{
+			Replay::LogRecord record;
+			memcpy(&record, &vReplay[uiCursor], sizeof(record));
+			if (record.uiFrame > uiFrame)
+				return;
+
+			if (record.uiType == kuiEnd)
+			{
+				bReplaying = false;
+				bReplayFinished = true;
+				return;
+			}
+
+			uiCursor += sizeof(record);
+
+			Input::Event event;
+			memset(&event.sdlEvent, 0, sizeof(event.sdlEvent));
+			event.sdlEvent.type = record.uiType;
+			memcpy((Uint8*)&event.sdlEvent + kuiEventStart, &vReplay[uiCursor], record.uiSize);
+			uiCursor += record.uiSize;
+
+			// Played back events keep the spacing they were recorded with
+			event.uiTicks = uiReplayStart + record.uiTime * SDL_GetPerformanceFrequency() / 1000;
+			event.sdlEvent.common.timestamp = uiReplayStartMilliseconds + record.uiTime;
+
+			a_vEvents.push_back(event);
+		}
+
+		// A log cut short, such as by a crash while recording, ends wherever its records do
+		bReplaying = false;
+		bReplayFinished = true;
+	}
+
+	// - Checks every record of a loaded log fits inside it and has a size its type allows, and finds how many frames it lasts
+	bool Validate()
+	{
+		Replay::LogHeader header;
+		if (vReplay.size() < sizeof(header))
+			return false;
+		memcpy(&header, vReplay.data(), sizeof(header));
+		if (memcmp(header.aMagic, Replay::kaMagic, sizeof(header.aMagic)) != 0 || header.uiVersion != Replay::kuiVersion)
+			return false;
+
+		uiReplayFrames = 0;
+		for (size_t uiOffset = sizeof(header); uiOffset + sizeof(Replay::LogRecord) <= vReplay.size();)
+		{
+			Replay::LogRecord record;
+			memcpy(&record, &vReplay[uiOffset], sizeof(record));
+
+			const size_t uiSize = EventSize(record.uiType);
+			if (record.uiType != kuiEnd && (uiSize == 0 || record.uiSize != uiSize - kuiEventStart))
+				return false;
+			if (uiOffset + sizeof(record) + record.uiSize > vReplay.size())
+				return false;
+
+			uiReplayFrames = record.uiType == kuiEnd ? record.uiFrame : record.uiFrame + 1;
+			uiOffset += sizeof(record) + record.uiSize;
+		}
+
+		return true;
+	}
+}
+
+bool Replay::StartRecording(const char* ac_szFilename)
+{
+	// Recording what is being played back would only copy the log, and the keys that start recording would be played back too
+	if (pRecording != nullptr || bReplaying)
+		return false;
+
+	pRecording = fopen(ac_szFilename, "wb");
+	if (pRecording == NULL)
+	{
+		printf("Replay: Could not open '%s' for writing\n", ac_szFilename);
+		pRecording = nullptr;
+		return false;
+	}
+
+	LogHeader header;
+	memcpy(header.aMagic, kaMagic, sizeof(kaMagic));
+	header.uiVersion = kuiVersion;
+	fwrite(&header, sizeof(header), 1, pRecording);
+
+	uiRecordStart = SDL_GetPerformanceCounter();
+	uiFrame = 0;
+
+	return true;
+}
+void Replay::StopRecording()
+{
+	if (pRecording == nullptr)
+		return;
+
+	Write(Milliseconds(SDL_GetPerformanceCounter() - uiRecordStart), kuiEnd, nullptr, 0);
+
+	fclose(pRecording);
+	pRecording = nullptr;
+}
+bool Replay::IsRecording()
+{
+	return pRecording != nullptr;
+}
+
+bool Replay::StartReplay(const char* ac_szFilename)
+{
+	StopRecording();
+
+	FILE* pFile = fopen(ac_szFilename, "rb");
+	if (pFile == NULL)
+	{
+		printf("Replay: Could not open '%s'\n", ac_szFilename);
+		return false;
+	}
+
+	fseek(pFile, 0, SEEK_END);
+	vReplay.resize((size_t)ftell(pFile));
+	fseek(pFile, 0, SEEK_SET);
+	const size_t uiRead = fread(vReplay.data(), 1, vReplay.size(), pFile);
+	fclose(pFile);
+
+	if (uiRead != vReplay.size() || !Validate())
+	{
+		printf("Replay: '%s' is not a replay this version can play\n", ac_szFilename);
+		vReplay.clear();
+		return false;
+	}
+
+	uiCursor = sizeof(LogHeader);
+	uiReplayStart = SDL_GetPerformanceCounter();
+	uiReplayStartMilliseconds = SDL_GetTicks();
+	uiFrame = 0;
+	bReplaying = true;
+	bReplayFinished = false;
+
+	return true;
+}
+void Replay::StopReplay()
+{
+	bReplaying = false;
+	vReplay.clear();
+}
+bool Replay::IsReplaying()
+{
+	return bReplaying;
+}
+bool Replay::IsReplayFinished()
+{
+	return bReplayFinished;
+}
+
+unsigned int Replay::GetReplayFrames()
+{
+	return uiReplayFrames;
+}
+unsigned int Replay::GetFrame()
+{
+	return uiFrame;
+}
+
+void Replay::Pump(std::vector<Input::Event>& a_vEvents)
+{
+	if (!bReplaying && pRecording == nullptr)
+		return;
+
+	if (bReplaying)
+	{
+		// Only closing the window gets through from the user, so a replay can still be stopped
+		size_t uiKept = 0;
+		for (size_t i = 0; i < a_vEvents.size(); ++i)
+		{
+			if (a_vEvents[i].sdlEvent.type == SDL_QUIT)
+				a_vEvents[uiKept++] = a_vEvents[i];
+		}
+		a_vEvents.resize(uiKept);
+
+		Play(a_vEvents);
+	}
+	else
+	{
+		for (size_t i = 0; i < a_vEvents.size(); ++i)
+			Record(a_vEvents[i]);
+	}
+
+	++uiFrame;
+}
@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////
+// File: Replay.h
+// Author: Ben Odom
+// Brief: Records every event 'OnEvent' is given to a small
+//		  binary log, and plays a log back by handing
+//		  'GameLoop' the same events on the same frames they
+//		  were recorded on. A scene that only depends on its
+//		  input and frame count then plays out identically,
+//		  so one session can be timed on every engine build
+//////////////////////////////////////////////////////////////
+
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+
+#include "Input.h"
+
+#include <vector>
+
+namespace Replay
+{
+	const char kaMagic[4] = { 'S', 'G', 'E', 'R' };
+	const Uint32 kuiVersion = 1;
+
+	// The start of every log
+	struct LogHeader
+	{
+		char aMagic[4];
+		Uint32 uiVersion;
+	};
+	/* One recorded event. 'uiSize' bytes of the event follow it, starting after its type and timestamp
+	   A record with the type 'SDL_FIRSTEVENT' and no bytes marks the frame recording stopped on
+	*/
+	struct LogRecord
+	{
+		Uint32 uiFrame;	 // Frames since recording started
+		Uint32 uiTime;	 // Milliseconds since recording started
+		Uint16 uiType;
+		Uint16 uiSize;
+	};
+
+	/* - Starts writing every event dispatched from the next frame on to 'ac_szFilename'
+	   Events holding pointers, such as dropped files and user events, can't be played back and are left out
+	*/
+	bool StartRecording(const char* ac_szFilename);
+	// - Marks the end of the log and closes it. Does nothing if nothing is being recorded
+	void StopRecording();
+	// - Whether events are currently being recorded
+	bool IsRecording();
+
+	// - Loads a log to play back from the next frame on. Live input is ignored while it plays, apart from closing the window
+	bool StartReplay(const char* ac_szFilename);
+	// - Stops playing back and goes back to live input
+	void StopReplay();
+	// - Whether a log is currently being played back
+	bool IsReplaying();
+	// - Whether the last log played back has reached the frame its recording stopped on
+	bool IsReplayFinished();
+
+	// - How many frames the log being played back lasts
+	unsigned int GetReplayFrames();
+	// - How many frames have passed since recording or playback started
+	unsigned int GetFrame();
+
+	/* - Records this frame's events, or replaces them with the recorded ones while a log is playing back
+	   'GameLoop' calls it once a frame, after polling and before anything is dispatched
+	*/
+	void Pump(std::vector<Input::Event>& a_vEvents);
+}
+
+#endif // _REPLAY_H_
@@ -4,6 +4,11 @@
 //////////////////////////////////////////////////////////////
 
 #include "GameLoop.h"
+#include "CounterExport.h"
+#include "PackFile.h"
+#include "Present.h"
+#include "Replay.h"
+#include "SurfaceLoader.h"
 
 int wmain()
 {
@@ -11,10 +16,18 @@ int wmain()
 
 	Graphics::NewWindow({ 1600, 900 }, false, { 1600, 900 }, "Graphics Engine");
 
+	CounterExport::Open(); // So 'PerfViewer' can watch the game by its process ID
+
 	GameLoop oGameLoop;
 
 	oGameLoop.Loop();
 
+	Replay::StopRecording(); // Ends the log if the game was closed while recording
+
+	Graphics::StopPresentThreads();
+	Graphics::StopSurfaceLoader();
+	Graphics::CloseAssetPacks();
+	CounterExport::Close();
 	Graphics::Quit();
 
 	return 0;
@@ -0,0 +1,429 @@
+#include "SurfaceLoader.h"
+#include "PixelBuffer.h"
+#include "Profiler.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace
+{
+	const unsigned int kuiStripBytes = 256 * 1024; // Roughly how much is uploaded between checks of the budget
+
+	// One image on its way from a file to a texture
+	struct Job
+	{
+		Graphics::SurfaceUnion Target;
+		std::string sKey; // Where the texture goes in the 'TextureCache'
+		std::string sFilename;
+
+		SDL_Surface* sdlSurface; // Decoded RGBA pixels, or nullptr if the file couldn't be read
+		SDL_Surface* sdlPacked;	 // Wraps the pixels of an asset pack that still need converting, or nullptr
+		bool bPacked;			 // 'sdlSurface' wraps an asset pack, so its pixels outlive the job
+		bool bMipmaps;			 // Whether a mip chain is built, decided when the job is queued
+		bool bPremultiply;		 // Whether alpha is premultiplied, decided when the job is queued since it is part of 'sKey'
+		bool bOpaque;			 // Whether every decoded pixel has an alpha of 255
+		Graphics::Mipmap::Chain Mips;
+		GLuint uiTexture;		 // Created when the first strip is uploaded
+		int iRowsUploaded;
+	};
+
+	struct Loader
+	{
+		std::mutex Mutex;
+		std::condition_variable WorkReady; // Signalled when a job is queued or the threads should stop
+		std::condition_variable JobDecoded;
+
+		std::deque<Job*> Queued;  // Waiting to be decoded
+		std::deque<Job*> Decoded; // Waiting to be uploaded. The front one may be partly uploaded
+		unsigned int uiDecoding;  // Jobs a thread has taken but not finished decoding
+
+		std::unordered_set<const void*> Loading; // Every surface that is still showing the placeholder
+
+		std::vector<std::thread> vThreads;
+		bool bStopping;
+
+		GLuint uiPlaceholder;
+	};
+
+	Loader& GetLoader()
+	{
+		static Loader loader;
+
+		return loader;
+	}
+
+	// - The surface a job fills in, read through the member 'Tag' says is set. It is the key 'Loader::Loading' keeps
+	const void* GetSurface(const Graphics::SurfaceUnion& ac_Target)
+	{
+		if (ac_Target.Tag == Graphics::SurfaceUnion::FLOAT)
+			return ac_Target.fGLSurface;
+		return ac_Target.iGLSurface;
+	}
+
+	// - Reads the file and converts it to the byte order 'glTexImage2D' is given, off the thread that draws
+	void Decode(Job& a_Job)
+	{
+		PROFILE_ZONE("Decode Surface");
+
+		a_Job.sdlSurface = nullptr;
+
+		SDL_Surface* sdlLoaded = a_Job.sdlPacked != nullptr ? a_Job.sdlPacked : IMG_Load(a_Job.sFilename.c_str());
+		a_Job.sdlPacked = nullptr;
+		if (sdlLoaded == NULL)
+		{
+			printf("SDL_Error: %s\n", SDL_GetError());
+			return;
+		}
+
+		// Whatever format the file decoded to, the result is R, G, B, A in memory, which is what GL_RGBA with GL_UNSIGNED_BYTE reads
+		a_Job.sdlSurface = Graphics::ConvertSurface(*sdlLoaded, a_Job.bPremultiply);
+		if (a_Job.sdlSurface == nullptr)
+			printf("SDL_Error: %s\n", SDL_GetError());
+		SDL_FreeSurface(sdlLoaded);
+
+		// Every pixel is read to find out, which is better done here than on the thread that draws
+		if (a_Job.sdlSurface != nullptr)
+			a_Job.bOpaque = Graphics::PixelConvert::IsOpaque(a_Job.sdlSurface->pixels, a_Job.sdlSurface->w, a_Job.sdlSurface->h, a_Job.sdlSurface->pitch);
+
+		// The chain is the slow part of mipmapping, so it is built here and only uploaded on the thread that draws
+		if (a_Job.sdlSurface != nullptr && a_Job.bMipmaps)
+		{
+			const System::Size2D<int> Size = { a_Job.sdlSurface->w, a_Job.sdlSurface->h };
+			Graphics::Mipmap::Build(a_Job.sdlSurface->pixels, Size, a_Job.sdlSurface->pitch, a_Job.Mips);
+		}
+	}
+
+	// - Takes a queued job and decodes it. Returns false if there was nothing to take. 'a_Lock' is held on entry and exit
+	bool DecodeNext(Loader& a_Loader, std::unique_lock<std::mutex>& a_Lock)
+	{
+		if (a_Loader.Queued.empty())
+			return false;
+
+		Job* pJob = a_Loader.Queued.front();
+		a_Loader.Queued.pop_front();
+		++a_Loader.uiDecoding;
+
+		a_Lock.unlock();
+		Decode(*pJob);
+		a_Lock.lock();
+
+		a_Loader.Decoded.push_back(pJob);
+		--a_Loader.uiDecoding;
+		a_Loader.JobDecoded.notify_all();
+
+		return true;
+	}
+
+	void DecodeThread()
+	{
+		Profiler::NameThread("Surface Loader");
+
+		Loader& loader = GetLoader();
+		std::unique_lock<std::mutex> Lock(loader.Mutex);
+		while (!loader.bStopping)
+		{
+			if (!DecodeNext(loader, Lock))
+				loader.WorkReady.wait(Lock);
+		}
+	}
+
+	// - Points the surface at its real texture and gives it the image's size
+	template <typename T>
+	void Finish(Graphics::GLSurface<T>& a_glSurface, const Job& ac_Job)
+	{
+		Graphics::TextureCache::Release(a_glSurface.Surface); // The placeholder
+		a_glSurface.Surface = ac_Job.uiTexture;
+
+		a_glSurface.Dimensions.W = (T)ac_Job.sdlSurface->w;
+		a_glSurface.Dimensions.H = (T)ac_Job.sdlSurface->h;
+
+		a_glSurface.Center.X = a_glSurface.Dimensions.W / (T)2;
+		a_glSurface.Center.Y = a_glSurface.Dimensions.H / (T)2;
+
+		a_glSurface.OffsetD = a_glSurface.Dimensions;
+	}
+
+	// - Uploads the next strip of rows of 'a_Job'. Returns true once the whole image is uploaded
+	bool UploadStrip(Job& a_Job)
+	{
+		SDL_Surface& sdlSurface = *a_Job.sdlSurface;
+
+		if (a_Job.uiTexture == 0)
+		{
+			glGenTextures(1, &a_Job.uiTexture);
+			Graphics::GLState::BindTexture(a_Job.uiTexture);
+			Graphics::Mipmap::ApplyFilter(Graphics::GetDefaultFilter(), false);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sdlSurface.w, sdlSurface.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		}
+		else
+		{
+			Graphics::GLState::BindTexture(a_Job.uiTexture);
+		}
+
+		const int iRows = std::min(std::max((int)(kuiStripBytes / sdlSurface.pitch), 1), sdlSurface.h - a_Job.iRowsUploaded);
+		const Uint8* pRows = (const Uint8*)sdlSurface.pixels + a_Job.iRowsUploaded * sdlSurface.pitch;
+
+		// A pixel buffer lets the driver transfer the strip while the GPU works, otherwise it is copied out of the surface before returning
+		if (!Graphics::PixelBuffer::TexSubImage(a_Job.iRowsUploaded, sdlSurface.w, iRows, pRows, sdlSurface.pitch))
+		{
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, sdlSurface.pitch / 4);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, a_Job.iRowsUploaded, sdlSurface.w, iRows, GL_RGBA, GL_UNSIGNED_BYTE, pRows);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		}
+
+		Graphics::Stats::AddTextureUpload(sdlSurface.w * iRows * 4);
+		Graphics::GLState::TextureUploaded();
+
+		a_Job.iRowsUploaded += iRows;
+		return a_Job.iRowsUploaded >= sdlSurface.h;
+	}
+
+	// - Uploads decoded jobs until 'ac_uiBudgetTicks' have passed, or until everything is uploaded if it is 0
+	void Upload(const Uint64 ac_uiBudgetTicks)
+	{
+		PROFILE_ZONE("Upload Surfaces");
+
+		Loader& loader = GetLoader();
+		const Uint64 uiBegin = SDL_GetPerformanceCounter();
+
+		std::unique_lock<std::mutex> Lock(loader.Mutex);
+		while (!loader.Decoded.empty())
+		{
+			// Only this thread removes from 'Decoded', so the front job can be worked on without the lock
+			Job* pJob = loader.Decoded.front();
+			Lock.unlock();
+
+			bool bDone = true;
+			if (pJob->sdlSurface != nullptr)
+			{
+				// With a texture budget nothing is uploaded until it is drawn, so the pixels are only handed over
+				if (Graphics::IsResidencyManaged() && pJob->uiTexture == 0)
+				{
+					const System::Size2D<int> Size = { pJob->sdlSurface->w, pJob->sdlSurface->h };
+					pJob->uiTexture = Graphics::UploadTexture(pJob->sdlSurface->pixels, Size, pJob->bPacked);
+				}
+				else
+				{
+					bDone = UploadStrip(*pJob);
+				}
+
+				if (bDone)
+				{
+					// Level 0 went up a strip at a time, the rest of the chain is small enough to go up at once
+					if (!pJob->Mips.vPixels.empty())
+						Graphics::Mipmap::Attach(pJob->uiTexture, pJob->Mips, true);
+
+					// Strips don't go through 'UploadTexture', so what it would have recorded is recorded here
+					Graphics::TextureCache::SetOpaque(pJob->uiTexture, pJob->bOpaque);
+
+					// If the same file finished loading first for another surface, that texture is used and this one deleted
+					const System::Size2D<int> Size = { pJob->sdlSurface->w, pJob->sdlSurface->h };
+					pJob->uiTexture = Graphics::TextureCache::Insert(pJob->sKey, pJob->uiTexture, Size);
+
+					if (pJob->Target.Tag == Graphics::SurfaceUnion::FLOAT)
+						Finish(*pJob->Target.fGLSurface, *pJob);
+					else
+						Finish(*pJob->Target.iGLSurface, *pJob);
+
+					SDL_FreeSurface(pJob->sdlSurface);
+				}
+			}
+
+			Lock.lock();
+			if (bDone)
+			{
+				// A surface that failed to load keeps the placeholder, the same way 'LoadSurface' would have returned nothing
+				loader.Loading.erase(GetSurface(pJob->Target));
+				loader.Decoded.pop_front();
+				delete pJob;
+			}
+
+			if (ac_uiBudgetTicks != 0 && SDL_GetPerformanceCounter() - uiBegin >= ac_uiBudgetTicks)
+				break;
+		}
+	}
+}
+
+void Graphics::StartSurfaceLoader(const unsigned int ac_uiThreads)
+{
+	Loader& loader = GetLoader();
+	std::lock_guard<std::mutex> Lock(loader.Mutex);
+	if (!loader.vThreads.empty())
+		return;
+
+	const unsigned int uiThreads = ac_uiThreads != 0 ? ac_uiThreads : (unsigned int)std::max(SDL_GetCPUCount() - 1, 1);
+
+	loader.bStopping = false;
+	for (unsigned int i = 0; i < uiThreads; ++i)
+		loader.vThreads.push_back(std::thread(DecodeThread));
+}
+void Graphics::StopSurfaceLoader()
+{
+	Loader& loader = GetLoader();
+	{
+		std::lock_guard<std::mutex> Lock(loader.Mutex);
+		loader.bStopping = true;
+	}
+	loader.WorkReady.notify_all();
+
+	for (unsigned int i = 0; i < loader.vThreads.size(); ++i)
+		loader.vThreads[i].join();
+	loader.vThreads.clear();
+
+	// Nothing is running now, so what is left can be thrown away without the lock
+	for (unsigned int i = 0; i < loader.Queued.size(); ++i)
+	{
+		SDL_FreeSurface(loader.Queued[i]->sdlPacked);
+		delete loader.Queued[i];
+	}
+	for (unsigned int i = 0; i < loader.Decoded.size(); ++i)
+	{
+		if (loader.Decoded[i]->uiTexture != 0)
+		{
+			GLState::ForgetTexture(loader.Decoded[i]->uiTexture);
+			glDeleteTextures(1, &loader.Decoded[i]->uiTexture);
+		}
+		SDL_FreeSurface(loader.Decoded[i]->sdlSurface);
+		delete loader.Decoded[i];
+	}
+	loader.Queued.clear();
+	loader.Decoded.clear();
+	loader.Loading.clear();
+
+	PixelBuffer::Destroy();
+}
+
+void Graphics::UpdateSurfaceLoader(const double ac_dBudgetMilliseconds)
+{
+	// A budget of 0 still uploads a strip, so it is rounded up to a single tick
+	const Uint64 uiBudgetTicks = std::max((Uint64)(ac_dBudgetMilliseconds * SDL_GetPerformanceFrequency() / 1000.0), (Uint64)1);
+
+	Upload(uiBudgetTicks);
+}
+void Graphics::FinishSurfaceLoader()
+{
+	PROFILE_ZONE("Finish Surface Loader");
+
+	Loader& loader = GetLoader();
+	{
+		// This thread decodes alongside the pool rather than sitting idle
+		std::unique_lock<std::mutex> Lock(loader.Mutex);
+		while (DecodeNext(loader, Lock) || loader.uiDecoding != 0)
+		{
+			if (loader.Queued.empty() && loader.uiDecoding != 0)
+				loader.JobDecoded.wait(Lock);
+		}
+	}
+
+	Upload(0);
+}
+
+unsigned int Graphics::GetLoadingSurfaces()
+{
+	Loader& loader = GetLoader();
+	std::lock_guard<std::mutex> Lock(loader.Mutex);
+
+	return (unsigned int)loader.Loading.size();
+}
+bool Graphics::IsSurfaceLoading(const GLSurface<int>* ac_pglSurface)
+{
+	Loader& loader = GetLoader();
+	std::lock_guard<std::mutex> Lock(loader.Mutex);
+
+	return loader.Loading.count(ac_pglSurface) != 0;
+}
+bool Graphics::IsSurfaceLoading(const GLSurface<float>* ac_pglSurface)
+{
+	Loader& loader = GetLoader();
+	std::lock_guard<std::mutex> Lock(loader.Mutex);
+
+	return loader.Loading.count(ac_pglSurface) != 0;
+}
+
+GLuint Graphics::SurfaceLoader::PlaceholderTexture()
+{
+	// The placeholder sits in the 'TextureCache' like any other texture, with one reference the loader never gives up
+	Loader& loader = GetLoader();
+	if (loader.uiPlaceholder != 0)
+	{
+		TextureCache::AddReference(loader.uiPlaceholder);
+		return loader.uiPlaceholder;
+	}
+
+	// A magenta and black checker board, which is hard to mistake for real art
+	const Uint32 auiPixels[4] = { 0xFFFF00FF, 0xFF000000, 0xFF000000, 0xFFFF00FF };
+
+	glGenTextures(1, &loader.uiPlaceholder);
+	GLState::BindTexture(loader.uiPlaceholder);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, auiPixels);
+	Stats::AddTextureUpload(2 * 2 * 4);
+	GLState::TextureUploaded();
+	TextureCache::SetOpaque(loader.uiPlaceholder, true);
+
+	const System::Size2D<int> Size = { 2, 2 };
+	TextureCache::Insert("#placeholder", loader.uiPlaceholder, Size);
+	TextureCache::AddReference(loader.uiPlaceholder);
+
+	return loader.uiPlaceholder;
+}
+
+void Graphics::SurfaceLoader::Queue(const SurfaceUnion& ac_Target, const std::string& ac_sKey, const char* ac_szFilename)
+{
+	Job* pJob = new Job;
+	pJob->Target = ac_Target;
+	pJob->sKey = ac_sKey;
+	pJob->sFilename = ac_szFilename;
+	pJob->sdlSurface = nullptr;
+	pJob->sdlPacked = nullptr;
+	pJob->bPacked = false;
+	pJob->bMipmaps = AreMipmapsEnabled() && !IsResidencyManaged(); // A managed texture builds its chain each time it is uploaded
+	pJob->bPremultiply = IsPremultipliedAlpha();
+	pJob->uiTexture = 0;
+	pJob->bOpaque = false;
+	pJob->iRowsUploaded = 0;
+
+	// An image in an asset pack is already decoded, so it skips the decode threads and waits for upload straight away
+	// The surface only wraps the mapped pixels, so freeing it after the upload leaves the pack alone
+	AssetPack::PackedImage packedImage;
+	if (AssetPack::Find(TextureCache::NormalizePath(ac_szFilename), packedImage))
+	{
+		SDL_Surface* sdlPacked = SDL_CreateRGBSurfaceFrom((void*)packedImage.pPixels, packedImage.Size.W, packedImage.Size.H, 32, packedImage.Size.W * 4,
+			0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+
+		// Packs hold straight alpha and no mips, so premultiplying or building a chain still needs the decode threads
+		if (pJob->bPremultiply || pJob->bMipmaps)
+			pJob->sdlPacked = sdlPacked;
+		else
+			pJob->sdlSurface = sdlPacked;
+		pJob->bPacked = pJob->sdlSurface != nullptr;
+
+		// Skipping the decode threads skips the alpha check they do as well
+		if (pJob->bPacked)
+			pJob->bOpaque = PixelConvert::IsOpaque(packedImage.pPixels, packedImage.Size.W, packedImage.Size.H, packedImage.Size.W * 4);
+	}
+
+	if (pJob->sdlSurface != nullptr)
+	{
+		Loader& loader = GetLoader();
+		std::lock_guard<std::mutex> Lock(loader.Mutex);
+		loader.Decoded.push_back(pJob);
+		loader.Loading.insert(GetSurface(ac_Target));
+
+		return;
+	}
+
+	StartSurfaceLoader();
+
+	Loader& loader = GetLoader();
+	{
+		std::lock_guard<std::mutex> Lock(loader.Mutex);
+		loader.Queued.push_back(pJob);
+		loader.Loading.insert(GetSurface(ac_Target));
+	}
+	loader.WorkReady.notify_one();
+}
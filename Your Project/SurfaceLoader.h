@@ -0,0 +1,155 @@
+//////////////////////////////////////////////////////////////
+// File: SurfaceLoader.h
+// Author: Ben Odom
+// Brief: Loads 'GLSurface's without stalling the game.
+//		  Images are decoded by a pool of threads, and the
+//		  thread that draws uploads the finished ones a strip
+//		  at a time within a budget each frame, through a
+//		  pixel buffer object when the driver has them. Until
+//		  then the surface shows a placeholder texture
+//////////////////////////////////////////////////////////////
+
+#ifndef _SURFACELOADER_H_
+#define _SURFACELOADER_H_
+
+#include "Graphics.h"
+
+#include <fstream>
+#include <string>
+
+namespace Graphics
+{
+	// - Starts the decode threads. 0 starts one per core, leaving one for the game
+	//   Called automatically by the first 'LoadSurfaceAsync' if it hasn't been already
+	void StartSurfaceLoader(const unsigned int ac_uiThreads = 0);
+	// - Finishes any image being decoded, forgets the rest and stops the decode threads. Call before 'Quit'
+	void StopSurfaceLoader();
+
+	// - Uploads decoded images to OpenGL for up to 'ac_dBudgetMilliseconds'. Call once a frame on the thread that draws
+	//   Always uploads at least one strip, so loading keeps moving even with a budget of 0
+	void UpdateSurfaceLoader(const double ac_dBudgetMilliseconds = 2.0);
+	// - Decodes everything queued using every thread, including this one, then uploads it all without a budget
+	void FinishSurfaceLoader();
+
+	// - Returns how many surfaces are still waiting to be decoded or uploaded
+	unsigned int GetLoadingSurfaces();
+	// - Whether or not a surface from 'LoadSurfaceAsync' is still showing the placeholder
+	bool IsSurfaceLoading(const GLSurface<int>* ac_pglSurface);
+	bool IsSurfaceLoading(const GLSurface<float>* ac_pglSurface);
+
+	/* - Creates a 'GLSurface' that shows a placeholder texture and queues 'ac_szFilename' to be decoded in the background
+	   The surface is pushed and usable straight away. Its texture and dimensions change once the image is uploaded
+	   It must not be deleted while 'IsSurfaceLoading' returns true
+	*/
+	template <typename T = float>
+	GLSurface<T>* LoadSurfaceAsync(const char* ac_szFilename);
+
+	/* - Loads every image listed in a manifest, one file name per line, and waits until they are all uploaded
+	   Blank lines and lines starting with '#' are skipped. Every core decodes at once, so this is the quickest way
+	   to load a level up front
+	*/
+	template <typename T = float>
+	std::vector<GLSurface<T>*> PreloadManifest(const char* ac_szManifest);
+
+	namespace SurfaceLoader
+	{
+		const System::Size2D<int> kPlaceholderSize = { 32, 32 }; // What a surface measures until its image is uploaded
+
+		// - Wraps a surface in a 'SurfaceUnion' so the loader can fill in either type
+		SurfaceUnion Target(GLSurface<int>* a_pglSurface);
+		SurfaceUnion Target(GLSurface<float>* a_pglSurface);
+
+		// - Creates and pushes a surface showing the placeholder and queues its image, without sorting 'vglSurfaces'
+		template <typename T>
+		GLSurface<T>* NewSurface(const char* ac_szFilename);
+
+		// - Returns the placeholder texture with one more 'TextureCache' reference, creating it the first time
+		GLuint PlaceholderTexture();
+		// - Queues 'ac_szFilename' to be decoded and then uploaded into 'ac_Target' and the 'TextureCache' under 'ac_sKey'
+		//   Images found in an open asset pack are only uploaded
+		void Queue(const SurfaceUnion& ac_Target, const std::string& ac_sKey, const char* ac_szFilename);
+	}
+}
+
+namespace Graphics
+{
+	inline SurfaceUnion SurfaceLoader::Target(GLSurface<int>* a_pglSurface)
+	{
+		SurfaceUnion target;
+		target.Tag = SurfaceUnion::INT;
+		target.iGLSurface = a_pglSurface;
+
+		return target;
+	}
+	inline SurfaceUnion SurfaceLoader::Target(GLSurface<float>* a_pglSurface)
+	{
+		SurfaceUnion target;
+		target.Tag = SurfaceUnion::FLOAT;
+		target.fGLSurface = a_pglSurface;
+
+		return target;
+	}
+
+	template <typename T>
+	GLSurface<T>* SurfaceLoader::NewSurface(const char* ac_szFilename)
+	{
+		// A file that is already loaded needs no decoding, so its surface is ready straight away
+		const std::string sKey = TextureCache::PathKey(TextureCache::NormalizePath(ac_szFilename), IsPremultipliedAlpha());
+
+		System::Size2D<int> Size;
+		const GLuint uiTexture = TextureCache::Acquire(sKey, Size);
+		if (uiTexture != 0)
+			return Graphics::NewSurface<T>(uiTexture, Size);
+
+		GLSurface<T>* glSurface = Graphics::NewSurface<T>(PlaceholderTexture(), kPlaceholderSize);
+		Queue(Target(glSurface), sKey, ac_szFilename);
+
+		return glSurface;
+	}
+
+	template <typename T>
+	GLSurface<T>* LoadSurfaceAsync(const char* ac_szFilename)
+	{
+		GLSurface<T>* glSurface = SurfaceLoader::NewSurface<T>(ac_szFilename);
+
+		std::sort(vglSurfaces.begin(), vglSurfaces.end(), SortCamera);
+		std::sort(vglSurfaces.begin(), vglSurfaces.end(), SortLayer);
+
+		return glSurface;
+	}
+
+	template <typename T>
+	std::vector<GLSurface<T>*> PreloadManifest(const char* ac_szManifest)
+	{
+		std::vector<GLSurface<T>*> vglLoaded;
+
+		std::ifstream Manifest(ac_szManifest);
+		if (!Manifest.is_open())
+		{
+			printf("SurfaceLoader: Could not open manifest '%s'\n", ac_szManifest);
+			return vglLoaded;
+		}
+
+		std::string sLine;
+		while (std::getline(Manifest, sLine))
+		{
+			// Windows line endings leave a '\r' behind
+			if (!sLine.empty() && sLine.back() == '\r')
+				sLine.pop_back();
+			if (sLine.empty() || sLine[0] == '#')
+				continue;
+
+			vglLoaded.push_back(SurfaceLoader::NewSurface<T>(sLine.c_str()));
+		}
+
+		// Sorted once for the whole manifest rather than once per surface
+		std::sort(vglSurfaces.begin(), vglSurfaces.end(), SortCamera);
+		std::sort(vglSurfaces.begin(), vglSurfaces.end(), SortLayer);
+
+		FinishSurfaceLoader();
+
+		return vglLoaded;
+	}
+}
+
+#endif // _SURFACELOADER_H_